@@ -0,0 +1,88 @@
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "batch_sweep.h"
+#include "bench_util.h"
+#include "kline_series.h"
+#include "simd_dispatch.h"
+#include "sweep_runner.h"
+
+using namespace std;
+
+// BatchSweep (AVX2 lanes and scalar lanes) against one SweepRunner replay per grid point,
+// single-threaded so the numbers are per core. Every result must match bit for bit.
+// usage: bench_batch_sweep [bars] [grid_points]   (default 1M bars, 64 points)
+
+namespace {
+
+bool same(const Statistics& a, const Statistics& b)
+{
+    return a.total_trades == b.total_trades && a.winning_trades == b.winning_trades && a.total_pnl == b.total_pnl &&
+           a.win_rate == b.win_rate && a.max_drawdown == b.max_drawdown && a.largest_win == b.largest_win &&
+           a.largest_loss == b.largest_loss;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    size_t bars = argc > 1 ? stoull(argv[1]) : 1000000;
+    size_t points = argc > 2 ? stoull(argv[2]) : 64;
+
+    vector<Kline> klines;
+    klines.reserve(bars);
+    SyntheticKlines gen(11, 1704067200000ULL, 1000);
+    for (size_t i = 0; i < bars; ++i) klines.push_back(gen.next());
+    KlineSeries series(klines);
+
+    // a ragged last batch on purpose when points isn't a multiple of the lane count
+    vector<SweepPoint> grid;
+    for (size_t i = 0; i < points; ++i) grid.push_back(SweepPoint{1000 * (i + 1)});
+    grid.push_back(SweepPoint{0});
+    grid.push_back(SweepPoint{UINT64_MAX});
+
+    Stopwatch sw;
+    vector<SweepResult> reference = SweepRunner(klines, 1000000, 1).run(grid);
+    double replay_secs = sw.seconds();
+
+    BatchSweep batch(series, 1000000, 1);
+    set_simd_enabled(false);
+    sw.reset();
+    vector<SweepResult> scalar = batch.run(grid);
+    double scalar_secs = sw.seconds();
+
+    set_simd_enabled(true);
+    bool simd = use_avx2();
+    sw.reset();
+    vector<SweepResult> lanes = batch.run(grid);
+    double simd_secs = sw.seconds();
+
+    bool ok = true;
+    for (size_t i = 0; i < grid.size(); ++i) {
+        if (!same(scalar[i].stats, reference[i].stats) || !same(lanes[i].stats, reference[i].stats)) {
+            cerr << "Batched result for hold " << grid[i].hold_duration_ms << " differs from the replay" << endl;
+            ok = false;
+            break;
+        }
+    }
+
+    double configs = static_cast<double>(grid.size());
+    cout << bars << " bars, " << grid.size() << " grid points, " << BatchSweep::kBatchLanes << " lanes per pass"
+         << endl;
+    cout << left << setw(16) << "mode" << setw(12) << "seconds" << setw(14) << "configs/s" << "speedup" << endl;
+    auto row = [&](const char* name, double secs) {
+        cout << left << setw(16) << name << fixed << setprecision(3) << setw(12) << secs << setprecision(1)
+             << setw(14) << configs / secs << setprecision(2) << replay_secs / secs << "x" << endl;
+    };
+    row("replay", replay_secs);
+    row("batch scalar", scalar_secs);
+    row(simd ? "batch avx2" : "batch (no avx2)", simd_secs);
+
+    if (!ok) {
+        cerr << "Batched sweep checks failed!" << endl;
+        return 1;
+    }
+    cout << "Batched sweep matches independent replays" << endl;
+    return 0;
+}
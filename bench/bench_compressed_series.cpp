@@ -0,0 +1,145 @@
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "backtest.h"
+#include "bench_util.h"
+#include "compressed_series.h"
+#include "data_loader.h"
+#include "metrics.h"
+
+using namespace std;
+
+// CompressedSeries on data/-style input: compression ratio, block decode throughput,
+// lossless round trips (decimal and raw-double blocks), and a backtest replayed from
+// the compressed form against the plain vector.
+// usage: bench_compressed_series [rows] [block_bars]   (default 1000000, 1024)
+
+namespace {
+
+bool same_bits(const vector<Kline>& a, const vector<Kline>& b)
+{
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        const Kline& x = a[i];
+        const Kline& y = b[i];
+        if (x.timestamp_ms != y.timestamp_ms || x.fetch_time_ms != y.fetch_time_ms || x.symbol_id != y.symbol_id ||
+            memcmp(&x.open, &y.open, sizeof(double)) != 0 || memcmp(&x.high, &y.high, sizeof(double)) != 0 ||
+            memcmp(&x.low, &y.low, sizeof(double)) != 0 || memcmp(&x.close, &y.close, sizeof(double)) != 0 ||
+            memcmp(&x.volume, &y.volume, sizeof(double)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+Statistics backtest(ReplayEngine& engine)
+{
+    Strategy strategy(5 * 60000);
+    Executor executor(1000000);
+    Metrics metrics(1000000);
+    run_backtest(engine, strategy, executor, [&](const Trade& t) { metrics.on_trade(t); });
+    return metrics.snapshot();
+}
+
+// compresses, checks the round trip, prints one row; false on mismatch
+bool measure(const string& name, const vector<Kline>& klines, size_t block_bars)
+{
+    Stopwatch sw;
+    CompressedSeries series(klines, block_bars);
+    double encode_secs = sw.seconds();
+
+    vector<Kline> block(block_bars);
+    volatile double sink = 0.0;
+    sw.reset();
+    for (size_t b = 0; b < series.block_count(); ++b) {
+        size_t bars = series.decode_block(b, block.data());
+        sink = sink + block[bars - 1].close;
+    }
+    double decode_secs = sw.seconds();
+
+    double raw = static_cast<double>(klines.size() * sizeof(Kline));
+    double packed = static_cast<double>(series.memory_bytes());
+    cout << left << setw(22) << name << setw(12) << klines.size() << fixed << setprecision(2) << setw(10)
+         << packed / static_cast<double>(klines.size()) << setw(9) << raw / packed << setprecision(1) << setw(14)
+         << static_cast<double>(klines.size()) / encode_secs / 1e6 << static_cast<double>(klines.size()) / decode_secs / 1e6
+         << endl;
+
+    if (!same_bits(series.to_klines(), klines)) {
+        cerr << name << ": decoded bars differ from the input" << endl;
+        return false;
+    }
+    return true;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    size_t rows = argc > 1 ? stoull(argv[1]) : 1000000;
+    size_t block_bars = argc > 2 ? stoull(argv[2]) : CompressedSeries::kDefaultBlockBars;
+    bool ok = true;
+
+    // data/-style input: the synthetic CSV parsed like a real file
+    const string path = "bench_compressed_series.csv";
+    write_synthetic_csv(path, rows);
+    vector<Kline> klines = DataLoader::load_klines(path);
+    remove(path.c_str());
+
+    // noisy doubles that are no short decimal: every block takes the XOR path
+    vector<Kline> raw = klines;
+    for (auto& k : raw) {
+        k.open *= 1.0000001;
+        k.high *= 1.0000003;
+        k.low *= 0.9999997;
+        k.close *= 1.0000002;
+        k.volume *= 1.01;
+    }
+
+    cout << left << setw(22) << "input" << setw(12) << "bars" << setw(10) << "B/bar" << setw(9) << "ratio"
+         << setw(14) << "encode M/s" << "decode M/s" << endl;
+    ok &= measure("synthetic csv", klines, block_bars);
+    ok &= measure("raw doubles", raw, block_bars);
+    if (filesystem::exists("data/BTCUSDT_1m.csv")) {
+        ok &= measure("data/BTCUSDT_1m.csv", DataLoader::load_klines("data/BTCUSDT_1m.csv"), block_bars);
+    }
+
+    // a streamed build (push_back) encodes the same blocks and keeps the tail
+    CompressedSeries streamed(block_bars);
+    for (const auto& k : klines) streamed.push_back(k);
+    if (!same_bits(streamed.to_klines(), klines)) {
+        cerr << "Streamed series decodes differently" << endl;
+        ok = false;
+    }
+
+    // replay speed: plain vector vs block-by-block decode
+    CompressedSeries series(klines, block_bars);
+    ReplayEngine plain_engine(klines);
+    ReplayEngine compressed_engine(series);
+    Statistics plain = backtest(plain_engine);   // warm-up, both
+    Statistics compressed = backtest(compressed_engine);
+    Stopwatch sw;
+    plain = backtest(plain_engine);
+    double plain_secs = sw.seconds();
+    sw.reset();
+    compressed = backtest(compressed_engine);
+    double compressed_secs = sw.seconds();
+
+    cout << "\nbacktest replay: vector " << setprecision(3) << plain_secs << " s, compressed " << compressed_secs
+         << " s (" << setprecision(1) << compressed_secs / plain_secs * 100.0 << "% of the vector time)" << endl;
+    if (plain.total_trades != compressed.total_trades || plain.total_pnl != compressed.total_pnl ||
+        plain.max_drawdown != compressed.max_drawdown) {
+        cerr << "Backtest over the compressed series differs" << endl;
+        ok = false;
+    }
+
+    if (!ok) {
+        cerr << "Compressed series checks failed!" << endl;
+        return 1;
+    }
+    cout << "Compressed series round trips losslessly" << endl;
+    return 0;
+}
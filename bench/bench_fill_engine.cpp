@@ -0,0 +1,262 @@
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "bench_util.h"
+#include "executor.h"
+#include "fill_model.h"
+#include "metrics.h"
+#include "order_book.h"
+#include "replay_engine.h"
+#include "strategy.h"
+
+using namespace std;
+
+// Fill simulation: bar fill models inside Executor (frictionless must reproduce the old
+// fill-at-close results exactly; costs and participation caps must only ever cost money),
+// then the flat-ladder L2 book against a std::map reference book and the queue simulator.
+// usage: bench_fill_engine [bars] [book_updates]   (default 1000000 bars, 5000000 updates)
+
+namespace {
+
+struct RunResult
+{
+    Statistics stats;
+    double ns_per_bar;
+};
+
+RunResult backtest(const vector<Kline>& klines, const FillModel* model,
+                   const function<Decision(Strategy&, const Kline&)>& decide)
+{
+    Strategy strategy(5 * 60000);
+    Executor executor(1000000, model);
+    Metrics metrics(1000000);
+    ReplayEngine engine(klines);
+    Stopwatch sw;
+    engine.replay([&](const Kline& kline) {
+        auto result = executor.on_kline(kline, decide(strategy, kline));
+        if (result.has_value()) metrics.on_trade(result.value());
+    });
+    double secs = sw.seconds();
+    return RunResult{metrics.snapshot(), secs * 1e9 / static_cast<double>(klines.size())};
+}
+
+void print_run(const string& name, const RunResult& r)
+{
+    cout << left << setw(34) << name << setw(8) << r.ns_per_bar << " ns/bar  " << setw(8) << r.stats.total_trades
+         << " trades  pnl " << r.stats.total_pnl << endl;
+}
+
+// ---- reference book: ordered maps keyed by tick
+
+struct MapBook
+{
+    map<int64_t, double, greater<int64_t>> bids;
+    map<int64_t, double> asks;
+
+    void apply(const BookUpdate& u, int64_t ticks)
+    {
+        if (u.side == Side::Bid) {
+            if (u.quantity > 0.0) bids[ticks] = u.quantity; else bids.erase(ticks);
+        } else {
+            if (u.quantity > 0.0) asks[ticks] = u.quantity; else asks.erase(ticks);
+        }
+    }
+
+    template <typename Levels>
+    static BookSweep walk(const Levels& levels, double quantity, double tick)
+    {
+        BookSweep r{0.0, NAN, 0};
+        double notional = 0.0, remaining = quantity;
+        for (const auto& [ticks, size] : levels) {
+            if (remaining <= 0.0) break;
+            double take = min(remaining, size);
+            notional += take * (static_cast<double>(ticks) * tick);
+            remaining -= take;
+            r.filled += take;
+            ++r.levels;
+        }
+        if (r.filled > 0.0) r.average_price = notional / r.filled;
+        return r;
+    }
+};
+
+bool same_sweep(const BookSweep& a, const BookSweep& b)
+{
+    return a.filled == b.filled && a.levels == b.levels &&
+           (a.average_price == b.average_price || (isnan(a.average_price) && isnan(b.average_price)));
+}
+
+// depth diffs around a random-walking mid: sizes change, levels appear and vanish
+vector<BookUpdate> synthetic_depth(size_t count, double tick)
+{
+    vector<BookUpdate> updates;
+    updates.reserve(count);
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    auto next = [&] {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    };
+    int64_t mid = 4250000;   // 42500.00 at a 0.01 tick
+    uint64_t t = 1704067200000ULL;
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t r = next();
+        if (r % 16 == 0) mid += static_cast<int64_t>(next() % 5) - 2;
+        Side side = (r >> 8) & 1 ? Side::Bid : Side::Ask;
+        int64_t offset = 1 + static_cast<int64_t>((r >> 16) % 64);
+        int64_t ticks = side == Side::Bid ? mid - offset : mid + offset;
+        double quantity = (r >> 32) % 10 < 3 ? 0.0 : static_cast<double>((r >> 40) % 10000 + 1) / 1000.0;
+        updates.push_back(BookUpdate{t + i, static_cast<double>(ticks) * tick, quantity, side});
+    }
+    return updates;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    size_t bars = argc > 1 ? stoull(argv[1]) : 1000000;
+    size_t book_updates = argc > 2 ? stoull(argv[2]) : 5000000;
+    bool ok = true;
+    cout << fixed << setprecision(2);
+
+    // ---- bar fill models
+    SyntheticKlines gen;
+    vector<Kline> klines;
+    klines.reserve(bars);
+    for (size_t i = 0; i < bars; ++i) klines.push_back(gen.next());
+
+    auto market = [](Strategy& s, const Kline& k) { return s.on_kline(k); };
+    // same strategy, but entries rest as limit orders 0.05% under the close
+    auto limit_entry = [](Strategy& s, const Kline& k) {
+        Decision d = s.on_kline(k);
+        if (d.should_trade && d.is_buy) {
+            d.order_type = OrderType::Limit;
+            d.price = k.close * 0.9995;
+        }
+        return d;
+    };
+
+    BarFillModel frictionless;
+    BarFillModel costly(FillCosts{5.0, 10.0, 0.0});
+    BarFillModel thin(FillCosts{0.0, 0.0, 0.0002});
+
+    cout << bars << " bars, hold 5 min" << endl;
+    RunResult legacy = backtest(klines, nullptr, market);
+    RunResult ideal = backtest(klines, &frictionless, market);
+    RunResult with_costs = backtest(klines, &costly, market);
+    RunResult partial = backtest(klines, &thin, market);
+    RunResult limits = backtest(klines, &costly, limit_entry);
+    print_run("default executor:", legacy);
+    print_run("BarFillModel, no costs:", ideal);
+    print_run("5 bps slippage + 10 bps fees:", with_costs);
+    print_run("0.02% volume participation:", partial);
+    print_run("limit entries, with costs:", limits);
+
+    bool same_as_before = legacy.stats.total_trades == ideal.stats.total_trades &&
+                          legacy.stats.total_pnl == ideal.stats.total_pnl &&
+                          legacy.stats.max_drawdown == ideal.stats.max_drawdown;
+    if (!same_as_before) cerr << "Frictionless fills differ from the default executor!" << endl;
+    if (!(with_costs.stats.total_pnl < ideal.stats.total_pnl)) cerr << "Costs did not reduce pnl!" << endl;
+    ok &= same_as_before && with_costs.stats.total_pnl < ideal.stats.total_pnl;
+
+    // participation cap on fractional volume: below one unit is an explicit no-fill
+    WorkingOrder one_unit{true, OrderType::Market, 0.0, 1};
+    Fill starved = thin.fill(one_unit, BarRange{100.0, 101.0, 99.0, 100.0, 2.5}, true);
+    Fill fed = thin.fill(one_unit, BarRange{100.0, 101.0, 99.0, 100.0, 25000.0}, true);
+    bool cap_ok = starved.quantity == 0 && starved.participation_capped && fed.quantity == 1 && !fed.participation_capped;
+    if (!cap_ok) cerr << "Participation cap mis-sized a fill!" << endl;
+    ok &= cap_ok;
+
+    // ---- L2 book
+    const double tick = 0.01;
+    vector<BookUpdate> updates = synthetic_depth(book_updates, tick);
+
+    OrderBook book(tick);
+    Stopwatch sw;
+    for (const auto& u : updates) book.apply(u);
+    double ladder_secs = sw.seconds();
+
+    MapBook reference;
+    sw.reset();
+    for (const auto& u : updates) reference.apply(u, llround(u.price / tick));
+    double map_secs = sw.seconds();
+
+    cout << "\n" << book_updates << " depth updates" << endl;
+    cout << left << setw(34) << "flat ladder:" << static_cast<double>(book_updates) / ladder_secs / 1e6
+         << " M updates/s" << endl;
+    cout << left << setw(34) << "std::map reference:" << static_cast<double>(book_updates) / map_secs / 1e6
+         << " M updates/s" << endl;
+
+    // lockstep check: best prices after every update, sweeps every 1024
+    OrderBook checked(tick);
+    MapBook expected;
+    size_t mismatches = 0;
+    for (size_t i = 0; i < updates.size(); ++i) {
+        checked.apply(updates[i]);
+        expected.apply(updates[i], llround(updates[i].price / tick));
+        bool bid_ok = expected.bids.empty() ? !checked.has_bid()
+                                            : checked.to_ticks(checked.best_bid()) == expected.bids.begin()->first;
+        bool ask_ok = expected.asks.empty() ? !checked.has_ask()
+                                            : checked.to_ticks(checked.best_ask()) == expected.asks.begin()->first;
+        if (!bid_ok || !ask_ok) ++mismatches;
+        if (i % 1024 == 0) {
+            double qty = static_cast<double>(i % 50 + 1);
+            if (!same_sweep(checked.sweep(true, qty), MapBook::walk(expected.asks, qty, tick)) ||
+                !same_sweep(checked.sweep(false, qty), MapBook::walk(expected.bids, qty, tick))) {
+                ++mismatches;
+            }
+        }
+    }
+    cout << left << setw(34) << "mismatches vs reference:" << mismatches << " (dropped " << checked.dropped_updates()
+         << " deep levels)" << endl;
+    ok &= mismatches == 0 && checked.dropped_updates() == 0;
+
+    // ---- queue simulator: join the best bid every 10k updates, sellers print at the touch
+    OrderBook sim_book(tick);
+    BookFillSimulator sim(sim_book);
+    unordered_map<uint64_t, double> placed, filled;
+    uint64_t trades = 0;
+    sw.reset();
+    for (size_t i = 0; i < updates.size(); ++i) {
+        sim.on_update(updates[i]);
+        if (i % 10000 == 5000 && sim_book.has_bid()) {
+            placed[sim.place_limit(Side::Bid, sim_book.best_bid(), 1.0, updates[i].timestamp_ms)] = 1.0;
+        }
+        if (i % 7 == 0 && sim_book.has_bid()) {
+            double price = sim_book.best_bid();
+            sim.on_trade(updates[i].timestamp_ms, price, sim_book.quantity_at(Side::Bid, price) * 0.3, true);
+            ++trades;
+        }
+    }
+    double sim_secs = sw.seconds();
+    size_t complete = 0;
+    for (const auto& f : sim.fills()) {
+        filled[f.order_id] += f.quantity;
+        complete += f.complete;
+    }
+    for (const auto& [id, qty] : filled) {
+        if (qty > placed[id] + 1e-12) {
+            cerr << "Order " << id << " overfilled: " << qty << " of " << placed[id] << endl;
+            ok = false;
+        }
+    }
+    cout << left << setw(34) << "queue simulator:"
+         << static_cast<double>(updates.size() + trades) / sim_secs / 1e6 << " M events/s, " << placed.size()
+         << " orders, " << sim.fills().size() << " fills, " << complete << " complete, " << sim.open_orders()
+         << " still queued" << endl;
+
+    if (!ok) {
+        cerr << "Fill engine checks failed!" << endl;
+        return 1;
+    }
+    cout << "Frictionless fills match the old executor and the ladder book matches the reference" << endl;
+    return 0;
+}
@@ -0,0 +1,124 @@
+#include <cmath>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "bench_util.h"
+#include "data_loader.h"
+#include "executor.h"
+#include "fixed_point.h"
+#include "metrics.h"
+#include "parser.h"
+#include "strategy.h"
+
+using namespace std;
+
+// Fixed-point path against the double path on the same CSV: every parsed price must
+// convert back to the double parse, and both backtests must take the same trades.
+// usage: bench_fixed_point [rows]   (default 1000000)
+
+int main(int argc, char* argv[])
+{
+    size_t rows = argc > 1 ? stoull(argv[1]) : 1000000;
+    const string path = (filesystem::temp_directory_path() / "hypertradex_bench_fixed_point.csv").string();
+    const uint64_t hold_ms = 5 * 60000;
+    bool ok = true;
+
+    write_synthetic_csv(path, rows);
+    // the synthetic CSV prints cents for price and volume
+    Parser::set_fixed_scale("BTCUSDT", FixedScale{2, 2});
+
+    Stopwatch sw;
+    vector<Kline> klines = DataLoader::load_klines(path);
+    double double_parse = sw.seconds();
+    sw.reset();
+    vector<FixedKline> fixed_klines = DataLoader::load_fixed_klines(path);
+    double fixed_parse = sw.seconds();
+    filesystem::remove(path);
+
+    if (klines.size() != fixed_klines.size()) {
+        cerr << "Row count differs: " << klines.size() << " vs " << fixed_klines.size() << endl;
+        return 1;
+    }
+    for (size_t i = 0; i < klines.size(); ++i) {
+        const Kline& k = klines[i];
+        const FixedKline& f = fixed_klines[i];
+        if (f.timestamp_ms != k.timestamp_ms || from_fixed(f.open, 2) != k.open || from_fixed(f.high, 2) != k.high ||
+            from_fixed(f.low, 2) != k.low || from_fixed(f.close, 2) != k.close || from_fixed(f.volume, 2) != k.volume) {
+            cerr << "Row " << i << " parses differently on the fixed-point path" << endl;
+            ok = false;
+            break;
+        }
+    }
+
+    // ---- double backtest
+    sw.reset();
+    vector<Trade> trades;
+    {
+        Strategy strategy(hold_ms);
+        Executor executor(1000000);
+        for (const auto& kline : klines) {
+            auto trade = executor.on_kline(kline, strategy.on_kline(kline));
+            if (trade.has_value()) trades.push_back(trade.value());
+        }
+    }
+    double double_run = sw.seconds();
+    Metrics metrics(1000000);
+    Statistics double_stats = metrics.calculate(trades);
+
+    // ---- fixed-point backtest
+    sw.reset();
+    vector<FixedTrade> fixed_trades;
+    {
+        Strategy strategy(hold_ms);
+        FixedExecutor executor;
+        for (const auto& kline : fixed_klines) {
+            auto trade = executor.on_kline(kline, strategy.on_kline(kline));
+            if (trade.has_value()) fixed_trades.push_back(trade.value());
+        }
+    }
+    double fixed_run = sw.seconds();
+    FixedMetrics fixed_metrics(1000000, FixedScale{2, 2});
+    for (const auto& trade : fixed_trades) fixed_metrics.on_trade(trade);
+    Statistics fixed_stats = fixed_metrics.snapshot();
+
+    if (trades.size() != fixed_trades.size() || double_stats.winning_trades != fixed_stats.winning_trades) {
+        cerr << "Trade counts differ: " << trades.size() << " vs " << fixed_trades.size() << endl;
+        ok = false;
+    } else {
+        for (size_t i = 0; i < trades.size(); ++i) {
+            if (trades[i].entry_time_ms != fixed_trades[i].entry_time_ms ||
+                trades[i].exit_time_ms != fixed_trades[i].exit_time_ms ||
+                fabs(trades[i].pnl - from_fixed(fixed_trades[i].pnl, 2)) > 1e-6) {
+                cerr << "Trade " << i << " differs between the paths" << endl;
+                ok = false;
+                break;
+            }
+        }
+    }
+
+    // the double total only drifts by rounding; the fixed total is exact
+    double drift = double_stats.total_pnl - fixed_stats.total_pnl;
+    if (fabs(drift) > 1e-6 * static_cast<double>(trades.size() + 1)) {
+        cerr << "Total pnl drifts too far: " << double_stats.total_pnl << " vs " << fixed_stats.total_pnl << endl;
+        ok = false;
+    }
+
+    cout << fixed << setprecision(3);
+    cout << rows << " rows, " << trades.size() << " trades" << endl;
+    cout << left << setw(12) << "" << setw(14) << "parse (s)" << setw(14) << "backtest (s)" << "record" << endl;
+    cout << left << setw(12) << "double" << setw(14) << double_parse << setw(14) << double_run << sizeof(Kline)
+         << " B" << endl;
+    cout << left << setw(12) << "fixed" << setw(14) << fixed_parse << setw(14) << fixed_run << sizeof(FixedKline)
+         << " B" << endl;
+    cout << setprecision(2) << "total pnl: double " << double_stats.total_pnl << ", fixed " << fixed_stats.total_pnl
+         << " (exact " << fixed_metrics.pnl().total_pnl << " ticks), drift " << scientific << drift << endl;
+
+    if (!ok) {
+        cerr << "Fixed-point checks failed!" << endl;
+        return 1;
+    }
+    cout << "Fixed-point path matches the double path" << endl;
+    return 0;
+}
@@ -0,0 +1,111 @@
+#include <cctype>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "bench_util.h"
+#include "data_loader.h"
+#include "htx_store.h"
+#include "parser.h"
+#include "replay_engine.h"
+
+using namespace std;
+
+// Round-trips a CSV through .htx and compares startup time against parsing the CSV.
+// usage: bench_htx_load [csv_file | rows]   (default: 2M synthetic rows in /tmp)
+
+namespace {
+
+bool same_kline(const Kline& a, const Kline& b) {
+    return a.timestamp_ms == b.timestamp_ms && a.symbol_id == b.symbol_id && a.open == b.open &&
+           a.high == b.high && a.low == b.low && a.close == b.close && a.volume == b.volume;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        string csv_path = "/tmp/hypertradex_bench_htx.csv";
+        string htx_path = "/tmp/hypertradex_bench_htx.htx";
+        size_t rows = 2000000;
+        if (argc > 1) {
+            string arg = argv[1];
+            if (!arg.empty() && isdigit(static_cast<unsigned char>(arg[0]))) {
+                rows = stoull(arg);
+            } else {
+                csv_path = arg;
+                rows = 0;
+            }
+        }
+        if (rows > 0) {
+            cout << "Generating " << rows << " synthetic klines -> " << csv_path << endl;
+            write_synthetic_csv(csv_path, rows);
+        }
+
+        Stopwatch sw;
+        KlineColumns columns = DataLoader::load_columns(csv_path);
+        double csv_secs = sw.seconds();
+
+        sw.reset();
+        HtxWriter::write(htx_path, columns, Parser::symbols().names());
+        double write_secs = sw.seconds();
+
+        // round trip: every field must come back bit-identical
+        {
+            HtxReader reader(htx_path);
+            if (reader.size() != columns.size() || reader.symbol_names() != Parser::symbols().names()) {
+                cerr << "Round trip failed: row count or symbol dictionary differs" << endl;
+                return 1;
+            }
+            for (size_t i = 0; i < columns.size(); ++i) {
+                if (!same_kline(reader.at(i), columns.at(i))) {
+                    cerr << "Round trip failed at row " << i << endl;
+                    return 1;
+                }
+            }
+            if (reader.sorted_by_time() && columns.size() > 0) {
+                uint64_t probe = columns.timestamp_ms[columns.size() / 2];
+                if (columns.timestamp_ms[reader.lower_bound(probe)] != probe) {
+                    cerr << "Block index lookup failed" << endl;
+                    return 1;
+                }
+            }
+        }
+
+        // startup: open + touch the close column (what a backtest needs before bar 1)
+        sw.reset();
+        HtxReader reader(htx_path);
+        double sum = 0.0;
+        for (double c : reader.close()) sum += c;
+        double open_secs = sw.seconds();
+
+        sw.reset();
+        vector<Kline> klines = reader.to_klines();
+        double gather_secs = sw.seconds();
+
+        // replay from the mapping: same bars as replaying the gathered vector, no copy
+        sw.reset();
+        size_t replayed = 0;
+        bool replay_ok = true;
+        ReplayEngine mapped(reader);
+        mapped.replay([&](const Kline& k) { replay_ok &= same_kline(k, klines[replayed++]); });
+        double replay_secs = sw.seconds();
+        if (!replay_ok || replayed != klines.size()) {
+            cerr << "Replay from the mapped columns differs from to_klines()" << endl;
+            return 1;
+        }
+
+        cout << fixed << setprecision(4);
+        cout << left << setw(28) << "CSV parse (simd columns):" << csv_secs << " s" << endl;
+        cout << left << setw(28) << "HTX write:" << write_secs << " s" << endl;
+        cout << left << setw(28) << "HTX mmap + scan close:" << open_secs << " s  (checksum " << sum << ")" << endl;
+        cout << left << setw(28) << "HTX -> vector<Kline>:" << gather_secs << " s" << endl;
+        cout << left << setw(28) << "HTX replay from mapping:" << replay_secs << " s" << endl;
+        cout << "Round trip OK, " << klines.size() << " klines, startup "
+             << setprecision(1) << csv_secs / open_secs << "x faster than CSV" << endl;
+        return 0;
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,258 @@
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "bench_util.h"
+#include "indicators.h"
+#include "kline_series.h"
+#include "simd_dispatch.h"
+
+using namespace std;
+
+// Indicator engine: batch (AVX2 and scalar kernels) vs incremental update() vs a naive
+// per-bar recomputation. Checks that batch and incremental agree bit for bit, that both
+// match long-double reference implementations, and reports throughput in M bars/s.
+// usage: bench_indicators [bars] [period]   (default 1000000 bars, period 20)
+
+namespace {
+
+using Column = vector<double>;
+
+bool bitwise_equal(const Column& a, const Column& b)
+{
+    return a.size() == b.size() && memcmp(a.data(), b.data(), a.size() * sizeof(double)) == 0;
+}
+
+// ---- references: straight from the textbook definitions, in long double
+
+Column ref_sma(span<const double> x, size_t n)
+{
+    Column out(x.size(), NAN);
+    for (size_t i = n - 1; i < x.size(); ++i) {
+        long double sum = 0;
+        for (size_t k = i + 1 - n; k <= i; ++k) sum += x[k];
+        out[i] = static_cast<double>(sum / n);
+    }
+    return out;
+}
+
+Column ref_ema(span<const double> x, size_t n)
+{
+    Column out(x.size(), NAN);
+    long double alpha = 2.0L / (n + 1), e = 0;
+    for (size_t k = 0; k < n && k < x.size(); ++k) e += x[k];
+    e /= n;
+    if (n <= x.size()) out[n - 1] = static_cast<double>(e);
+    for (size_t i = n; i < x.size(); ++i) {
+        e += alpha * (x[i] - e);
+        out[i] = static_cast<double>(e);
+    }
+    return out;
+}
+
+// Wilder smoothing of v[first..] in long double
+Column ref_wilder(const vector<long double>& v, size_t first, size_t n)
+{
+    Column out(v.size(), NAN);
+    long double avg = 0;
+    for (size_t i = first; i < v.size(); ++i) {
+        if (i + 1 < first + n) {
+            avg += v[i];
+        } else if (i + 1 == first + n) {
+            avg = (avg + v[i]) / n;
+            out[i] = static_cast<double>(avg);
+        } else {
+            avg = (avg * (n - 1) + v[i]) / n;
+            out[i] = static_cast<double>(avg);
+        }
+    }
+    return out;
+}
+
+Column ref_rsi(span<const double> x, size_t n)
+{
+    vector<long double> gain(x.size()), loss(x.size());
+    for (size_t i = 1; i < x.size(); ++i) {
+        long double d = static_cast<long double>(x[i]) - x[i - 1];
+        gain[i] = d > 0 ? d : 0;
+        loss[i] = d < 0 ? -d : 0;
+    }
+    Column g = ref_wilder(gain, 1, n), l = ref_wilder(loss, 1, n), out(x.size(), NAN);
+    for (size_t i = n; i < x.size(); ++i) {
+        long double rs = static_cast<long double>(g[i]) / l[i];
+        out[i] = l[i] == 0 ? (g[i] == 0 ? 50.0 : 100.0) : static_cast<double>(100.0L - 100.0L / (1.0L + rs));
+    }
+    return out;
+}
+
+Column ref_atr(const KlineSeries& s, size_t n)
+{
+    vector<long double> tr(s.size());
+    for (size_t i = 0; i < s.size(); ++i) {
+        long double h = s.high()[i], l = s.low()[i];
+        tr[i] = h - l;
+        if (i > 0) {
+            long double pc = s.close()[i - 1];
+            tr[i] = max(tr[i], max(fabsl(h - pc), fabsl(l - pc)));
+        }
+    }
+    return ref_wilder(tr, 0, n);
+}
+
+// two-pass population standard deviation, the numerically careful way
+Column ref_bollinger_upper(span<const double> x, size_t n, double width)
+{
+    Column out(x.size(), NAN);
+    for (size_t i = n - 1; i < x.size(); ++i) {
+        long double mean = 0, var = 0;
+        for (size_t k = i + 1 - n; k <= i; ++k) mean += x[k];
+        mean /= n;
+        for (size_t k = i + 1 - n; k <= i; ++k) var += (x[k] - mean) * (x[k] - mean);
+        out[i] = static_cast<double>(mean + width * sqrtl(var / n));
+    }
+    return out;
+}
+
+Column ref_vwap(const KlineSeries& s, size_t n)
+{
+    Column out(s.size(), NAN);
+    for (size_t i = n - 1; i < s.size(); ++i) {
+        long double pv = 0, v = 0;
+        for (size_t k = i + 1 - n; k <= i; ++k) {
+            long double tp = (static_cast<long double>(s.high()[k]) + s.low()[k] + s.close()[k]) / 3;
+            pv += tp * s.volume()[k];
+            v += s.volume()[k];
+        }
+        out[i] = static_cast<double>(pv / v);
+    }
+    return out;
+}
+
+Column ref_rolling(span<const double> x, size_t n, bool want_max)
+{
+    Column out(x.size(), NAN);
+    for (size_t i = n - 1; i < x.size(); ++i) {
+        double best = x[i + 1 - n];
+        for (size_t k = i + 2 - n; k <= i; ++k) best = want_max ? max(best, x[k]) : min(best, x[k]);
+        out[i] = best;
+    }
+    return out;
+}
+
+// worst |a - b| relative to `scale`, NaN positions must line up
+double max_error(const Column& got, const Column& ref, double scale)
+{
+    double worst = 0.0;
+    for (size_t i = 0; i < got.size(); ++i) {
+        if (isnan(got[i]) != isnan(ref[i])) return INFINITY;
+        if (!isnan(got[i])) worst = max(worst, fabs(got[i] - ref[i]) / scale);
+    }
+    return worst;
+}
+
+struct Case
+{
+    string name;
+    function<void(Column&)> batch;
+    function<void(Column&)> incremental;
+    function<Column()> reference;
+    double tolerance;   // relative to the reference's scale
+    double scale;
+};
+
+double time_it(size_t bars, const function<void()>& body)
+{
+    double best = 1e300;
+    for (int r = 0; r < 3; ++r) {
+        Stopwatch sw;
+        body();
+        best = min(best, sw.seconds());
+    }
+    return static_cast<double>(bars) / best / 1e6;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    size_t bars = argc > 1 ? stoull(argv[1]) : 1000000;
+    size_t n = argc > 2 ? stoull(argv[2]) : 20;
+
+    SyntheticKlines gen;
+    vector<Kline> klines;
+    klines.reserve(bars);
+    for (size_t i = 0; i < bars; ++i) klines.push_back(gen.next());
+    KlineSeries s(klines);
+    auto close = s.close();
+    double price = close[0];
+
+    vector<Case> cases = {
+        {"sma", [&](Column& o) { Indicators::sma(close, n, o); },
+         [&](Column& o) { Sma ind(n); for (size_t i = 0; i < bars; ++i) o[i] = ind.update(close[i]); },
+         [&] { return ref_sma(close, n); }, 1e-12, price},
+        {"ema", [&](Column& o) { Indicators::ema(close, n, o); },
+         [&](Column& o) { Ema ind(n); for (size_t i = 0; i < bars; ++i) o[i] = ind.update(close[i]); },
+         [&] { return ref_ema(close, n); }, 1e-12, price},
+        {"rsi", [&](Column& o) { Indicators::rsi(close, n, o); },
+         [&](Column& o) { Rsi ind(n); for (size_t i = 0; i < bars; ++i) o[i] = ind.update(close[i]); },
+         [&] { return ref_rsi(close, n); }, 1e-9, 100.0},
+        {"atr", [&](Column& o) { Indicators::atr(s.high(), s.low(), close, n, o); },
+         [&](Column& o) { Atr ind(n); for (size_t i = 0; i < bars; ++i) o[i] = ind.update(klines[i]); },
+         [&] { return ref_atr(s, n); }, 1e-9, 100.0},
+        {"bollinger upper", [&](Column& o) { Column m(bars), l(bars); Indicators::bollinger(close, n, 2.0, m, o, l); },
+         [&](Column& o) { Bollinger ind(n, 2.0); for (size_t i = 0; i < bars; ++i) o[i] = ind.update(close[i]).upper; },
+         [&] { return ref_bollinger_upper(close, n, 2.0); }, 1e-10, price},
+        {"vwap", [&](Column& o) { Indicators::vwap(s.high(), s.low(), close, s.volume(), n, o); },
+         [&](Column& o) { Vwap ind(n); for (size_t i = 0; i < bars; ++i) o[i] = ind.update(klines[i]); },
+         [&] { return ref_vwap(s, n); }, 1e-9, price},
+        {"rolling max", [&](Column& o) { Indicators::rolling_max(close, n, o); },
+         [&](Column& o) { RollingMax ind(n); for (size_t i = 0; i < bars; ++i) o[i] = ind.update(close[i]); },
+         [&] { return ref_rolling(close, n, true); }, 0.0, price},
+        {"rolling min", [&](Column& o) { Indicators::rolling_min(close, n, o); },
+         [&](Column& o) { RollingMin ind(n); for (size_t i = 0; i < bars; ++i) o[i] = ind.update(close[i]); },
+         [&] { return ref_rolling(close, n, false); }, 0.0, price},
+    };
+
+    cout << bars << " bars, period " << n << ", batch kernels: " << (use_avx2_fma() ? "avx2" : "scalar")
+         << endl;
+    cout << left << setw(18) << "indicator" << setw(14) << "batch avx2" << setw(14) << "batch scalar" << setw(14)
+         << "incremental" << setw(14) << "naive" << "max rel error" << endl;
+
+    bool ok = true;
+    Column simd(bars), scalar(bars), incremental(bars);
+    for (auto& c : cases) {
+        set_simd_enabled(true);
+        double simd_rate = time_it(bars, [&] { c.batch(simd); });
+        set_simd_enabled(false);
+        double scalar_rate = time_it(bars, [&] { c.batch(scalar); });
+        set_simd_enabled(true);
+        double incremental_rate = time_it(bars, [&] { c.incremental(incremental); });
+
+        Column reference;
+        Stopwatch sw;
+        reference = c.reference();
+        double naive_rate = static_cast<double>(bars) / sw.seconds() / 1e6;
+
+        double error = max_error(simd, reference, c.scale);
+        bool same = bitwise_equal(simd, scalar) && bitwise_equal(simd, incremental);
+        bool accurate = error <= c.tolerance;
+        ok &= same && accurate;
+
+        cout << fixed << setprecision(1) << left << setw(18) << c.name << setw(14) << simd_rate << setw(14)
+             << scalar_rate << setw(14) << incremental_rate << setw(14) << naive_rate << scientific
+             << setprecision(2) << error << (same ? "" : "  BATCH/INCREMENTAL DIFFER")
+             << (accurate ? "" : "  INACCURATE") << endl;
+    }
+    cout << "(M bars/s, best of 3; naive = per-bar window recomputation in long double)" << endl;
+
+    if (!ok) {
+        cerr << "Indicator results differ between modes or from the references!" << endl;
+        return 1;
+    }
+    cout << "Batch and incremental results are bitwise identical and match the references" << endl;
+    return 0;
+}
@@ -0,0 +1,150 @@
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "bench_util.h"
+#include "binance_client.h"
+#include "binance_standin.h"
+#include "kline_cache.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// KlineCache in front of the local Binance stand-in: cold fetch vs warm start,
+// gap-only refetch when the window grows, several clients filling the same key at
+// once, and compaction of many small range files.
+// usage: bench_kline_cache [bars] [latency_us]   (default 200000 bars, 20000us)
+
+namespace {
+
+const uint64_t kStart = 1704067200000ULL;  // 2024-01-01
+const uint64_t kStep = 60000;
+
+bool check_range(const vector<Kline>& klines, uint64_t start, uint64_t end) {
+    if (klines.size() != (end - start) / kStep) return false;
+    for (size_t i = 0; i < klines.size(); ++i) {
+        Kline want = BinanceStandIn::expected(start + i * kStep, kStep);
+        if (klines[i].timestamp_ms != want.timestamp_ms || klines[i].close != want.close ||
+            klines[i].volume != want.volume) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    uint64_t bars = argc > 1 ? stoull(argv[1]) : 200000;
+    chrono::microseconds latency(argc > 2 ? stoll(argv[2]) : 20000);
+    string dir = (fs::temp_directory_path() / ("hypertradex_cache_" + to_string(getpid()))).string();
+    fs::remove_all(dir);
+
+    BinanceStandIn server(latency);
+    BinanceClient client(server.base_url());
+    RangeFetchOptions options;
+    options.requests_per_second = 0;
+    KlineCache cache(dir, client, options);
+    const uint64_t end = kStart + bars * kStep;
+    bool ok = true;
+    cout << fixed << setprecision(2);
+
+    // cold: everything over the "network"
+    Stopwatch sw;
+    vector<Kline> cold = cache.get("BTCUSDT", "1m", kStart, end);
+    double cold_secs = sw.seconds();
+    ok &= check_range(cold, kStart, end) && cache.last_stats().fetched_klines == bars;
+
+    // warm: same window, no requests at all
+    size_t requests = server.requests();
+    sw.reset();
+    vector<Kline> warm = cache.get("BTCUSDT", "1m", kStart, end);
+    double warm_secs = sw.seconds();
+    ok &= check_range(warm, kStart, end) && server.requests() == requests &&
+          cache.last_stats().cached_klines == bars && cache.last_stats().fetched_ranges == 0;
+    cout << left << setw(30) << "cold get (network):" << cold_secs * 1000 << " ms" << endl;
+    cout << left << setw(30) << "warm get (mmap):" << warm_secs * 1000 << " ms" << endl;
+
+    // wider window: only the two missing ends are fetched
+    uint64_t wide_start = kStart - 5000 * kStep, wide_end = end + 7000 * kStep;
+    ok &= cache.missing("BTCUSDT", "1m", wide_start, wide_end).size() == 2;
+    vector<Kline> wide = cache.get("BTCUSDT", "1m", wide_start, wide_end);
+    ok &= check_range(wide, wide_start, wide_end) && cache.last_stats().fetched_ranges == 2 &&
+          cache.last_stats().fetched_klines == 12000 && cache.last_stats().cached_klines == bars;
+    ok &= cache.missing("BTCUSDT", "1m", wide_start, wide_end).empty();
+
+    // keys that would leave the cache directory never reach the filesystem
+    for (const auto& [symbol, interval] : {pair<string, string>{"..", "1m"}, {"BTCUSDT", "../1m"}, {"BTC.USDT", "1m"}}) {
+        try {
+            cache.missing(symbol, interval, kStart, end);
+            cerr << "Cache accepted key " << symbol << " " << interval << endl;
+            ok = false;
+        } catch (const runtime_error&) {
+        }
+    }
+
+    // weekly bars open on Mondays, off the epoch multiples: the week still in progress is
+    // returned but never cached, whatever day it is
+    {
+        const uint64_t week = BinanceStandIn::kWeekMs;
+        uint64_t now_ms = static_cast<uint64_t>(
+            chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch()).count());
+        uint64_t open_week = BinanceStandIn::first_open(now_ms - week + 1, week);
+        uint64_t s = open_week - 8 * week, e = open_week + week;
+        vector<Kline> weeks = cache.get("BTCUSDT", "1w", s, e);
+        vector<TimeRange> uncached = cache.missing("BTCUSDT", "1w", s, e);
+        bool weekly_ok = weeks.size() == 9 && weeks.back().timestamp_ms == open_week &&
+                         uncached.size() == 1 && uncached[0].start_ms == open_week;
+        if (!weekly_ok) cerr << "The open weekly bar was cached or closed weeks were lost!" << endl;
+        ok &= weekly_ok;
+    }
+
+    // four clients (own lock fds, like separate processes) want the same uncached window
+    {
+        const uint64_t s = kStart + bars * kStep * 2, e = s + 30000 * kStep;
+        vector<vector<Kline>> results(4);
+        vector<size_t> fetched(4);
+        vector<thread> threads;
+        for (size_t t = 0; t < results.size(); ++t) {
+            threads.emplace_back([&, t] {
+                BinanceClient own_client(server.base_url());
+                KlineCache own_cache(dir, own_client, options);
+                results[t] = own_cache.get("BTCUSDT", "1m", s, e);
+                fetched[t] = own_cache.last_stats().fetched_ranges;
+            });
+        }
+        for (auto& th : threads) th.join();
+        size_t total_fetches = 0;
+        for (size_t t = 0; t < results.size(); ++t) {
+            ok &= check_range(results[t], s, e);
+            total_fetches += fetched[t];
+        }
+        ok &= total_fetches == 1;
+        cout << left << setw(30) << "concurrent clients:" << results.size() << " runs, " << total_fetches
+             << " download" << endl;
+    }
+
+    // many small adjacent windows, then merge them
+    {
+        const uint64_t s = kStart + bars * kStep * 4;
+        for (int i = 0; i < 20; ++i) {
+            cache.get("ETHUSDT", "1m", s + i * 500 * kStep, s + (i + 1) * 500 * kStep);
+        }
+        size_t files = cache.compact("ETHUSDT", "1m");
+        vector<Kline> merged = cache.get("ETHUSDT", "1m", s, s + 10000 * kStep);
+        ok &= files == 1 && cache.last_stats().fetched_ranges == 0 && check_range(merged, s, s + 10000 * kStep);
+        cout << left << setw(30) << "compaction:" << "20 range files -> " << files << endl;
+    }
+
+    fs::remove_all(dir);
+    if (!ok) {
+        cerr << "Kline cache returned wrong data or refetched cached ranges!" << endl;
+        return 1;
+    }
+    cout << "Cache serves identical klines and only fetches missing ranges" << endl;
+    return 0;
+}
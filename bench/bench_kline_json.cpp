@@ -0,0 +1,150 @@
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+#include "bench_util.h"
+#include "kline_json_decoder.h"
+
+using namespace std;
+using json = nlohmann::json;
+
+// KlineJsonDecoder vs the previous nlohmann DOM + stod path on one large
+// /api/v3/klines-shaped response: throughput, heap allocations, and identical output
+// whether the bytes arrive in one piece, in curl-sized chunks or a few bytes at a time.
+// usage: bench_kline_json [rows]   (default 200000)
+
+namespace {
+
+atomic<size_t> g_allocations{0};
+
+// same shape and formatting as the real endpoint
+string make_response(size_t rows) {
+    SyntheticKlines gen;
+    string body = "[";
+    char row[400];
+    for (size_t i = 0; i < rows; ++i) {
+        Kline k = gen.next();
+        int n = snprintf(row, sizeof(row),
+                         "%s[%llu,\"%.8f\",\"%.8f\",\"%.8f\",\"%.8f\",\"%.8f\",%llu,\"%.8f\",%d,\"%.8f\",\"%.8f\",\"0\"]",
+                         i ? "," : "", static_cast<unsigned long long>(k.timestamp_ms), k.open, k.high, k.low,
+                         k.close, k.volume / k.close, static_cast<unsigned long long>(k.timestamp_ms + 59999),
+                         k.volume, static_cast<int>(i % 5000), k.volume / k.close / 2, k.volume / 2);
+        body.append(row, static_cast<size_t>(n));
+    }
+    body += "]";
+    return body;
+}
+
+// what BinanceClient::parse_klines_json used to do
+vector<Kline> parse_dom(const string& response) {
+    vector<Kline> klines;
+    json parsed = json::parse(response);
+    for (const auto& kline_array : parsed) {
+        uint64_t timestamp_ms = kline_array[0].get<uint64_t>();
+        double open = stod(kline_array[1].get<string>());
+        double high = stod(kline_array[2].get<string>());
+        double low = stod(kline_array[3].get<string>());
+        double close = stod(kline_array[4].get<string>());
+        double volume = stod(kline_array[7].get<string>());
+        klines.push_back(Kline{timestamp_ms, 0, 0, open, high, low, close, volume});
+    }
+    return klines;
+}
+
+vector<Kline> parse_chunked(const string& response, size_t chunk) {
+    KlineJsonDecoder decoder;
+    for (size_t off = 0; off < response.size(); off += chunk) {
+        decoder.feed(response.data() + off, min(chunk, response.size() - off));
+    }
+    decoder.finish();
+    return move(decoder.klines());
+}
+
+// 1..61 byte pieces so every field gets split at every possible offset somewhere
+vector<Kline> parse_ragged(const string& response) {
+    KlineJsonDecoder decoder;
+    size_t off = 0, step = 1;
+    while (off < response.size()) {
+        size_t n = min(step, response.size() - off);
+        decoder.feed(response.data() + off, n);
+        off += n;
+        step = step % 61 + 1;
+    }
+    decoder.finish();
+    return move(decoder.klines());
+}
+
+bool same(const vector<Kline>& a, const vector<Kline>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].timestamp_ms != b[i].timestamp_ms || a[i].open != b[i].open || a[i].high != b[i].high ||
+            a[i].low != b[i].low || a[i].close != b[i].close || a[i].volume != b[i].volume) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool throws(const string& response) {
+    try {
+        KlineJsonDecoder::decode(response);
+    } catch (const exception&) {
+        return true;
+    }
+    return false;
+}
+
+template <class Fn>
+vector<Kline> timed(const char* name, size_t bytes, Fn&& fn) {
+    size_t allocs_before = g_allocations.load();
+    Stopwatch sw;
+    vector<Kline> klines = fn();
+    double secs = sw.seconds();
+    size_t allocs = g_allocations.load() - allocs_before;
+    cout << left << setw(30) << name << setw(10) << secs * 1000 << " ms  " << setw(9)
+         << static_cast<double>(bytes) / secs / 1e6 << " MB/s  " << allocs << " allocations" << endl;
+    return klines;
+}
+
+}
+
+// count heap allocations made by each parser
+void* operator new(size_t size) {
+    ++g_allocations;
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw bad_alloc();
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+int main(int argc, char* argv[]) {
+    size_t rows = argc > 1 ? stoull(argv[1]) : 200000;
+    string response = make_response(rows);
+    cout << fixed << setprecision(1);
+    cout << rows << " klines, " << static_cast<double>(response.size()) / 1e6 << " MB response" << endl;
+
+    vector<Kline> dom = timed("nlohmann DOM + stod:", response.size(), [&] { return parse_dom(response); });
+    vector<Kline> whole = timed("decoder, whole buffer:", response.size(),
+                                [&] { return KlineJsonDecoder::decode(response); });
+    vector<Kline> chunked = timed("decoder, 16 KiB chunks:", response.size(),
+                                  [&] { return parse_chunked(response, 16384); });
+    vector<Kline> ragged = parse_ragged(response);
+
+    bool ok = dom.size() == rows && same(dom, whole) && same(dom, chunked) && same(dom, ragged);
+    ok &= KlineJsonDecoder::decode("[]").empty();
+    ok &= KlineJsonDecoder::decode(" [ [1,\"2\",\"3\",\"1\",\"2.5\",\"0\",2,\"7\"] ]\n").size() == 1;
+    ok &= throws(response.substr(0, response.size() / 2));
+    ok &= throws("{\"code\":-1121,\"msg\":\"Invalid symbol.\"}");
+    ok &= throws("[[1,\"2\",\"3\"]]");
+    ok &= throws("[[1,\"2x\",\"3\",\"1\",\"2\",\"0\",2,\"7\"]]");
+    if (!ok) {
+        cerr << "Streaming decoder disagrees with the DOM parser!" << endl;
+        return 1;
+    }
+    cout << "Decoder output matches the DOM parser for every chunking" << endl;
+    return 0;
+}
@@ -0,0 +1,102 @@
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "bench_util.h"
+#include "executor.h"
+#include "kline_series.h"
+#include "replay_engine.h"
+#include "strategy.h"
+
+using namespace std;
+
+// AoS vector<Kline> vs SoA KlineSeries: a close-only indicator pass and a full replay.
+// usage: bench_kline_series [bars]   (default 20M; 100M needs ~11 GB for both layouts)
+
+namespace {
+
+struct Result {
+    double secs;
+    long long misses;
+};
+
+void report(const string& name, size_t bars, const Result& r) {
+    cout << left << setw(24) << name << fixed << setprecision(3) << setw(9) << r.secs << " s  "
+         << setprecision(2) << setw(9) << (static_cast<double>(bars) / r.secs / 1e6) << " M bars/s  ";
+    if (r.misses >= 0) {
+        cout << setprecision(3) << (static_cast<double>(r.misses) / static_cast<double>(bars)) << " misses/bar";
+    } else {
+        cout << "(no PMU counters)";
+    }
+    cout << endl;
+}
+
+template <typename Fn>
+Result measure(CacheMissCounter& counter, Fn&& fn) {
+    counter.start();
+    Stopwatch sw;
+    fn();
+    Result r{sw.seconds(), 0};
+    r.misses = counter.stop();
+    return r;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    size_t bars = argc > 1 ? stoull(argv[1]) : 20000000;
+
+    cout << "Generating " << bars << " bars..." << endl;
+    vector<Kline> klines;
+    klines.reserve(bars);
+    SyntheticKlines gen;
+    for (size_t i = 0; i < bars; ++i) klines.push_back(gen.next());
+    KlineSeries series(klines);
+
+    CacheMissCounter counter;
+
+    // close-only pass, the access pattern of most indicators
+    double aos_sum = 0.0, soa_sum = 0.0;
+    Result aos_scan = measure(counter, [&] {
+        for (const auto& k : klines) aos_sum += k.close;
+    });
+    Result soa_scan = measure(counter, [&] {
+        for (double c : series.close()) soa_sum += c;
+    });
+
+    // full strategy -> executor replay
+    size_t aos_trades = 0, soa_trades = 0;
+    double aos_pnl = 0.0, soa_pnl = 0.0;
+    Result aos_replay = measure(counter, [&] {
+        Strategy strategy(5000);
+        Executor executor(1000000);
+        ReplayEngine engine(klines);
+        engine.replay([&](const Kline& kline) {
+            auto trade = executor.on_kline(kline, strategy.on_kline(kline));
+            if (trade) { ++aos_trades; aos_pnl += trade->pnl; }
+        });
+    });
+    Result soa_replay = measure(counter, [&] {
+        Strategy strategy(5000);
+        Executor executor(1000000);
+        ReplayEngine engine(series);
+        engine.replay_bars([&](const KlineView& bar) {
+            auto trade = executor.on_kline(bar, strategy.on_kline(bar));
+            if (trade) { ++soa_trades; soa_pnl += trade->pnl; }
+        });
+    });
+
+    cout << "sizeof(Kline) = " << sizeof(Kline) << " bytes, close column = " << sizeof(double) << " bytes/bar" << endl;
+    report("AoS close scan", bars, aos_scan);
+    report("SoA close scan", bars, soa_scan);
+    report("AoS replay", bars, aos_replay);
+    report("SoA replay", bars, soa_replay);
+    cout << "Scan speedup: " << setprecision(2) << aos_scan.secs / soa_scan.secs << "x, replay speedup: "
+         << aos_replay.secs / soa_replay.secs << "x" << endl;
+
+    if (aos_sum != soa_sum || aos_trades != soa_trades || aos_pnl != soa_pnl) {
+        cerr << "AoS and SoA results differ!" << endl;
+        return 1;
+    }
+    return 0;
+}
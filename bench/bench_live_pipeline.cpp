@@ -0,0 +1,99 @@
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench_util.h"
+#include "executor.h"
+#include "live_pipeline.h"
+#include "metrics.h"
+#include "strategy.h"
+
+using namespace std;
+
+// LivePipeline over a recorded stream, for blocking and busy-poll rings:
+//   flood  - bars released as fast as possible: throughput (latency is mostly queueing)
+//   paced  - one bar every 50us: the tick-to-decision histogram of an idle pipeline
+// The trades must match the synchronous backtest loop over the same bars.
+// usage: bench_live_pipeline [bars]   (default 1M)
+
+namespace {
+
+Statistics synchronous(const vector<Kline>& klines, uint64_t hold_ms, uint64_t capital) {
+    Strategy strategy(hold_ms);
+    Executor executor(capital);
+    Metrics metrics(capital);
+    for (const auto& kline : klines) {
+        auto result = executor.on_kline(kline, strategy.on_kline(kline));
+        if (result.has_value()) metrics.on_trade(result.value());
+    }
+    return metrics.snapshot();
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    size_t n = argc > 1 ? stoull(argv[1]) : 1000000;
+    SyntheticKlines gen;
+    vector<Kline> klines;
+    klines.reserve(n);
+    for (size_t i = 0; i < n; ++i) klines.push_back(gen.next());
+
+    const uint64_t hold_ms = 5 * 60000, capital = 1000000;
+    Statistics expected = synchronous(klines, hold_ms, capital);
+
+    unsigned cpus = thread::hardware_concurrency();
+    cout << fixed << setprecision(2);
+    cout << n << " bars, " << cpus << " hardware threads" << (cpus < 3 ? " (threads share cores, busy-poll yields)" : "")
+         << endl;
+    cout << left << setw(20) << "mode" << setw(14) << "M bars/s" << setw(10) << "p50 us" << setw(10) << "p99 us"
+         << setw(10) << "p99.9 us" << "max us" << endl;
+
+    bool ok = true;
+    const size_t paced_bars = min<size_t>(n, 40000);
+    for (int run = 0; run < 4; ++run) {
+        WaitMode mode = run % 2 ? WaitMode::BusyPoll : WaitMode::Blocking;
+        bool paced = run >= 2;
+        LiveConfig config;
+        config.hold_duration_ms = hold_ms;
+        config.initial_capital = capital;
+        config.wait_mode = mode;
+        if (cpus >= 3) {
+            config.feed_cpu = 0;
+            config.strategy_cpu = 1;
+            config.metrics_cpu = 2;
+        }
+        // 1m bars replayed 1.2M times faster than real time = 50us apart
+        span<const Kline> input = paced ? span<const Kline>(klines).first(paced_bars) : span<const Kline>(klines);
+        RecordedFeed feed(input, paced ? 1.2e6 : 0.0);
+        LivePipeline pipeline(config);
+        Stopwatch sw;
+        LiveReport report = pipeline.run(feed);
+        double secs = sw.seconds();
+
+        string name = string(paced ? "paced " : "flood ") + (mode == WaitMode::Blocking ? "blocking" : "busy-poll");
+        cout << left << setw(20) << name
+             << setw(14) << static_cast<double>(report.bars) / secs / 1e6
+             << setw(10) << report.tick_to_decision_us.quantile(0.50)
+             << setw(10) << report.tick_to_decision_us.quantile(0.99)
+             << setw(10) << report.tick_to_decision_us.quantile(0.999)
+             << report.max_tick_to_decision_us << endl;
+
+        if (paced) {
+            ok &= report.bars == paced_bars && report.pin_failures == 0;
+            continue;
+        }
+        ok &= report.bars == n && report.pin_failures == 0 &&
+              report.stats.total_trades == expected.total_trades &&
+              report.stats.winning_trades == expected.winning_trades &&
+              report.stats.total_pnl == expected.total_pnl &&
+              report.stats.max_drawdown == expected.max_drawdown;
+    }
+
+    if (!ok) {
+        cerr << "Live pipeline trades differ from the synchronous backtest!" << endl;
+        return 1;
+    }
+    cout << "Live pipeline matches the synchronous backtest (" << expected.total_trades << " trades)" << endl;
+    return 0;
+}
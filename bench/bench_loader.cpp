@@ -0,0 +1,156 @@
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "bench_util.h"
+#include "csv_scanner.h"
+#include "mapped_file.h"
+#include "data_loader.h"
+#include "parser.h"
+
+using namespace std;
+
+// Compares the original getline + stringstream path against the mmap + from_chars loader.
+// Every loader must also reject a stray non-numeric row in the middle of a file.
+// usage: bench_loader [csv_file | rows]   (default: 2M synthetic rows in /tmp)
+
+namespace {
+
+double checksum(const vector<Kline>& klines) {
+    double sum = 0.0;
+    for (const auto& k : klines) sum += k.close + k.volume;
+    return sum;
+}
+
+double checksum(const KlineColumns& columns) {
+    double sum = 0.0;
+    for (size_t i = 0; i < columns.size(); ++i) sum += columns.close[i] + columns.volume[i];
+    return sum;
+}
+
+// a synthetic CSV with one non-numeric row 60% in (past the first parallel chunk);
+// returns the loaders that accepted it
+vector<string> loaders_accepting_stray_row() {
+    const string path = "/tmp/hypertradex_bench_loader_bad.csv";
+    write_synthetic_csv(path, 50000);
+    string text = (stringstream() << ifstream(path).rdbuf()).str();
+    size_t at = text.find('\n', text.size() * 3 / 5) + 1;
+    text.insert(at, "timestamp_ms,symbol,open,high,low,close,volume\n");
+    ofstream(path) << text;
+
+    vector<pair<string, function<void()>>> loaders = {
+        {"load_klines", [&] { DataLoader::load_klines(path); }},
+        {"load_klines_parallel", [&] { DataLoader::load_klines_parallel(path, 4); }},
+        {"load_columns", [&] { DataLoader::load_columns(path); }},
+        {"load_fixed_klines", [&] { DataLoader::load_fixed_klines(path); }},
+    };
+    vector<string> accepted;
+    for (const auto& [name, load] : loaders) {
+        try {
+            load();
+            accepted.push_back(name);
+        } catch (const runtime_error&) {
+        }
+    }
+    remove(path.c_str());
+    return accepted;
+}
+
+void report(const string& name, size_t bytes, size_t klines, double secs) {
+    cout << left << setw(22) << name
+         << fixed << setprecision(3) << setw(10) << secs << " s  "
+         << setw(8) << (static_cast<double>(bytes) / secs / 1e9) << " GB/s  "
+         << setprecision(2) << (static_cast<double>(klines) / secs / 1e6) << " M klines/s" << endl;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        string path = "/tmp/hypertradex_bench_loader.csv";
+        size_t rows = 2000000;
+        if (argc > 1) {
+            string arg = argv[1];
+            if (!arg.empty() && isdigit(static_cast<unsigned char>(arg[0]))) {
+                rows = stoull(arg);
+            } else {
+                path = arg;
+                rows = 0;
+            }
+        }
+
+        size_t bytes = 0;
+        if (rows > 0) {
+            cout << "Generating " << rows << " synthetic klines -> " << path << endl;
+            bytes = write_synthetic_csv(path, rows);
+        } else {
+            bytes = MappedFile(path).size();
+        }
+
+        // warm the page cache so both paths read from memory
+        DataLoader::load_klines(path);
+
+        Stopwatch sw;
+        auto lines = DataLoader::load_file(path);
+        vector<Kline> legacy;
+        for (size_t i = 1; i < lines.size(); ++i) {
+            legacy.push_back(Parser::parse_kline(lines[i]));
+        }
+        double legacy_secs = sw.seconds();
+
+        sw.reset();
+        vector<Kline> mapped;
+        DataLoader::load_klines(path, mapped);
+        double mapped_secs = sw.seconds();
+
+        sw.reset();
+        KlineColumns columns = DataLoader::load_columns(path);
+        double columns_secs = sw.seconds();
+
+        // separator scan alone, per kernel, to show how close it gets to memory bandwidth
+        MappedFile file(path);
+        vector<uint32_t> separators;
+        separators.reserve(64 * 1024 / 4);
+        for (auto kernel : {CsvScanner::Kernel::Scalar, CsvScanner::Kernel::SSE42, CsvScanner::Kernel::AVX2}) {
+            if (kernel > CsvScanner::active_kernel()) continue;
+            sw.reset();
+            size_t found = 0;
+            for (size_t off = 0; off < file.size(); off += 64 * 1024) {
+                separators.clear();
+                CsvScanner::find_separators(file.data() + off, min<size_t>(64 * 1024, file.size() - off), separators, kernel);
+                found += separators.size();
+            }
+            double secs = sw.seconds();
+            cout << left << setw(22) << (string("scan/") + CsvScanner::kernel_name(kernel))
+                 << fixed << setprecision(3) << setw(10) << secs << " s  "
+                 << setw(8) << (static_cast<double>(file.size()) / secs / 1e9) << " GB/s  ("
+                 << found << " separators)" << endl;
+        }
+
+        report("getline+stringstream", bytes, legacy.size(), legacy_secs);
+        report("mmap+from_chars", bytes, mapped.size(), mapped_secs);
+        report("mmap+simd columns", bytes, columns.size(), columns_secs);
+        cout << "Speedup (from_chars): " << setprecision(2) << legacy_secs / mapped_secs << "x" << endl;
+        cout << "Speedup (simd):       " << setprecision(2) << legacy_secs / columns_secs << "x" << endl;
+
+        if (legacy.size() != mapped.size() || checksum(legacy) != checksum(mapped) ||
+            columns.size() != mapped.size() || checksum(columns) != checksum(mapped)) {
+            cerr << "Mismatch between loaders!" << endl;
+            return 1;
+        }
+        vector<string> accepted = loaders_accepting_stray_row();
+        for (const auto& name : accepted) {
+            cerr << name << " accepted a stray header row mid-file" << endl;
+        }
+        if (!accepted.empty()) return 1;
+        return 0;
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,82 @@
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "bench_util.h"
+#include "metrics.h"
+
+using namespace std;
+
+// Streaming Metrics (on_trade + snapshot) against the exact batch calculate():
+// checks every field (quantiles within the sketch's relative accuracy) and times both.
+// usage: bench_metrics [trades]   (default 5M)
+
+namespace {
+
+// heavy-tailed latencies so the quantiles are actually exercised
+vector<Trade> make_trades(size_t n) {
+    vector<Trade> trades;
+    trades.reserve(n);
+    uint64_t state = 12345;
+    auto next = [&] {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    };
+    for (size_t i = 0; i < n; ++i) {
+        double pnl = (static_cast<double>(next() % 20001) - 9800.0) / 100.0;
+        uint64_t entry_latency = 1 + next() % 50;
+        uint64_t exit_latency = (next() % 100 == 0) ? 1000 + next() % 100000 : 1 + next() % 80;
+        trades.push_back(Trade{i, i * 60000, i * 60000 + 5000, entry_latency, exit_latency,
+                               100.0, 100.0 + pnl, 1.0, pnl});
+    }
+    return trades;
+}
+
+bool close_rel(double approx, double exact, double accuracy) {
+    return fabs(approx - exact) <= accuracy * fabs(exact) + 1e-9;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    size_t n = argc > 1 ? stoull(argv[1]) : 5000000;
+    vector<Trade> trades = make_trades(n);
+
+    Metrics batch_metrics(1000000);
+    Stopwatch sw;
+    Statistics exact = batch_metrics.calculate(trades);
+    double batch_secs = sw.seconds();
+
+    Metrics streaming(1000000);
+    sw.reset();
+    for (const auto& trade : trades) streaming.on_trade(trade);
+    Statistics online = streaming.snapshot();
+    double stream_secs = sw.seconds();
+
+    cout << fixed << setprecision(2);
+    cout << left << setw(26) << "batch calculate():" << batch_secs * 1e9 / static_cast<double>(n) << " ns/trade" << endl;
+    cout << left << setw(26) << "streaming on_trade():" << stream_secs * 1e9 / static_cast<double>(n) << " ns/trade" << endl;
+    cout << left << setw(26) << "P99 exact / sketch:" << exact.p99_latency_us << " / " << online.p99_latency_us << " us" << endl;
+    cout << left << setw(26) << "P50 exact / sketch:" << exact.p50_latency_us << " / " << online.p50_latency_us << " us" << endl;
+
+    bool ok = exact.total_trades == online.total_trades &&
+              exact.winning_trades == online.winning_trades &&
+              exact.total_pnl == online.total_pnl &&
+              exact.win_rate == online.win_rate &&
+              exact.max_drawdown == online.max_drawdown &&
+              exact.largest_win == online.largest_win &&
+              exact.largest_loss == online.largest_loss &&
+              exact.avg_entry_latency_us == online.avg_entry_latency_us &&
+              exact.avg_exit_latency_us == online.avg_exit_latency_us &&
+              close_rel(online.p99_latency_us, exact.p99_latency_us, 0.01) &&
+              close_rel(online.p50_latency_us, exact.p50_latency_us, 0.01);
+    if (!ok) {
+        cerr << "Streaming metrics disagree with the batch computation!" << endl;
+        return 1;
+    }
+    cout << "Streaming metrics match the batch computation" << endl;
+    return 0;
+}
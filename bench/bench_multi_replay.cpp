@@ -0,0 +1,91 @@
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "bench_util.h"
+#include "executor.h"
+#include "multi_replay_engine.h"
+#include "replay_engine.h"
+#include "strategy.h"
+
+using namespace std;
+
+// Per-bar cost of the loser-tree portfolio replay against a single-symbol replay of the
+// same number of bars. Every 7th bar of every 3rd symbol is dropped so batches vary in size.
+// usage: bench_multi_replay [symbols] [bars_per_symbol]   (default 200 x 50000)
+
+int main(int argc, char* argv[]) {
+    uint32_t symbols = argc > 1 ? static_cast<uint32_t>(stoul(argv[1])) : 200;
+    size_t bars_per_symbol = argc > 2 ? stoull(argv[2]) : 50000;
+
+    vector<vector<Kline>> per_symbol(symbols);
+    size_t total = 0;
+    for (uint32_t s = 0; s < symbols; ++s) {
+        SyntheticKlines gen(s + 1);
+        per_symbol[s].reserve(bars_per_symbol);
+        for (size_t i = 0; i < bars_per_symbol; ++i) {
+            Kline k = gen.next(s);
+            if (s % 3 == 0 && i % 7 == 3) continue;
+            per_symbol[s].push_back(k);
+        }
+        total += per_symbol[s].size();
+    }
+
+    vector<Kline> single;
+    single.reserve(total);
+    SyntheticKlines gen(99);
+    for (size_t i = 0; i < total; ++i) single.push_back(gen.next());
+
+    const uint64_t hold_ms = 5 * 60000;
+
+    // single symbol baseline
+    Stopwatch sw;
+    size_t single_trades = 0;
+    {
+        Strategy strategy(hold_ms);
+        Executor executor(1000000);
+        ReplayEngine engine(single);
+        engine.replay([&](const Kline& kline) {
+            if (executor.on_kline(kline, strategy.on_kline(kline))) ++single_trades;
+        });
+    }
+    double single_secs = sw.seconds();
+
+    // portfolio: merged streams, per-symbol state in flat arrays indexed by symbol_id
+    vector<span<const Kline>> streams;
+    for (const auto& s : per_symbol) streams.emplace_back(s);
+
+    sw.reset();
+    size_t multi_trades = 0, delivered = 0, batches = 0;
+    uint64_t last_ts = 0;
+    bool ordered = true;
+    {
+        vector<Strategy> strategies(symbols, Strategy(hold_ms));
+        vector<Executor> executors(symbols, Executor(1000000));
+        MultiReplayEngine engine(streams);
+        engine.replay([&](uint64_t ts, span<const Kline> bars) {
+            ordered = ordered && ts > last_ts;
+            last_ts = ts;
+            ++batches;
+            for (const auto& kline : bars) {
+                uint32_t id = kline.symbol_id;
+                if (executors[id].on_kline(kline, strategies[id].on_kline(kline))) ++multi_trades;
+            }
+            delivered += bars.size();
+        });
+    }
+    double multi_secs = sw.seconds();
+
+    auto ns = [&](double secs) { return secs * 1e9 / static_cast<double>(total); };
+    cout << fixed << setprecision(2);
+    cout << "Bars: " << total << " across " << symbols << " symbols, " << batches << " timestamp batches" << endl;
+    cout << left << setw(28) << "single-symbol replay:" << ns(single_secs) << " ns/bar (" << single_trades << " trades)" << endl;
+    cout << left << setw(28) << "merged portfolio replay:" << ns(multi_secs) << " ns/bar (" << multi_trades << " trades)" << endl;
+    cout << "Overhead per bar: " << ns(multi_secs) - ns(single_secs) << " ns" << endl;
+
+    if (!ordered || delivered != total) {
+        cerr << "Merge delivered bars out of order or lost some!" << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench_util.h"
+#include "data_loader.h"
+#include "mapped_file.h"
+#include "parser.h"
+
+using namespace std;
+
+// Speedup of Parser::parse_klines_parallel from 1 to N threads.
+// usage: bench_parse_scaling [csv_file | rows] [max_threads]   (default: 4M synthetic rows, all cores)
+
+namespace {
+
+bool same_klines(const vector<Kline>& a, const vector<Kline>& b)
+{
+    return a.size() == b.size() && equal(a.begin(), a.end(), b.begin(), [](const Kline& x, const Kline& y) {
+        return x.timestamp_ms == y.timestamp_ms && x.symbol_id == y.symbol_id && x.close == y.close;
+    });
+}
+
+// rows out of time order, with a tie: the serial and parallel loaders must agree
+bool unsorted_loads_agree()
+{
+    const string path = "/tmp/hypertradex_bench_unsorted.csv";
+    {
+        ofstream out(path);
+        out << "timestamp_ms,symbol,open,high,low,close,volume\n"
+            << "1700000120000,BTCUSDT,3,3,3,3,1\n"
+            << "1700000000000,BTCUSDT,1,1,1,1,1\n"
+            << "1700000060000,ETHUSDT,2,2,2,2,1\n"
+            << "1700000000000,ETHUSDT,4,4,4,4,1\n";
+    }
+    bool agree = same_klines(DataLoader::load_klines(path), DataLoader::load_klines_parallel(path, 4));
+    remove(path.c_str());
+    return agree;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        string path = "/tmp/hypertradex_bench_scaling.csv";
+        size_t rows = 4000000;
+        if (argc > 1) {
+            string arg = argv[1];
+            if (!arg.empty() && isdigit(static_cast<unsigned char>(arg[0]))) {
+                rows = stoull(arg);
+            } else {
+                path = arg;
+                rows = 0;
+            }
+        }
+        unsigned max_threads = argc > 2 ? static_cast<unsigned>(stoul(argv[2]))
+                                        : max(1u, thread::hardware_concurrency());
+
+        if (rows > 0) {
+            cout << "Generating " << rows << " synthetic klines -> " << path << endl;
+            write_synthetic_csv(path, rows);
+        }
+
+        MappedFile file(path);
+        span<const char> data(file.data(), file.size());
+
+        // reference result + page cache warm-up
+        vector<Kline> reference = Parser::parse_klines_parallel(data, 1);
+
+        double base_secs = 0.0;
+        cout << left << setw(10) << "threads" << setw(12) << "seconds" << setw(14) << "M klines/s" << "speedup" << endl;
+        // 1, 2, 4, ... and always max_threads itself
+        vector<unsigned> counts;
+        for (unsigned t = 1; t < max_threads; t *= 2) counts.push_back(t);
+        counts.push_back(max_threads);
+
+        for (unsigned threads : counts) {
+            Stopwatch sw;
+            vector<Kline> klines = Parser::parse_klines_parallel(data, threads);
+            double secs = sw.seconds();
+            if (threads == 1) base_secs = secs;
+
+            if (!same_klines(klines, reference)) {
+                cerr << "Result with " << threads << " threads differs from the single-threaded parse!" << endl;
+                return 1;
+            }
+
+            cout << left << setw(10) << threads
+                 << fixed << setprecision(3) << setw(12) << secs
+                 << setprecision(2) << setw(14) << (static_cast<double>(klines.size()) / secs / 1e6)
+                 << (base_secs / secs) << "x" << endl;
+        }
+        if (!unsorted_loads_agree()) {
+            cerr << "Serial and parallel loaders order unsorted rows differently!" << endl;
+            return 1;
+        }
+        return 0;
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,105 @@
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "bench_util.h"
+#include "executor.h"
+#include "replay_engine.h"
+#include "strategy.h"
+
+using namespace std;
+
+// ns/bar of the Strategy -> Executor -> trade-record loop:
+//   before: engine copies the input, every bar goes through std::function
+//   after:  engine borrows a span, callback is a template parameter
+// usage: bench_replay_dispatch [bars] [repeats]   (default 10M bars, 5 repeats)
+
+namespace {
+
+struct RunResult {
+    double secs = 0.0;
+    size_t trades = 0;
+    double pnl = 0.0;
+};
+
+// the pre-change engine, kept here only as the baseline
+class CopyingReplayEngine {
+public:
+    using KlineCallback = function<void(const Kline&)>;
+    explicit CopyingReplayEngine(const vector<Kline>& klines) : klines_(klines) {}
+    void replay(KlineCallback on_kline) {
+        for (const auto& kline : klines_) on_kline(kline);
+    }
+
+private:
+    vector<Kline> klines_;
+};
+
+template <typename Run>
+RunResult best_of(size_t repeats, Run&& run) {
+    RunResult best;
+    for (size_t r = 0; r < repeats; ++r) {
+        RunResult result = run();
+        if (r == 0 || result.secs < best.secs) best = result;
+    }
+    return best;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    size_t bars = argc > 1 ? stoull(argv[1]) : 10000000;
+    size_t repeats = argc > 2 ? stoull(argv[2]) : 5;
+
+    vector<Kline> klines;
+    klines.reserve(bars);
+    SyntheticKlines gen(7, 1704067200000ULL, 1000);
+    for (size_t i = 0; i < bars; ++i) klines.push_back(gen.next());
+
+    RunResult before = best_of(repeats, [&] {
+        RunResult result;
+        Stopwatch sw;
+        Strategy strategy(5000);
+        Executor executor(1000000);
+        vector<Trade> trades;
+        CopyingReplayEngine engine(klines);
+        engine.replay([&](const Kline& kline) {
+            auto trade = executor.on_kline(kline, strategy.on_kline(kline));
+            if (trade.has_value()) trades.push_back(trade.value());
+        });
+        result.secs = sw.seconds();
+        result.trades = trades.size();
+        for (const auto& t : trades) result.pnl += t.pnl;
+        return result;
+    });
+
+    RunResult after = best_of(repeats, [&] {
+        RunResult result;
+        Stopwatch sw;
+        Strategy strategy(5000);
+        Executor executor(1000000);
+        vector<Trade> trades;
+        ReplayEngine engine(klines);
+        engine.replay([&](const Kline& kline) {
+            auto trade = executor.on_kline(kline, strategy.on_kline(kline));
+            if (trade.has_value()) trades.push_back(trade.value());
+        });
+        result.secs = sw.seconds();
+        result.trades = trades.size();
+        for (const auto& t : trades) result.pnl += t.pnl;
+        return result;
+    });
+
+    auto ns_per_bar = [&](const RunResult& r) { return r.secs * 1e9 / static_cast<double>(bars); };
+    cout << fixed << setprecision(2);
+    cout << left << setw(36) << "copy + std::function:" << ns_per_bar(before) << " ns/bar" << endl;
+    cout << left << setw(36) << "borrowed span + template callback:" << ns_per_bar(after) << " ns/bar" << endl;
+    cout << "Speedup: " << before.secs / after.secs << "x (" << after.trades << " trades)" << endl;
+
+    if (before.trades != after.trades || before.pnl != after.pnl) {
+        cerr << "Results differ between replay paths!" << endl;
+        return 1;
+    }
+    return 0;
+}
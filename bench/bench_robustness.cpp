@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "backtest.h"
+#include "bench_util.h"
+#include "executor.h"
+#include "metrics.h"
+#include "philox.h"
+#include "replay_engine.h"
+#include "robustness.h"
+#include "strategy.h"
+
+using namespace std;
+
+// Monte Carlo resampling and walk-forward: Philox known answers, reproducibility across
+// thread counts, exactness against Metrics, and 100k-resample throughput.
+// usage: bench_robustness [resamples] [threads]   (default 100000, 4)
+
+namespace {
+
+vector<Trade> backtest_trades(const vector<Kline>& klines, uint64_t hold_ms)
+{
+    Strategy strategy(hold_ms);
+    Executor executor(1000000);
+    ReplayEngine engine(klines);
+    vector<Trade> trades;
+    run_backtest(engine, strategy, executor, [&](const Trade& t) { trades.push_back(t); });
+    return trades;
+}
+
+void print_distribution(const string& name, const Distribution& d)
+{
+    cout << left << setw(14) << name << "mean " << setw(12) << d.mean << "sd " << setw(12) << d.stdev << "p05 "
+         << setw(12) << d.p05 << "p50 " << setw(12) << d.p50 << "p95 " << d.p95 << endl;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    size_t resamples = argc > 1 ? stoull(argv[1]) : 100000;
+    unsigned threads = argc > 2 ? static_cast<unsigned>(stoul(argv[2])) : 4;
+    bool ok = true;
+    cout << fixed << setprecision(2);
+
+    // Random123 known-answer vectors for Philox4x32-10
+    auto zero = Philox4x32::generate({0, 0, 0, 0}, {0, 0});
+    auto ones = Philox4x32::generate({~0u, ~0u, ~0u, ~0u}, {~0u, ~0u});
+    if (zero != Philox4x32::Counter{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8} ||
+        ones != Philox4x32::Counter{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}) {
+        cerr << "Philox4x32-10 does not match the known-answer vectors" << endl;
+        ok = false;
+    }
+
+    // ~2000 trades from a real backtest over synthetic 1m bars
+    SyntheticKlines gen(5);
+    vector<Kline> klines;
+    for (size_t i = 0; i < 12000; ++i) klines.push_back(gen.next());
+    vector<Trade> trades = backtest_trades(klines, 5 * 60000);
+    Metrics metrics(1000000);
+    Statistics actual = metrics.calculate(trades);
+    cout << trades.size() << " trades, pnl " << actual.total_pnl << ", max drawdown " << actual.max_drawdown << endl;
+
+    MonteCarlo mc(trades, 1000000);
+
+    // a block as long as the run can only start at trade 0: every resample is the run itself
+    ResampleConfig whole{64, ResampleMethod::Bootstrap, trades.size(), 1, threads};
+    ResampleResult identity = mc.run(whole);
+    for (size_t r = 0; r < identity.total_pnl.size(); ++r) {
+        if (identity.total_pnl[r] != actual.total_pnl || identity.max_drawdown[r] != actual.max_drawdown) {
+            cerr << "Full-length block resample differs from Metrics::calculate" << endl;
+            ok = false;
+            break;
+        }
+    }
+
+    // ---- 100k bootstrap resamples
+    ResampleConfig config{resamples, ResampleMethod::Bootstrap, 1, 2024, threads};
+    Stopwatch sw;
+    ResampleResult boot = mc.run(config);
+    double boot_secs = sw.seconds();
+    cout << "\n" << resamples << " bootstrap resamples on " << threads << " threads: " << setprecision(3) << boot_secs
+         << " s (" << setprecision(2) << static_cast<double>(resamples * trades.size()) / boot_secs / 1e6
+         << " M trades/s)" << endl;
+    print_distribution("total pnl:", boot.pnl);
+    print_distribution("max drawdown:", boot.drawdown);
+    cout << left << setw(14) << "P(loss):" << boot.probability_of_loss * 100.0 << "%" << endl;
+
+    // the bootstrap mean of the total estimates the actual total
+    double standard_error = boot.pnl.stdev / sqrt(static_cast<double>(resamples));
+    if (fabs(boot.pnl.mean - actual.total_pnl) > 5.0 * standard_error + 1e-9) {
+        cerr << "Bootstrap mean " << boot.pnl.mean << " is off the actual pnl " << actual.total_pnl << endl;
+        ok = false;
+    }
+
+    // reproducible: one thread and many give the same numbers, resample for resample
+    ResampleConfig serial = config;
+    serial.threads = 1;
+    serial.resamples = min<size_t>(resamples, 20000);
+    ResampleResult one = mc.run(serial);
+    if (!equal(one.total_pnl.begin(), one.total_pnl.end(), boot.total_pnl.begin()) ||
+        !equal(one.max_drawdown.begin(), one.max_drawdown.end(), boot.max_drawdown.begin())) {
+        cerr << "Resamples depend on the thread count" << endl;
+        ok = false;
+    }
+
+    // ---- shuffles and block bootstrap
+    ResampleConfig shuffle{resamples / 10, ResampleMethod::Shuffle, 1, 7, threads};
+    sw.reset();
+    ResampleResult shuffled = mc.run(shuffle);
+    double shuffle_secs = sw.seconds();
+    cout << "\n" << shuffle.resamples << " shuffles: " << setprecision(3) << shuffle_secs << " s" << setprecision(2)
+         << endl;
+    print_distribution("max drawdown:", shuffled.drawdown);
+    double scale = max(1.0, fabs(actual.total_pnl));
+    for (double pnl : shuffled.total_pnl) {
+        if (fabs(pnl - actual.total_pnl) > 1e-9 * scale * static_cast<double>(trades.size())) {
+            cerr << "A shuffle changed the total pnl: " << pnl << endl;
+            ok = false;
+            break;
+        }
+    }
+
+    ResampleConfig blocks{resamples / 10, ResampleMethod::Bootstrap, 20, 11, threads};
+    ResampleResult blocked = mc.run(blocks);
+    print_distribution("block dd:", blocked.drawdown);
+
+    // ---- walk-forward over zero-copy windows
+    vector<Kline> history;
+    history.reserve(200000);
+    SyntheticKlines hist_gen(9);
+    for (size_t i = 0; i < 200000; ++i) history.push_back(hist_gen.next());
+    vector<SweepPoint> grid{{60000}, {5 * 60000}, {15 * 60000}, {60 * 60000}};
+    WalkForwardConfig wf{20000, 5000, 0, false, threads};
+
+    auto windows = WalkForward::windows(history, wf);
+    for (const auto& w : windows) {
+        if (w.train.data() != history.data() + w.train_begin || w.test.data() != history.data() + w.test_begin) {
+            cerr << "Walk-forward window is not a view into the input" << endl;
+            ok = false;
+            break;
+        }
+    }
+
+    WalkForward walk(history, 1000000);
+    sw.reset();
+    vector<WalkForwardResult> results = walk.run(wf, grid);
+    double wf_secs = sw.seconds();
+    double oos_pnl = 0.0, is_pnl = 0.0;
+    for (const auto& r : results) {
+        oos_pnl += r.out_of_sample.total_pnl;
+        is_pnl += r.in_sample.total_pnl;
+    }
+    cout << "\nwalk-forward: " << results.size() << " windows x " << grid.size() << " points in " << setprecision(3)
+         << wf_secs << " s" << setprecision(2) << ", in-sample pnl " << is_pnl << ", out-of-sample pnl " << oos_pnl
+         << endl;
+
+    // spot check one window against a direct run on a copy
+    if (!results.empty()) {
+        const auto& r = results[results.size() / 2];
+        vector<Kline> test_copy(history.begin() + static_cast<ptrdiff_t>(r.test_begin),
+                                history.begin() + static_cast<ptrdiff_t>(r.test_end));
+        Statistics direct = SweepRunner::run_point(test_copy, 1000000, r.chosen).stats;
+        if (direct.total_pnl != r.out_of_sample.total_pnl || direct.total_trades != r.out_of_sample.total_trades) {
+            cerr << "Walk-forward out-of-sample run differs from a direct run" << endl;
+            ok = false;
+        }
+    }
+
+    if (!ok) {
+        cerr << "Robustness checks failed!" << endl;
+        return 1;
+    }
+    cout << "Resamples are reproducible and exact against Metrics" << endl;
+    return 0;
+}
@@ -0,0 +1,143 @@
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <vector>
+#include "bench_util.h"
+#include "data_loader.h"
+#include "executor.h"
+#include "metrics.h"
+#include "parser.h"
+#include "replay_engine.h"
+#include "run_arena.h"
+#include "strategy.h"
+#include "sweep_runner.h"
+
+using namespace std;
+
+// Whole backtest object graph per run (CSV lines, klines, trade log, Metrics scratch)
+// on the default heap vs a per-run RunArena. Counts operator new calls per run and times
+// repeated runs; steady-state arena runs must make zero heap calls and give identical stats.
+// SweepRunner::run_point, which streams trades into an arena-backed Metrics, is held to the same.
+// usage: bench_run_arena [rows] [runs]   (default 100000 rows, 20 runs)
+
+namespace {
+
+atomic<size_t> g_allocations{0};
+
+Statistics run_backtest(const string& csv, pmr::memory_resource* resource) {
+    // legacy line loader + per-line parse, the allocation-heaviest path
+    pmr::vector<pmr::string> lines = DataLoader::load_file(csv, resource);
+    pmr::vector<Kline> klines(resource);
+    klines.reserve(lines.size());
+    for (size_t i = 1; i < lines.size(); ++i) {
+        klines.push_back(Parser::parse_kline(string_view(lines[i])));
+    }
+
+    Strategy strategy(5 * 60000);
+    Executor executor(1000000);
+    pmr::vector<Trade> trades(resource);
+    ReplayEngine engine(klines);
+    engine.replay([&](const Kline& kline) {
+        auto result = executor.on_kline(kline, strategy.on_kline(kline));
+        if (result.has_value()) trades.push_back(result.value());
+    });
+
+    Metrics metrics(1000000, resource);
+    return metrics.calculate(trades);
+}
+
+bool same(const Statistics& a, const Statistics& b) {
+    return a.total_trades == b.total_trades && a.winning_trades == b.winning_trades && a.total_pnl == b.total_pnl &&
+           a.max_drawdown == b.max_drawdown && a.p99_latency_us == b.p99_latency_us && a.p50_latency_us == b.p50_latency_us;
+}
+
+}
+
+void* operator new(size_t size) {
+    ++g_allocations;
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw bad_alloc();
+}
+void* operator new(size_t size, align_val_t align) {
+    ++g_allocations;
+    size_t a = static_cast<size_t>(align);
+    if (void* p = aligned_alloc(a, (size + a - 1) / a * a)) return p;
+    throw bad_alloc();
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete(void* p, align_val_t) noexcept { free(p); }
+void operator delete(void* p, size_t, align_val_t) noexcept { free(p); }
+
+int main(int argc, char* argv[]) {
+    size_t rows = argc > 1 ? stoull(argv[1]) : 100000;
+    size_t runs = argc > 2 ? stoull(argv[2]) : 20;
+    string csv = "/tmp/hypertradex_bench_arena.csv";
+    write_synthetic_csv(csv, rows);
+
+    // warm up the symbol table so neither mode pays for interning
+    Statistics expected = run_backtest(csv, pmr::new_delete_resource());
+
+    cout << fixed << setprecision(2);
+    cout << rows << " rows, " << runs << " runs" << endl;
+
+    bool ok = true;
+    double heap_secs = 0.0, arena_secs = 0.0;
+    size_t heap_allocs = 0, arena_steady_allocs = 0, arena_first_allocs = 0;
+
+    for (size_t r = 0; r < runs; ++r) {
+        size_t before = g_allocations.load();
+        Stopwatch sw;
+        ok &= same(run_backtest(csv, pmr::new_delete_resource()), expected);
+        heap_secs += sw.seconds();
+        heap_allocs += g_allocations.load() - before;
+    }
+
+    RunArena arena(64 * 1024);  // deliberately small: the first run has to grow it
+    for (size_t r = 0; r < runs; ++r) {
+        arena.reset();
+        size_t before = g_allocations.load();
+        Stopwatch sw;
+        ok &= same(run_backtest(csv, &arena), expected);
+        double secs = sw.seconds();
+        size_t allocs = g_allocations.load() - before;
+        if (r == 0) {
+            arena_first_allocs = allocs;
+        } else {
+            arena_secs += secs;
+            arena_steady_allocs += allocs;
+        }
+    }
+    // a sweep grid point after its worker's first one
+    vector<Kline> sweep_klines = DataLoader::load_klines(csv);
+    SweepRunner::run_point(sweep_klines, 1000000, SweepPoint{5 * 60000});
+    size_t sweep_before = g_allocations.load();
+    SweepResult point = SweepRunner::run_point(sweep_klines, 1000000, SweepPoint{5 * 60000});
+    size_t sweep_allocs = g_allocations.load() - sweep_before;
+    ok &= point.stats.total_trades == expected.total_trades && point.stats.total_pnl == expected.total_pnl;
+
+    heap_secs /= static_cast<double>(runs);
+    arena_secs /= static_cast<double>(max<size_t>(runs - 1, 1));
+
+    cout << left << setw(28) << "heap:" << setw(10) << heap_secs * 1000 << " ms/run  "
+         << heap_allocs / runs << " allocations/run" << endl;
+    cout << left << setw(28) << "arena, first run:" << arena_first_allocs << " allocations (buffer growth)" << endl;
+    cout << left << setw(28) << "arena, steady state:" << setw(10) << arena_secs * 1000 << " ms/run  "
+         << arena_steady_allocs / max<size_t>(runs - 1, 1) << " allocations/run" << endl;
+    cout << left << setw(28) << "arena capacity:" << arena.capacity() / 1024 << " KiB" << endl;
+    cout << left << setw(28) << "speedup:" << heap_secs / arena_secs << "x" << endl;
+    cout << left << setw(28) << "sweep point, steady state:" << sweep_allocs << " allocations" << endl;
+
+    remove(csv.c_str());
+    if (!ok || arena_steady_allocs != 0 || sweep_allocs != 0) {
+        cerr << "Arena runs allocated on the heap or changed the results!" << endl;
+        return 1;
+    }
+    cout << "Steady-state arena runs make no heap allocations" << endl;
+    return 0;
+}
@@ -0,0 +1,179 @@
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "backtest.h"
+#include "bench_util.h"
+#include "executor.h"
+#include "replay_engine.h"
+#include "strategy.h"
+#include "strategy_blocks.h"
+
+using namespace std;
+
+// Compile-time composed strategies vs the same rules written by hand inside the loop.
+// Each pair must produce identical trades, and the composed ns/bar may exceed the hand-written
+// one by at most max_overhead (a fraction, default 0.15) before the bench fails.
+// usage: bench_strategy_compose [bars] [reps] [max_overhead]   (default 2000000 bars, 9 reps)
+
+namespace {
+
+struct RunResult
+{
+    uint64_t trades = 0;
+    double pnl = 0.0;
+    uint64_t exit_time_sum = 0;
+    double ns_per_bar = 0.0;
+
+    bool same_trades(const RunResult& other) const
+    {
+        return trades == other.trades && pnl == other.pnl && exit_time_sum == other.exit_time_sum;
+    }
+};
+
+// one replay of `body(engine, executor, on_trade)`; keeps the fastest run in `best`.
+// The variants are run interleaved, one rep each in turn, so machine noise hits all of them alike,
+// and each gets its own out-of-line copy so no loop inherits another's code placement.
+template <typename Body>
+__attribute__((noinline)) void measure(const vector<Kline>& klines, RunResult& best, Body&& body)
+{
+    RunResult run;
+    Executor executor(1000000);
+    ReplayEngine engine(klines);
+    Stopwatch sw;
+    body(engine, executor, [&](const Trade& trade) {
+        ++run.trades;
+        run.pnl += trade.pnl;
+        run.exit_time_sum += trade.exit_time_ms;
+    });
+    run.ns_per_bar = sw.seconds() * 1e9 / static_cast<double>(klines.size());
+    if (best.ns_per_bar == 0.0 || run.ns_per_bar < best.ns_per_bar) {
+        best = run;
+    }
+}
+
+constexpr uint64_t kHoldMs = 5 * 60000;
+constexpr uint64_t kMaxHoldMs = 60 * 60000;
+constexpr double kTakeProfit = 0.004;
+constexpr double kStopLoss = 0.002;
+
+// Strategy's rule written directly into the loop body
+void hand_hold(ReplayEngine& engine, Executor& executor, auto&& on_trade)
+{
+    uint64_t entry_time_ms = 0;
+    bool has_position = false;
+    engine.replay([&](const Kline& kline) {
+        Decision decision{};
+        if (!has_position) {
+            decision = Decision{true, true, 1};
+            entry_time_ms = kline.timestamp_ms;
+            has_position = true;
+        } else if (kline.timestamp_ms - entry_time_ms >= kHoldMs) {
+            decision = Decision{true, false, 1};
+            has_position = false;
+        }
+        auto result = executor.on_kline(kline, decision);
+        if (result.has_value()) on_trade(result.value());
+    });
+}
+
+// up-close entry, exit on time / take-profit / stop-loss, written by hand
+void hand_bracket(ReplayEngine& engine, Executor& executor, auto&& on_trade)
+{
+    double previous_close = 0.0;
+    uint64_t entry_time_ms = 0;
+    double entry_price = 0.0;
+    bool has_position = false;
+    engine.replay([&](const Kline& kline) {
+        bool up = previous_close > 0.0 && kline.close > previous_close;
+        previous_close = kline.close;
+        Decision decision{};
+        if (!has_position) {
+            if (up) {
+                decision = Decision{true, true, 1};
+                entry_time_ms = kline.timestamp_ms;
+                entry_price = kline.close;
+                has_position = true;
+            }
+        } else if (kline.timestamp_ms - entry_time_ms >= kMaxHoldMs ||
+                   kline.close >= entry_price * (1.0 + kTakeProfit) ||
+                   kline.close <= entry_price * (1.0 - kStopLoss)) {
+            decision = Decision{true, false, 1};
+            has_position = false;
+        }
+        auto result = executor.on_kline(kline, decision);
+        if (result.has_value()) on_trade(result.value());
+    });
+}
+
+using BracketStrategy =
+    ComposedStrategy<EnterOnUpClose, AnyExit<ExitAfterHold, TakeProfit, StopLoss>, FixedSize>;
+
+void print_row(const string& name, const RunResult& r)
+{
+    cout << left << setw(34) << name << setw(10) << r.ns_per_bar << " ns/bar  " << r.trades << " trades  pnl "
+         << r.pnl << endl;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    size_t bars = argc > 1 ? stoull(argv[1]) : 2000000;
+    size_t reps = argc > 2 ? stoull(argv[2]) : 9;
+    double max_overhead = argc > 3 ? stod(argv[3]) : 0.15;
+
+    SyntheticKlines gen;
+    vector<Kline> klines;
+    klines.reserve(bars);
+    for (size_t i = 0; i < bars; ++i) klines.push_back(gen.next());
+
+    RunResult hold_hand, hold_composed, hold_class, bracket_hand, bracket_composed;
+    for (size_t r = 0; r < reps; ++r) {
+        measure(klines, hold_hand, [](auto& engine, auto& executor, auto&& on_trade) {
+            hand_hold(engine, executor, on_trade);
+        });
+        measure(klines, hold_composed, [](auto& engine, auto& executor, auto&& on_trade) {
+            HoldStrategy strategy = make_hold_strategy(kHoldMs);
+            run_backtest(engine, strategy, executor, on_trade);
+        });
+        measure(klines, hold_class, [](auto& engine, auto& executor, auto&& on_trade) {
+            Strategy strategy(kHoldMs);
+            run_backtest(engine, strategy, executor, on_trade);
+        });
+        measure(klines, bracket_hand, [](auto& engine, auto& executor, auto&& on_trade) {
+            hand_bracket(engine, executor, on_trade);
+        });
+        measure(klines, bracket_composed, [](auto& engine, auto& executor, auto&& on_trade) {
+            BracketStrategy strategy{
+                {}, {{ExitAfterHold{kMaxHoldMs}, TakeProfit{kTakeProfit}, StopLoss{kStopLoss}}}, FixedSize{1}};
+            run_backtest(engine, strategy, executor, on_trade);
+        });
+    }
+
+    cout << fixed << setprecision(2);
+    cout << bars << " bars, best of " << reps << endl;
+    print_row("hold, hand-written:", hold_hand);
+    print_row("hold, ComposedStrategy:", hold_composed);
+    print_row("hold, Strategy class:", hold_class);
+    print_row("bracket, hand-written:", bracket_hand);
+    print_row("bracket, ComposedStrategy:", bracket_composed);
+    double hold_overhead = hold_composed.ns_per_bar / hold_hand.ns_per_bar - 1.0;
+    double bracket_overhead = bracket_composed.ns_per_bar / bracket_hand.ns_per_bar - 1.0;
+    cout << "composition overhead: hold " << hold_overhead * 100.0 << "%, bracket " << bracket_overhead * 100.0
+         << "% (limit " << max_overhead * 100.0 << "%)" << endl;
+
+    if (!hold_composed.same_trades(hold_hand) || !hold_class.same_trades(hold_hand) ||
+        !bracket_composed.same_trades(bracket_hand)) {
+        cerr << "Composed strategies traded differently from the hand-written loops!" << endl;
+        return 1;
+    }
+    cout << "Composed strategies match the hand-written loops trade for trade" << endl;
+
+    if (hold_overhead > max_overhead || bracket_overhead > max_overhead) {
+        cerr << "Composed strategies are slower than the hand-written loops beyond the limit!" << endl;
+        return 1;
+    }
+    return 0;
+}
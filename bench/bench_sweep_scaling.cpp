@@ -0,0 +1,57 @@
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench_util.h"
+#include "sweep_runner.h"
+
+using namespace std;
+
+// Throughput of SweepRunner from 1 to N pool threads over one shared dataset.
+// usage: bench_sweep_scaling [bars] [grid_points] [max_threads]   (default 1M bars, 64 points, all cores)
+
+int main(int argc, char* argv[]) {
+    size_t bars = argc > 1 ? stoull(argv[1]) : 1000000;
+    size_t points = argc > 2 ? stoull(argv[2]) : 64;
+    unsigned max_threads = argc > 3 ? static_cast<unsigned>(stoul(argv[3])) : max(1u, thread::hardware_concurrency());
+
+    vector<Kline> klines;
+    klines.reserve(bars);
+    SyntheticKlines gen(11, 1704067200000ULL, 1000);
+    for (size_t i = 0; i < bars; ++i) klines.push_back(gen.next());
+
+    vector<SweepPoint> grid;
+    for (size_t i = 0; i < points; ++i) grid.push_back(SweepPoint{1000 * (i + 1)});
+
+    vector<unsigned> counts;
+    for (unsigned t = 1; t < max_threads; t *= 2) counts.push_back(t);
+    counts.push_back(max_threads);
+
+    vector<SweepResult> reference;
+    double base_secs = 0.0;
+    cout << left << setw(10) << "threads" << setw(12) << "seconds" << setw(14) << "runs/s" << "speedup" << endl;
+    for (unsigned threads : counts) {
+        SweepRunner runner(klines, 1000000, threads);
+        Stopwatch sw;
+        vector<SweepResult> results = runner.run(grid);
+        double secs = sw.seconds();
+        if (threads == 1) {
+            base_secs = secs;
+            reference = results;
+        }
+
+        for (size_t i = 0; i < results.size(); ++i) {
+            if (results[i].stats.total_trades != reference[i].stats.total_trades ||
+                results[i].stats.total_pnl != reference[i].stats.total_pnl) {
+                cerr << "Sweep result " << i << " differs with " << threads << " threads!" << endl;
+                return 1;
+            }
+        }
+
+        cout << left << setw(10) << threads << fixed << setprecision(3) << setw(12) << secs
+             << setprecision(1) << setw(14) << (static_cast<double>(points) / secs)
+             << setprecision(2) << (base_secs / secs) << "x" << endl;
+    }
+    return 0;
+}
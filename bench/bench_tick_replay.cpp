@@ -0,0 +1,226 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "bar_aggregator.h"
+#include "bench_util.h"
+#include "data_loader.h"
+#include "parser.h"
+#include "replay_engine.h"
+#include "tick_store.h"
+
+using namespace std;
+
+// Tick replay: raw trade-by-trade replay, on-the-fly time/volume/dollar bars (checked bar for
+// bar against a plain reference loop), the mmapped .htt store and the aggTrades CSV loader.
+// usage: bench_tick_replay [ticks] [csv_rows]   (default 20000000 ticks, 2000000 csv rows)
+
+namespace {
+
+constexpr double kTargetEventsPerSec = 50e6;
+
+// straightforward reference aggregation, written independently of BarAggregator
+vector<Kline> reference_bars(const vector<Tick>& ticks, const BarSpec& spec)
+{
+    vector<Kline> bars;
+    uint64_t interval = static_cast<uint64_t>(spec.size);
+    double traded = 0.0;
+    bool open = false;
+    Kline bar{};
+    for (const auto& t : ticks) {
+        uint64_t ms = t.timestamp_us / 1000;
+        if (open && spec.kind == BarKind::Time && ms / interval * interval != bar.timestamp_ms) {
+            bars.push_back(bar);
+            open = false;
+        }
+        if (!open) {
+            uint64_t start = spec.kind == BarKind::Time ? ms / interval * interval : ms;
+            bar = Kline{start, 0, t.symbol_id, t.price, t.price, t.price, t.price, t.quantity};
+            traded = 0.0;
+            open = true;
+        } else {
+            bar.high = max(bar.high, t.price);
+            bar.low = min(bar.low, t.price);
+            bar.close = t.price;
+            bar.volume += t.quantity;
+        }
+        if (spec.kind == BarKind::Volume) traded += t.quantity;
+        if (spec.kind == BarKind::Dollar) traded += t.price * t.quantity;
+        if (spec.kind != BarKind::Time && traded >= spec.size) {
+            bars.push_back(bar);
+            open = false;
+        }
+    }
+    if (open) bars.push_back(bar);
+    return bars;
+}
+
+bool same_bar(const Kline& a, const Kline& b)
+{
+    return a.timestamp_ms == b.timestamp_ms && a.symbol_id == b.symbol_id && a.open == b.open &&
+           a.high == b.high && a.low == b.low && a.close == b.close && a.volume == b.volume;
+}
+
+bool same_tick(const Tick& a, const Tick& b)
+{
+    return a.timestamp_us == b.timestamp_us && a.price == b.price && a.quantity == b.quantity &&
+           a.symbol_id == b.symbol_id && a.buyer_is_maker == b.buyer_is_maker;
+}
+
+// best of three, in events per second
+template <typename Run>
+double best_rate(size_t events, Run run)
+{
+    double best = 0.0;
+    for (int rep = 0; rep < 3; ++rep) {
+        Stopwatch sw;
+        run();
+        best = max(best, static_cast<double>(events) / sw.seconds());
+    }
+    return best;
+}
+
+void print_rate(const string& name, double rate)
+{
+    cout << left << setw(30) << name << setw(9) << rate / 1e6 << " M events/s" << endl;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    try {
+        size_t count = argc > 1 ? stoull(argv[1]) : 20000000;
+        size_t csv_rows = argc > 2 ? stoull(argv[2]) : 2000000;
+        bool ok = true;
+        cout << fixed << setprecision(2);
+
+        SyntheticTicks gen;
+        vector<Tick> ticks;
+        ticks.reserve(count);
+        for (size_t i = 0; i < count; ++i) ticks.push_back(gen.next());
+        cout << count << " synthetic ticks" << endl;
+
+        // ---- raw replay: a cheap consumer, so the loop itself is what's measured
+        double volume = 0.0;
+        uint64_t sells = 0;
+        double raw_rate = best_rate(count, [&] {
+            ReplayEngine engine(ticks);
+            volume = 0.0;
+            sells = 0;
+            engine.replay_ticks([&](const Tick& t) {
+                volume += t.quantity;
+                sells += t.buyer_is_maker;
+            });
+        });
+        print_rate("tick replay:", raw_rate);
+
+        // ---- bars on the fly
+        const pair<string, BarSpec> specs[] = {
+            {"1s time bars:", BarSpec::time(1000)},
+            {"10-unit volume bars:", BarSpec::volume(10.0)},
+            {"$1M dollar bars:", BarSpec::dollar(1e6)},
+        };
+        double slowest = raw_rate;
+        for (const auto& [name, spec] : specs) {
+            vector<Kline> bars;
+            bars.reserve(count / 8);
+            double rate = best_rate(count, [&] {
+                bars.clear();
+                ReplayEngine engine(ticks);
+                engine.replay_ticks(spec, [&](const Kline& bar) { bars.push_back(bar); });
+            });
+            slowest = min(slowest, rate);
+            cout << left << setw(30) << name << setw(9) << rate / 1e6 << " M events/s  " << bars.size() << " bars"
+                 << endl;
+
+            vector<Kline> expected = reference_bars(ticks, spec);
+            vector<Kline> batch = BarAggregator::aggregate(ticks, spec);
+            bool match = bars.size() == expected.size() && batch.size() == expected.size() &&
+                         equal(bars.begin(), bars.end(), expected.begin(), same_bar) &&
+                         equal(batch.begin(), batch.end(), expected.begin(), same_bar);
+            if (!match) {
+                cerr << name << " differs from the reference aggregation" << endl;
+                ok = false;
+            }
+        }
+
+        // ---- .htt store: write, map, replay straight out of the mapping
+        string htt_path = "/tmp/hypertradex_bench_ticks.htt";
+        Stopwatch sw;
+        TickWriter::write(htt_path, ticks, {"BTCUSDT"});
+        double write_secs = sw.seconds();
+        {
+            TickReader reader(htt_path);
+            auto mapped = reader.ticks();
+            if (mapped.size() != ticks.size() || !equal(mapped.begin(), mapped.end(), ticks.begin(), same_tick)) {
+                cerr << "Tick store round trip failed" << endl;
+                ok = false;
+            }
+            if (reader.sorted_by_time() && !ticks.empty()) {
+                uint64_t probe = ticks[ticks.size() / 2].timestamp_us;
+                if (mapped[reader.lower_bound(probe)].timestamp_us != probe) {
+                    cerr << "Tick store block index lookup failed" << endl;
+                    ok = false;
+                }
+            }
+            double mapped_volume = 0.0;
+            double mapped_rate = best_rate(count, [&] {
+                ReplayEngine engine(reader.ticks());
+                mapped_volume = 0.0;
+                engine.replay_ticks([&](const Tick& t) { mapped_volume += t.quantity; });
+            });
+            print_rate("replay from mmapped .htt:", mapped_rate);
+            ok &= mapped_volume == volume;
+        }
+        cout << left << setw(30) << ".htt write:" << static_cast<double>(count * sizeof(Tick)) / write_secs / 1e6
+             << " MB/s (" << sizeof(Tick) << " bytes a tick)" << endl;
+
+        // ---- aggTrades CSV loader
+        string csv_path = "/tmp/hypertradex_bench_aggtrades.csv";
+        size_t rows = min(csv_rows, ticks.size());
+        {
+            ofstream out(csv_path);
+            out << "agg_trade_id,price,quantity,first_trade_id,last_trade_id,transact_time,is_buyer_maker,is_best_match\n";
+            char line[192];
+            for (size_t i = 0; i < rows; ++i) {
+                const Tick& t = ticks[i];
+                int n = snprintf(line, sizeof(line), "%zu,%.2f,%.5f,%zu,%zu,%llu,%s,true\n", i, t.price, t.quantity,
+                                 i * 3, i * 3 + 2, static_cast<unsigned long long>(t.timestamp_us),
+                                 t.buyer_is_maker ? "true" : "false");
+                out.write(line, n);
+            }
+        }
+        sw.reset();
+        vector<Tick> loaded = DataLoader::load_agg_trades(csv_path, "BTCUSDT");
+        double load_secs = sw.seconds();
+        uint32_t btc = Parser::symbol_to_id("BTCUSDT");
+        bool csv_match = loaded.size() == rows;
+        for (size_t i = 0; csv_match && i < rows; ++i) {
+            Tick expected = ticks[i];
+            expected.symbol_id = btc;
+            csv_match = same_tick(loaded[i], expected);
+        }
+        if (!csv_match) {
+            cerr << "aggTrades CSV round trip failed" << endl;
+            ok = false;
+        }
+        print_rate("aggTrades CSV load:", static_cast<double>(rows) / load_secs);
+
+        cout << "\nslowest replay path: " << slowest / 1e6 << " M events/s (target "
+             << kTargetEventsPerSec / 1e6 << ")" << endl;
+        if (!ok) {
+            cerr << "Tick replay checks failed!" << endl;
+            return 1;
+        }
+        cout << "Bars match the reference and both stores round-trip exactly" << endl;
+        return 0;
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,204 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "backtest.h"
+#include "bench_util.h"
+#include "metrics.h"
+#include "simd_dispatch.h"
+#include "timeframes.h"
+
+using namespace std;
+
+// Time-range views and resampled timeframes over 1m bars: views against filtered copies,
+// AVX2 against scalar resampling, a straightforward reference for the bars themselves,
+// and delivery order in a multi-timeframe replay.
+// usage: bench_timeframes [bars]   (default 1000000)
+
+namespace {
+
+constexpr uint64_t kMinute = 60000;
+
+// field by field: Kline has padding after symbol_id
+bool same_bits(const Kline& a, const Kline& b)
+{
+    return a.timestamp_ms == b.timestamp_ms && a.fetch_time_ms == b.fetch_time_ms && a.symbol_id == b.symbol_id &&
+           memcmp(&a.open, &b.open, sizeof(double)) == 0 && memcmp(&a.high, &b.high, sizeof(double)) == 0 &&
+           memcmp(&a.low, &b.low, sizeof(double)) == 0 && memcmp(&a.close, &b.close, sizeof(double)) == 0 &&
+           memcmp(&a.volume, &b.volume, sizeof(double)) == 0;
+}
+
+// bucket by bucket with plain sequential loops
+vector<Kline> reference_resample(span<const Kline> base, uint64_t interval_ms)
+{
+    vector<Kline> bars;
+    for (const auto& k : base) {
+        uint64_t bucket = k.timestamp_ms / interval_ms * interval_ms;
+        if (bars.empty() || bars.back().timestamp_ms != bucket) {
+            bars.push_back(Kline{bucket, k.fetch_time_ms, k.symbol_id, k.open, k.high, k.low, k.close, k.volume});
+            continue;
+        }
+        Kline& bar = bars.back();
+        bar.high = max(bar.high, k.high);
+        bar.low = min(bar.low, k.low);
+        bar.close = k.close;
+        bar.volume += k.volume;
+        bar.fetch_time_ms = k.fetch_time_ms;
+    }
+    return bars;
+}
+
+Statistics backtest(span<const Kline> klines)
+{
+    Strategy strategy(15 * kMinute);
+    Executor executor(1000000);
+    Metrics metrics(1000000);
+    ReplayEngine engine(klines);
+    run_backtest(engine, strategy, executor, [&](const Trade& t) { metrics.on_trade(t); });
+    return metrics.snapshot();
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    size_t count = argc > 1 ? stoull(argv[1]) : 1000000;
+    bool ok = true;
+
+    // 1m bars with a few gaps, so some buckets are short
+    vector<Kline> klines;
+    klines.reserve(count);
+    SyntheticKlines gen(21, 1704067200000ULL, kMinute);
+    for (size_t i = 0; i < count; ++i) {
+        Kline k = gen.next();
+        if (i % 997 == 0 && i > 0) continue;
+        klines.push_back(k);
+    }
+    MultiTimeframe frames(klines);
+
+    // ---- time-range views against filtered copies
+    uint64_t start = klines.front().timestamp_ms;
+    uint64_t span_ms = klines.back().timestamp_ms - start;
+    SyntheticKlines picks(3);
+    Stopwatch sw;
+    for (int r = 0; r < 200; ++r) {
+        Kline p = picks.next();
+        uint64_t from = start + static_cast<uint64_t>(p.volume * 1e5) % span_ms - kMinute / 2;
+        uint64_t to = from + static_cast<uint64_t>(p.high * 100.0) % (span_ms / 4);
+        span<const Kline> view = frames.range(from, to);
+        vector<Kline> copy;
+        copy_if(klines.begin(), klines.end(), back_inserter(copy),
+                [&](const Kline& k) { return k.timestamp_ms >= from && k.timestamp_ms < to; });
+        bool inside = view.empty() || (view.data() >= klines.data() && view.data() + view.size() <= klines.data() + klines.size());
+        if (view.size() != copy.size() || !inside || (!copy.empty() && !same_bits(view.front(), copy.front()))) {
+            cerr << "time_range [" << from << ", " << to << ") differs from the filtered copy" << endl;
+            ok = false;
+            break;
+        }
+    }
+
+    // a sub-window backtest on the view matches one on a copy
+    span<const Kline> window = frames.range(start + 30 * 24 * 60 * kMinute, start + 60 * 24 * 60 * kMinute);
+    vector<Kline> window_copy(window.begin(), window.end());
+    if (backtest(window).total_pnl != backtest(window_copy).total_pnl) {
+        cerr << "Backtest over a view differs from one over a copy" << endl;
+        ok = false;
+    }
+
+    // ---- resampling: AVX2 vs scalar vs reference, one object per mode; the first call
+    // also builds the high / low / volume columns, so it is timed on its own
+    set_simd_enabled(false);
+    MultiTimeframe scalar_frames(klines);
+    sw.reset();
+    scalar_frames.bars(kMinute);
+    double columns_secs = sw.seconds();
+    set_simd_enabled(true);
+    MultiTimeframe simd_frames(klines);
+    simd_frames.bars(kMinute);
+
+    cout << klines.size() << " 1m bars" << endl;
+    cout << left << setw(10) << "interval" << setw(10) << "bars" << setw(16) << "scalar M/s" << "avx2 M/s" << endl;
+    for (uint64_t minutes : {5, 15, 60, 240, 1440}) {
+        uint64_t interval = minutes * kMinute;
+
+        set_simd_enabled(false);
+        sw.reset();
+        span<const Kline> scalar = scalar_frames.bars(interval);
+        double scalar_secs = sw.seconds();
+
+        set_simd_enabled(true);
+        sw.reset();
+        span<const Kline> simd = simd_frames.bars(interval);
+        double simd_secs = sw.seconds();
+
+        vector<Kline> reference = reference_resample(klines, interval);
+        if (scalar.size() != reference.size() || simd.size() != reference.size()) {
+            cerr << minutes << "m: bar count differs from the reference" << endl;
+            ok = false;
+            continue;
+        }
+        for (size_t i = 0; i < reference.size(); ++i) {
+            const Kline& a = simd[i];
+            const Kline& b = reference[i];
+            if (!same_bits(a, scalar[i]) || a.timestamp_ms != b.timestamp_ms || a.open != b.open ||
+                a.high != b.high || a.low != b.low || a.close != b.close ||
+                fabs(a.volume - b.volume) > 1e-9 * max(1.0, b.volume)) {
+                cerr << minutes << "m bar " << i << " differs" << endl;
+                ok = false;
+                break;
+            }
+        }
+
+        double n = static_cast<double>(klines.size());
+        cout << left << setw(10) << (to_string(minutes) + "m") << setw(10) << reference.size() << fixed
+             << setprecision(1) << setw(16) << n / scalar_secs / 1e6 << n / simd_secs / 1e6 << endl;
+    }
+
+    cout << "(first timeframe, columns included: " << setprecision(3) << columns_secs << " s)" << endl;
+
+    // ---- one replay, three timeframes: each higher bar arrives right after its bucket closes
+    vector<uint64_t> intervals{5 * kMinute, 15 * kMinute, 60 * kMinute};
+    vector<size_t> delivered(intervals.size(), 0);
+    const Kline* last_base = nullptr;
+    uint64_t from = start + 7 * kMinute;
+    sw.reset();
+    frames.replay(intervals, from, UINT64_MAX, [&](uint64_t interval, const Kline& bar) {
+        if (interval == MultiTimeframe::kBase) {
+            last_base = &bar;
+            return;
+        }
+        size_t f = static_cast<size_t>(find(intervals.begin(), intervals.end(), interval) - intervals.begin());
+        delivered[f]++;
+        const Kline* next = last_base + 1;
+        bool closed = last_base->timestamp_ms >= bar.timestamp_ms && last_base->timestamp_ms < bar.timestamp_ms + interval &&
+                      (next == klines.data() + klines.size() || next->timestamp_ms >= bar.timestamp_ms + interval);
+        if (!closed && ok) {
+            cerr << "A " << interval / kMinute << "m bar was delivered before its bucket closed" << endl;
+            ok = false;
+        }
+    });
+    double replay_secs = sw.seconds();
+    for (size_t f = 0; f < intervals.size(); ++f) {
+        // every bucket closing at or after `from`: all but those ending before it
+        size_t expected = static_cast<size_t>(frames.bars(intervals[f]).end() -
+                                              lower_bound(frames.bars(intervals[f]).begin(),
+                                                          frames.bars(intervals[f]).end(), from - intervals[f] + 1,
+                                                          [](const Kline& k, uint64_t ts) { return k.timestamp_ms < ts; }));
+        if (delivered[f] != expected) {
+            cerr << intervals[f] / kMinute << "m: delivered " << delivered[f] << " bars, expected " << expected << endl;
+            ok = false;
+        }
+    }
+    cout << "\nmulti-timeframe replay (1m + 5m/15m/1h): " << setprecision(3) << replay_secs << " s, "
+         << setprecision(1) << static_cast<double>(klines.size()) / replay_secs / 1e6 << " M base bars/s" << endl;
+
+    if (!ok) {
+        cerr << "Timeframe checks failed!" << endl;
+        return 1;
+    }
+    cout << "Views and resampled timeframes match the references" << endl;
+    return 0;
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <linux/perf_event.h>
+#include <stdexcept>
+#include <string>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "types.h"
+
+using namespace std;
+
+// Small helpers shared by the benchmark executables.
+
+class Stopwatch {
+public:
+    Stopwatch() : start_(chrono::steady_clock::now()) {}
+    void reset() { start_ = chrono::steady_clock::now(); }
+    double seconds() const {
+        return chrono::duration<double>(chrono::steady_clock::now() - start_).count();
+    }
+
+private:
+    chrono::steady_clock::time_point start_;
+};
+
+// Hardware cache-miss counter for the calling thread (perf_event_open).
+// valid() is false when the kernel or container doesn't expose PMU counters.
+class CacheMissCounter {
+public:
+    CacheMissCounter() {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+    ~CacheMissCounter() {
+        if (fd_ >= 0) close(fd_);
+    }
+    CacheMissCounter(const CacheMissCounter&) = delete;
+    CacheMissCounter& operator=(const CacheMissCounter&) = delete;
+
+    bool valid() const { return fd_ >= 0; }
+
+    void start() {
+        if (fd_ < 0) return;
+        ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+    }
+
+    // misses since start(), or -1 if unavailable
+    long long stop() {
+        if (fd_ < 0) return -1;
+        ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+        long long count = 0;
+        if (read(fd_, &count, sizeof(count)) != static_cast<ssize_t>(sizeof(count))) return -1;
+        return count;
+    }
+
+private:
+    int fd_ = -1;
+};
+
+// Deterministic random walk of 1m klines, same layout as data/BTCUSDT_1m.csv.
+// xorshift keeps it reproducible across runs and platforms.
+class SyntheticKlines {
+public:
+    explicit SyntheticKlines(uint64_t seed = 42, uint64_t start_ms = 1704067200000ULL, uint64_t step_ms = 60000)
+        : state_(seed ? seed : 1), timestamp_ms_(start_ms), step_ms_(step_ms), price_(42500.0) {}
+
+    Kline next(uint32_t symbol_id = 0) {
+        double open = price_;
+        double close = open + (static_cast<double>(rand_u64() % 20001) - 10000.0) / 100.0;
+        if (close < 1.0) close = 1.0;
+        double high = max(open, close) + static_cast<double>(rand_u64() % 5000) / 100.0;
+        double low = min(open, close) - static_cast<double>(rand_u64() % 5000) / 100.0;
+        double volume = static_cast<double>(rand_u64() % 1000000) / 100.0;
+        price_ = close;
+
+        Kline kline{timestamp_ms_, 0, symbol_id, open, high, low, close, volume};
+        timestamp_ms_ += step_ms_;
+        return kline;
+    }
+
+private:
+    uint64_t rand_u64() {
+        state_ ^= state_ << 13;
+        state_ ^= state_ >> 7;
+        state_ ^= state_ << 17;
+        return state_;
+    }
+
+    uint64_t state_;
+    uint64_t timestamp_ms_;
+    uint64_t step_ms_;
+    double price_;
+};
+
+// Deterministic aggTrades-like stream: cent prices, 1e-5 quantities, a few hundred
+// microseconds between prints. Values are exact decimals, so a CSV round trip is bit-exact.
+class SyntheticTicks {
+public:
+    explicit SyntheticTicks(uint64_t seed = 7, uint64_t start_us = 1704067200000000ULL)
+        : state_(seed ? seed : 1), timestamp_us_(start_us), cents_(4250000) {}
+
+    Tick next(uint32_t symbol_id = 0) {
+        uint64_t r = rand_u64();
+        timestamp_us_ += r % 600;
+        cents_ += static_cast<int64_t>((r >> 12) % 7) - 3;
+        if (cents_ < 100) cents_ = 100;
+        double quantity = static_cast<double>((r >> 24) % 200000 + 1) / 100000.0;
+        return Tick{timestamp_us_, static_cast<double>(cents_) / 100.0, quantity, symbol_id, ((r >> 48) & 1) != 0};
+    }
+
+private:
+    uint64_t rand_u64() {
+        state_ ^= state_ << 13;
+        state_ ^= state_ >> 7;
+        state_ ^= state_ << 17;
+        return state_;
+    }
+
+    uint64_t state_;
+    uint64_t timestamp_us_;
+    int64_t cents_;
+};
+
+// Writes `rows` synthetic klines as CSV (with header) and returns the file size in bytes.
+inline size_t write_synthetic_csv(const string& path, size_t rows, const string& symbol = "BTCUSDT",
+                                  uint64_t seed = 42) {
+    ofstream out(path);
+    if (!out.is_open()) {
+        throw runtime_error("Cannot create file: " + path);
+    }
+    out << "timestamp_ms,symbol,open,high,low,close,volume\n";
+
+    SyntheticKlines gen(seed);
+    char line[160];
+    for (size_t i = 0; i < rows; ++i) {
+        Kline k = gen.next();
+        int n = snprintf(line, sizeof(line), "%llu,%s,%.2f,%.2f,%.2f,%.2f,%.2f\n",
+                         static_cast<unsigned long long>(k.timestamp_ms), symbol.c_str(),
+                         k.open, k.high, k.low, k.close, k.volume);
+        out.write(line, n);
+    }
+    out.flush();
+    return static_cast<size_t>(out.tellp());
+}
@@ -0,0 +1,224 @@
+#pragma once
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <netinet/in.h>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "types.h"
+
+using namespace std;
+
+// Local stand-in for GET /api/v3/klines, so BinanceClient can be exercised offline.
+// Serves deterministic klines (see expected()) over plain HTTP/1.1 keep-alive on an
+// ephemeral 127.0.0.1 port, one thread per connection.
+//   latency     - sleep before every response, stands in for the network round trip
+//   fail_every  - every Nth request gets a 429 instead of data (0 = never)
+//   listed_from - no klines before this open time, like a symbol listed mid-range
+// Bars open on multiples of the interval, except weekly bars, which open on Monday 00:00 UTC
+// as on Binance (the epoch was a Thursday, so they sit 4 days off the multiples).
+class BinanceStandIn {
+public:
+    explicit BinanceStandIn(chrono::microseconds latency = chrono::microseconds(0), unsigned fail_every = 0,
+                            uint64_t listed_from = 0)
+        : latency_(latency), fail_every_(fail_every), listed_from_(listed_from) {
+        listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+        if (listen_fd_ < 0) throw runtime_error("stand-in: socket() failed");
+        int one = 1;
+        setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        socklen_t len = sizeof(addr);
+        if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+            listen(listen_fd_, 128) != 0 ||
+            getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+            close(listen_fd_);
+            throw runtime_error("stand-in: bind/listen failed");
+        }
+        port_ = ntohs(addr.sin_port);
+        acceptor_ = thread([this] { accept_loop(); });
+    }
+
+    ~BinanceStandIn() {
+        stop_ = true;
+        shutdown(listen_fd_, SHUT_RDWR);
+        acceptor_.join();
+        close(listen_fd_);
+        lock_guard<mutex> lock(mutex_);
+        for (int fd : client_fds_) shutdown(fd, SHUT_RDWR);
+        for (auto& worker : workers_) worker.join();
+        for (int fd : client_fds_) close(fd);
+    }
+
+    BinanceStandIn(const BinanceStandIn&) = delete;
+    BinanceStandIn& operator=(const BinanceStandIn&) = delete;
+
+    string base_url() const { return "http://127.0.0.1:" + to_string(port_); }
+    size_t requests() const { return requests_.load(); }
+    size_t connections() const { return connections_.load(); }
+
+    static constexpr uint64_t kWeekMs = 604800000;
+    static constexpr uint64_t kWeekPhaseMs = 4 * 86400000;
+
+    // open time of the first bar at or after t
+    static uint64_t first_open(uint64_t t, uint64_t step_ms) {
+        uint64_t phase = step_ms % kWeekMs == 0 ? kWeekPhaseMs % step_ms : 0;
+        if (t <= phase) return phase;
+        return phase + (t - phase + step_ms - 1) / step_ms * step_ms;
+    }
+
+    // the kline served for an open time (fetch_time_ms is left 0)
+    static Kline expected(uint64_t open_ms, uint64_t step_ms) {
+        uint64_t i = open_ms / step_ms;
+        double open = 40000.0 + static_cast<double>(i % 997);
+        double close = open + static_cast<double>(i % 7) - 3.0;
+        double volume = 1000.5 + static_cast<double>(i % 13);
+        return Kline{open_ms, 0, 0, open, open + 5.25, open - 5.25, close, volume};
+    }
+
+private:
+    chrono::microseconds latency_;
+    unsigned fail_every_;
+    uint64_t listed_from_;
+    int listen_fd_ = -1;
+    uint16_t port_ = 0;
+    atomic<bool> stop_{false};
+    atomic<size_t> requests_{0};
+    atomic<size_t> connections_{0};
+    thread acceptor_;
+    mutex mutex_;
+    vector<thread> workers_;
+    vector<int> client_fds_;
+
+    void accept_loop() {
+        while (!stop_) {
+            int fd = accept(listen_fd_, nullptr, nullptr);
+            if (fd < 0) continue;
+            lock_guard<mutex> lock(mutex_);
+            if (stop_) {
+                close(fd);
+                break;
+            }
+            ++connections_;
+            client_fds_.push_back(fd);
+            workers_.emplace_back([this, fd] {
+                serve(fd);
+                shutdown(fd, SHUT_RDWR);
+            });
+        }
+    }
+
+    static uint64_t param(string_view query, string_view key, uint64_t fallback) {
+        size_t pos = 0;
+        while (pos < query.size()) {
+            size_t amp = query.find('&', pos);
+            if (amp == string_view::npos) amp = query.size();
+            string_view pair = query.substr(pos, amp - pos);
+            if (pair.size() > key.size() && pair.substr(0, key.size()) == key && pair[key.size()] == '=') {
+                return stoull(string(pair.substr(key.size() + 1)));
+            }
+            pos = amp + 1;
+        }
+        return fallback;
+    }
+
+    static uint64_t step_of(string_view query) {
+        size_t pos = query.find("interval=");
+        if (pos == string_view::npos) return 60000;
+        string_view iv = query.substr(pos + 9, query.find('&', pos) - pos - 9);
+        uint64_t count = stoull(string(iv.substr(0, iv.size() - 1)));
+        switch (iv.back()) {
+            case 's': return count * 1000;
+            case 'm': return count * 60000;
+            case 'h': return count * 3600000;
+            case 'd': return count * 86400000;
+            default: return count * kWeekMs;
+        }
+    }
+
+    string klines_json(string_view query) const {
+        uint64_t step = step_of(query);
+        uint64_t limit = min<uint64_t>(param(query, "limit", 500), 1000);
+        uint64_t start = max(param(query, "startTime", 0), listed_from_);
+        uint64_t end = param(query, "endTime", UINT64_MAX);
+        uint64_t t = first_open(start, step);
+
+        string body = "[";
+        char row[320];
+        for (uint64_t n = 0; n < limit && t <= end; ++n, t += step) {
+            Kline k = expected(t, step);
+            int len = snprintf(row, sizeof(row),
+                               "%s[%llu,\"%.8f\",\"%.8f\",\"%.8f\",\"%.8f\",\"%.8f\",%llu,\"%.8f\",%d,\"%.8f\",\"%.8f\",\"0\"]",
+                               n ? "," : "", static_cast<unsigned long long>(t), k.open, k.high, k.low, k.close,
+                               k.volume / k.close, static_cast<unsigned long long>(t + step - 1), k.volume, 100,
+                               k.volume / k.close / 2, k.volume / 2);
+            body.append(row, static_cast<size_t>(len));
+        }
+        body += "]";
+        return body;
+    }
+
+    static bool send_all(int fd, const string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) return false;
+            sent += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    void serve(int fd) {
+        string buffer;
+        char chunk[4096];
+        while (!stop_) {
+            size_t header_end = buffer.find("\r\n\r\n");
+            if (header_end == string::npos) {
+                ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) return;
+                buffer.append(chunk, static_cast<size_t>(n));
+                continue;
+            }
+            string request = buffer.substr(0, header_end);
+            buffer.erase(0, header_end + 4);
+
+            // "GET /api/v3/klines?symbol=...&interval=... HTTP/1.1"
+            size_t path_begin = request.find(' ') + 1;
+            size_t path_end = request.find(' ', path_begin);
+            string_view target = string_view(request).substr(path_begin, path_end - path_begin);
+            size_t q = target.find('?');
+            string_view path = target.substr(0, q);
+            string_view query = q == string_view::npos ? string_view() : target.substr(q + 1);
+            bool keep_alive = request.find("Connection: close") == string::npos;
+
+            size_t seq = ++requests_;
+            if (latency_.count() > 0) this_thread::sleep_for(latency_);
+
+            string status = "200 OK", body;
+            if (path != "/api/v3/klines") {
+                status = "404 Not Found";
+                body = "{\"code\":-1,\"msg\":\"not found\"}";
+            } else if (fail_every_ && seq % fail_every_ == 0) {
+                status = "429 Too Many Requests";
+                body = "{\"code\":-1003,\"msg\":\"Too many requests\"}";
+            } else {
+                body = klines_json(query);
+            }
+            string response = "HTTP/1.1 " + status + "\r\nContent-Type: application/json\r\nContent-Length: " +
+                               to_string(body.size()) + (keep_alive ? "\r\n\r\n" : "\r\nConnection: close\r\n\r\n") + body;
+            if (!send_all(fd, response) || !keep_alive) return;
+        }
+    }
+};
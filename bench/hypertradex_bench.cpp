@@ -0,0 +1,358 @@
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <vector>
+#include "backtest.h"
+#include "bench_util.h"
+#include "data_loader.h"
+#include "executor.h"
+#include "mapped_file.h"
+#include "metrics.h"
+#include "parser.h"
+#include "replay_engine.h"
+#include "strategy.h"
+
+using namespace std;
+
+// One benchmark suite over the whole pipeline: DataLoader, Parser, ReplayEngine, Strategy,
+// Executor, Metrics and an end-to-end backtest, all on deterministic synthetic bars.
+// Results go to JSON; given a saved baseline, any benchmark slower than baseline * (1 + threshold)
+// is flagged and the exit code is 1.
+//
+// usage: hypertradex_bench [--bars N] [--e2e-bars N] [--seed S] [--reps R] [--filter SUBSTR]
+//                          [--json out.json] [--baseline base.json] [--threshold 0.10]
+//
+// --e2e-bars can go to 1B and beyond: the end-to-end run generates bars in fixed-size chunks
+// and replays each one through the same Strategy/Executor/Metrics, so memory stays constant.
+
+namespace {
+
+volatile double g_sink = 0.0;   // keeps the measured loops from being optimised away
+
+struct BenchResult
+{
+    string name;
+    uint64_t ops;
+    double ns_per_op;       // median over the repetitions
+    double min_ns_per_op;
+};
+
+struct Options
+{
+    uint64_t bars = 1000000;
+    uint64_t e2e_bars = 0;   // 0 = same as bars
+    uint64_t seed = 42;
+    int reps = 5;
+    string filter;
+    string json_path;
+    string baseline_path;
+    double threshold = 0.10;
+};
+
+class Suite
+{
+public:
+    Suite(int reps, string filter) : reps_(max(reps, 1)), filter_(std::move(filter)) {}
+
+    // body() performs `ops` operations once
+    template <typename Body>
+    void run(const string& name, uint64_t ops, Body body)
+    {
+        if (!filter_.empty() && name.find(filter_) == string::npos) return;
+        vector<double> samples;
+        for (int r = 0; r < reps_; ++r) {
+            Stopwatch sw;
+            body();
+            samples.push_back(sw.seconds() * 1e9 / static_cast<double>(ops));
+        }
+        sort(samples.begin(), samples.end());
+        record(BenchResult{name, ops, samples[samples.size() / 2], samples.front()});
+    }
+
+    void record(const BenchResult& result)
+    {
+        results_.push_back(result);
+        cout << left << setw(28) << result.name << right << setw(14) << result.ops << setw(12) << result.ns_per_op
+             << setw(12) << result.min_ns_per_op << setw(14) << 1e3 / result.ns_per_op << endl;
+    }
+
+    bool wants(const string& name) const { return filter_.empty() || name.find(filter_) != string::npos; }
+    const vector<BenchResult>& results() const { return results_; }
+
+private:
+    int reps_;
+    string filter_;
+    vector<BenchResult> results_;
+};
+
+vector<Kline> generate(uint64_t count, uint64_t seed)
+{
+    SyntheticKlines gen(seed);
+    vector<Kline> klines;
+    klines.reserve(count);
+    for (uint64_t i = 0; i < count; ++i) klines.push_back(gen.next());
+    return klines;
+}
+
+void write_json(const string& path, const Options& options, const vector<BenchResult>& results)
+{
+    ofstream out(path);
+    if (!out.is_open()) {
+        throw runtime_error("Cannot create file: " + path);
+    }
+    out << "{\n  \"suite\": \"hypertradex_bench\",\n  \"bars\": " << options.bars << ",\n  \"e2e_bars\": "
+        << options.e2e_bars << ",\n  \"seed\": " << options.seed << ",\n  \"results\": [\n";
+    out << setprecision(17);
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        out << "    {\"name\": \"" << r.name << "\", \"ops\": " << r.ops << ", \"ns_per_op\": " << r.ns_per_op
+            << ", \"min_ns_per_op\": " << r.min_ns_per_op << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+// Reads back what write_json wrote: name -> median ns/op. Not a general JSON parser.
+map<string, double> read_baseline(const string& path)
+{
+    ifstream in(path);
+    if (!in.is_open()) {
+        throw runtime_error("Cannot open baseline: " + path);
+    }
+    stringstream buffer;
+    buffer << in.rdbuf();
+    string text = buffer.str();
+
+    map<string, double> baseline;
+    const string name_key = "\"name\": \"";
+    const string value_key = "\"ns_per_op\": ";
+    for (size_t pos = text.find(name_key); pos != string::npos; pos = text.find(name_key, pos)) {
+        pos += name_key.size();
+        size_t name_end = text.find('"', pos);
+        size_t value = text.find(value_key, name_end);
+        if (name_end == string::npos || value == string::npos) {
+            throw runtime_error("Malformed baseline: " + path);
+        }
+        baseline[text.substr(pos, name_end - pos)] = stod(text.substr(value + value_key.size()));
+        pos = value;
+    }
+    return baseline;
+}
+
+// prints the comparison, returns the number of regressions
+int compare(const vector<BenchResult>& results, const map<string, double>& baseline, double threshold)
+{
+    int regressions = 0;
+    cout << "\n" << left << setw(28) << "vs baseline" << right << setw(12) << "base ns/op" << setw(12) << "now ns/op"
+         << setw(10) << "change" << endl;
+    for (const auto& r : results) {
+        auto it = baseline.find(r.name);
+        if (it == baseline.end()) {
+            cout << left << setw(28) << r.name << right << setw(34) << "(new)" << endl;
+            continue;
+        }
+        double change = r.ns_per_op / it->second - 1.0;
+        bool regressed = change > threshold;
+        regressions += regressed;
+        cout << left << setw(28) << r.name << right << setw(12) << it->second << setw(12) << r.ns_per_op << setw(9)
+             << change * 100.0 << "%" << (regressed ? "  REGRESSION" : "") << endl;
+    }
+    return regressions;
+}
+
+optional<Options> parse_options(int argc, char* argv[])
+{
+    Options o;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--bars" && has_value) o.bars = stoull(argv[++i]);
+        else if (arg == "--e2e-bars" && has_value) o.e2e_bars = stoull(argv[++i]);
+        else if (arg == "--seed" && has_value) o.seed = stoull(argv[++i]);
+        else if (arg == "--reps" && has_value) o.reps = stoi(argv[++i]);
+        else if (arg == "--filter" && has_value) o.filter = argv[++i];
+        else if (arg == "--json" && has_value) o.json_path = argv[++i];
+        else if (arg == "--baseline" && has_value) o.baseline_path = argv[++i];
+        else if (arg == "--threshold" && has_value) o.threshold = stod(argv[++i]);
+        else return nullopt;
+    }
+    if (o.e2e_bars == 0) o.e2e_bars = o.bars;
+    return o;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    optional<Options> parsed = parse_options(argc, argv);
+    if (!parsed || parsed->bars == 0) {
+        cerr << "usage: hypertradex_bench [--bars N] [--e2e-bars N] [--seed S] [--reps R] [--filter SUBSTR]\n"
+             << "                         [--json out.json] [--baseline base.json] [--threshold 0.10]" << endl;
+        return 1;
+    }
+    const Options& options = *parsed;
+
+    try {
+        const uint64_t capital = 1000000;
+        const uint64_t hold_ms = 5 * 60000;
+        Suite suite(options.reps, options.filter);
+        cout << fixed << setprecision(2);
+        cout << "hypertradex_bench: " << options.bars << " bars, seed " << options.seed << ", " << options.reps
+             << " reps (median)\n\n";
+        cout << left << setw(28) << "benchmark" << right << setw(14) << "ops" << setw(12) << "ns/op" << setw(12)
+             << "min ns/op" << setw(14) << "M ops/s" << endl;
+
+        vector<Kline> klines = generate(options.bars, options.seed);
+
+        // ---- DataLoader / Parser on a CSV of the same bars
+        string csv_path = "/tmp/hypertradex_bench_suite.csv";
+        struct RemoveOnExit
+        {
+            const string& path;
+            ~RemoveOnExit()
+            {
+                error_code ec;
+                filesystem::remove(path, ec);
+            }
+        } csv_cleanup{csv_path};
+        if (suite.wants("loader") || suite.wants("parser")) {
+            write_synthetic_csv(csv_path, options.bars, "BTCUSDT", options.seed);
+        }
+        suite.run("loader.load_klines", options.bars, [&] {
+            vector<Kline> loaded = DataLoader::load_klines(csv_path);
+            g_sink = g_sink + static_cast<double>(loaded.size());
+        });
+        suite.run("loader.load_columns", options.bars, [&] {
+            KlineColumns columns = DataLoader::load_columns(csv_path);
+            g_sink = g_sink + static_cast<double>(columns.size());
+        });
+        if (suite.wants("parser")) {
+            MappedFile file(csv_path);
+            string_view data = file.view();
+            vector<string_view> lines;
+            lines.reserve(options.bars);
+            for (size_t pos = data.find('\n') + 1; pos < data.size();) {
+                size_t end = data.find('\n', pos);
+                if (end == string_view::npos) end = data.size();
+                lines.push_back(data.substr(pos, end - pos));
+                pos = end + 1;
+            }
+            suite.run("parser.parse_kline", lines.size(), [&] {
+                double sum = 0.0;
+                for (auto line : lines) sum += Parser::parse_kline(line).close;
+                g_sink = g_sink + sum;
+            });
+            suite.run("parser.parse_klines_batch", lines.size(), [&] {
+                KlineColumns columns = Parser::parse_klines(span<const char>(data.data(), data.size()));
+                g_sink = g_sink + static_cast<double>(columns.size());
+            });
+        }
+
+        // ---- replay and the per-bar stages in isolation
+        suite.run("replay.klines", options.bars, [&] {
+            double sum = 0.0;
+            ReplayEngine engine(klines);
+            engine.replay([&](const Kline& k) { sum += k.close; });
+            g_sink = g_sink + sum;
+        });
+
+        vector<Decision> decisions;
+        if (suite.wants("executor")) {
+            Strategy strategy(hold_ms);
+            decisions.reserve(klines.size());
+            for (const auto& k : klines) decisions.push_back(strategy.on_kline(k));
+        }
+        suite.run("strategy.on_kline", options.bars, [&] {
+            Strategy strategy(hold_ms);
+            uint64_t trades = 0;
+            for (const auto& k : klines) trades += strategy.on_kline(k).should_trade;
+            g_sink = g_sink + static_cast<double>(trades);
+        });
+        suite.run("executor.on_kline", options.bars, [&] {
+            Executor executor(capital);
+            double pnl = 0.0;
+            for (size_t i = 0; i < klines.size(); ++i) {
+                auto trade = executor.on_kline(klines[i], decisions[i]);
+                if (trade) pnl += trade->pnl;
+            }
+            g_sink = g_sink + pnl;
+        });
+
+        if (suite.wants("metrics")) {
+            vector<Trade> trades;
+            {
+                Strategy strategy(hold_ms);
+                Executor executor(capital);
+                ReplayEngine engine(klines);
+                run_backtest(engine, strategy, executor, [&](const Trade& t) { trades.push_back(t); });
+            }
+            suite.run("metrics.on_trade", trades.size(), [&] {
+                Metrics metrics(capital);
+                for (const auto& t : trades) metrics.on_trade(t);
+                g_sink = g_sink + metrics.snapshot().total_pnl;
+            });
+            suite.run("metrics.calculate", trades.size(), [&] {
+                Metrics metrics(capital);
+                g_sink = g_sink + metrics.calculate(trades).total_pnl;
+            });
+        }
+        klines.clear();
+        klines.shrink_to_fit();
+
+        // ---- end to end, streamed in chunks so the bar count is not bounded by memory
+        if (suite.wants("e2e")) {
+            constexpr uint64_t kChunk = 1 << 20;
+            vector<double> samples;
+            Statistics stats{};
+            vector<Kline> chunk;
+            chunk.reserve(kChunk);
+            for (int r = 0; r < max(options.reps, 1); ++r) {
+                SyntheticKlines gen(options.seed);
+                Strategy strategy(hold_ms);
+                Executor executor(capital);
+                Metrics metrics(capital);
+                double seconds = 0.0;
+                for (uint64_t done = 0; done < options.e2e_bars; done += chunk.size()) {
+                    chunk.clear();
+                    uint64_t n = min(kChunk, options.e2e_bars - done);
+                    for (uint64_t i = 0; i < n; ++i) chunk.push_back(gen.next());
+
+                    Stopwatch sw;
+                    ReplayEngine engine(chunk);
+                    run_backtest(engine, strategy, executor, [&](const Trade& t) { metrics.on_trade(t); });
+                    seconds += sw.seconds();
+                }
+                stats = metrics.snapshot();
+                samples.push_back(seconds * 1e9 / static_cast<double>(options.e2e_bars));
+            }
+            sort(samples.begin(), samples.end());
+            suite.record(BenchResult{"e2e.backtest", options.e2e_bars, samples[samples.size() / 2], samples.front()});
+            g_sink = g_sink + stats.total_pnl;
+        }
+
+        if (!options.json_path.empty()) {
+            write_json(options.json_path, options, suite.results());
+            cout << "\nresults written to " << options.json_path << endl;
+        }
+        if (!options.baseline_path.empty()) {
+            int regressions = compare(suite.results(), read_baseline(options.baseline_path), options.threshold);
+            if (regressions > 0) {
+                cerr << "\n" << regressions << " benchmark(s) regressed by more than " << options.threshold * 100.0
+                     << "%" << endl;
+                return 1;
+            }
+            cout << "\nno regressions beyond " << options.threshold * 100.0 << "%" << endl;
+        }
+        return 0;
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+}
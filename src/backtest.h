@@ -0,0 +1,27 @@
+#pragma once
+
+#include <concepts>
+#include "executor.h"
+#include "replay_engine.h"
+#include "strategy.h"
+#include "strategy_concept.h"
+#include "types.h"
+
+using namespace std;
+
+static_assert(StrategyConcept<Strategy>);
+
+// The single-symbol backtest loop: strategy -> executor -> on_trade for every bar.
+// Templated on the concrete strategy, so a ComposedStrategy's blocks inline straight
+// into the replay loop; there is no strategy base class and no virtual call per bar.
+template <StrategyConcept S, typename OnTrade>
+    requires invocable<OnTrade&, const Trade&>
+void run_backtest(ReplayEngine& engine, S& strategy, Executor& executor, OnTrade&& on_trade)
+{
+    engine.replay([&](const Kline& kline) {
+        auto result = executor.on_kline(kline, strategy.on_kline(kline));
+        if (result.has_value()) {
+            on_trade(result.value());
+        }
+    });
+}
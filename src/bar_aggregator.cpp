@@ -0,0 +1,26 @@
+#include "bar_aggregator.h"
+#include <stdexcept>
+using namespace std;
+
+BarAggregator::BarAggregator(const BarSpec& spec)
+    : spec_(spec), interval_ms_(static_cast<uint64_t>(spec.size))
+{
+    if (!(spec.size > 0.0)) {
+        throw runtime_error("Bar size must be positive");
+    }
+    if (spec.kind == BarKind::Time && interval_ms_ == 0) {
+        throw runtime_error("Time bars need an interval of at least 1 ms");
+    }
+}
+
+vector<Kline> BarAggregator::aggregate(span<const Tick> ticks, const BarSpec& spec)
+{
+    BarAggregator aggregator(spec);
+    vector<Kline> bars;
+    auto emit = [&](const Kline& bar) { bars.push_back(bar); };
+    for (const auto& tick : ticks) {
+        aggregator.on_tick(tick, emit);
+    }
+    aggregator.flush(emit);
+    return bars;
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "types.h"
+
+using namespace std;
+
+enum class BarKind : uint8_t
+{
+    Time,     // fixed wall-clock buckets, `size` in milliseconds
+    Volume,   // closes once traded quantity reaches `size`
+    Dollar    // closes once traded notional (price * quantity) reaches `size`
+};
+
+struct BarSpec
+{
+    BarKind kind;
+    double size;
+
+    static BarSpec time(uint64_t interval_ms) { return BarSpec{BarKind::Time, static_cast<double>(interval_ms)}; }
+    static BarSpec volume(double quantity) { return BarSpec{BarKind::Volume, quantity}; }
+    static BarSpec dollar(double notional) { return BarSpec{BarKind::Dollar, notional}; }
+};
+
+/* --- Ticks -> Klines on the fly.
+Time bars are stamped with their bucket start and empty buckets produce no bar. Volume and
+dollar bars are stamped with their first tick and close on the tick that reaches the
+threshold; that tick is not split, so a bar may overshoot by one print. Bars are emitted
+through a callback as soon as they close; flush() emits the partial last one. One
+aggregator per symbol: the bar takes the symbol of its ticks. */
+class BarAggregator
+{
+public:
+    explicit BarAggregator(const BarSpec& spec);
+
+    template <typename Emit>
+    void on_tick(const Tick& tick, Emit&& emit);
+
+    template <typename Emit>
+    void flush(Emit&& emit);
+
+    bool has_open_bar() const { return open_; }
+
+    // whole stream at once, partial last bar included
+    static vector<Kline> aggregate(span<const Tick> ticks, const BarSpec& spec);
+
+private:
+    void start(const Tick& tick, uint64_t timestamp_ms);
+
+    BarSpec spec_;
+    uint64_t interval_ms_;
+    uint64_t bar_end_ms_ = 0;   // time bars: first timestamp past the open bucket
+    double progress_ = 0.0;     // volume / dollar bars: traded so far
+    Kline bar_{};
+    bool open_ = false;
+};
+
+inline void BarAggregator::start(const Tick& tick, uint64_t timestamp_ms)
+{
+    uint64_t bar_start = timestamp_ms;
+    if (spec_.kind == BarKind::Time) {
+        bar_start = timestamp_ms - timestamp_ms % interval_ms_;
+        bar_end_ms_ = bar_start + interval_ms_;
+    }
+    bar_ = Kline{bar_start, 0, tick.symbol_id, tick.price, tick.price, tick.price, tick.price, tick.quantity};
+    progress_ = 0.0;
+    open_ = true;
+}
+
+template <typename Emit>
+void BarAggregator::on_tick(const Tick& tick, Emit&& emit)
+{
+    uint64_t timestamp_ms = tick.timestamp_us / 1000;
+    if (open_ && spec_.kind == BarKind::Time && timestamp_ms >= bar_end_ms_) {
+        open_ = false;
+        emit(static_cast<const Kline&>(bar_));
+    }
+
+    if (!open_) {
+        start(tick, timestamp_ms);
+    } else {
+        bar_.high = tick.price > bar_.high ? tick.price : bar_.high;
+        bar_.low = tick.price < bar_.low ? tick.price : bar_.low;
+        bar_.close = tick.price;
+        bar_.volume += tick.quantity;
+    }
+
+    if (spec_.kind != BarKind::Time) {
+        progress_ += spec_.kind == BarKind::Volume ? tick.quantity : tick.price * tick.quantity;
+        if (progress_ >= spec_.size) {
+            open_ = false;
+            emit(static_cast<const Kline&>(bar_));
+        }
+    }
+}
+
+template <typename Emit>
+void BarAggregator::flush(Emit&& emit)
+{
+    if (open_) {
+        open_ = false;
+        emit(static_cast<const Kline&>(bar_));
+    }
+}
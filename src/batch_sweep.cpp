@@ -0,0 +1,231 @@
+#include "batch_sweep.h"
+#include "metrics.h"
+#include "simd_dispatch.h"
+#include "thread_pool.h"
+#include <chrono>
+#include <cstdint>
+#include <immintrin.h>
+using namespace std;
+
+namespace {
+
+constexpr size_t kLanes = BatchSweep::kBatchLanes;
+
+// Strategy + Executor state of every lane; unused lanes hold forever and never trade
+struct LaneState
+{
+    uint64_t hold_ms[kLanes];
+    uint64_t entry_time_ms[kLanes];
+    double entry_price[kLanes];
+    bool has_position[kLanes];
+    PnlStats stats[kLanes];
+};
+
+void run_lanes_scalar(span<const uint64_t> timestamp_ms, span<const double> close, LaneState& s)
+{
+    for (size_t i = 0; i < timestamp_ms.size(); ++i) {
+        uint64_t ts = timestamp_ms[i];
+        double price = close[i];
+        for (size_t l = 0; l < kLanes; ++l) {
+            if (!s.has_position[l]) {
+                s.entry_time_ms[l] = ts;
+                s.entry_price[l] = price;
+                s.has_position[l] = true;
+            } else if (ts - s.entry_time_ms[l] >= s.hold_ms[l]) {
+                s.stats[l].add(price - s.entry_price[l]);
+                s.has_position[l] = false;
+            }
+        }
+    }
+}
+
+// Four lanes of LaneState as registers. Masks are all-ones / all-zero per 64-bit lane.
+struct Avx2Lanes
+{
+    __m256i hold;           // biased by 2^63 so signed compares order like unsigned
+    __m256i entry_time;
+    __m256d entry_price;
+    __m256i position;
+    __m256i trades, wins;
+    __m256d total, balance, peak, drawdown, largest_win, largest_loss;
+};
+
+__attribute__((target("avx2")))
+inline __m256i unsigned_bias(__m256i v)
+{
+    return _mm256_xor_si256(v, _mm256_set1_epi64x(static_cast<long long>(1ULL << 63)));
+}
+
+__attribute__((target("avx2")))
+Avx2Lanes load_lanes(const LaneState& s, size_t first)
+{
+    auto ints = [&](const uint64_t* column) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(column + first));
+    };
+    auto stat = [&](double PnlStats::*field) {
+        return _mm256_setr_pd(s.stats[first].*field, s.stats[first + 1].*field, s.stats[first + 2].*field,
+                              s.stats[first + 3].*field);
+    };
+    auto count = [&](uint64_t PnlStats::*field) {
+        return _mm256_setr_epi64x(static_cast<long long>(s.stats[first].*field),
+                                  static_cast<long long>(s.stats[first + 1].*field),
+                                  static_cast<long long>(s.stats[first + 2].*field),
+                                  static_cast<long long>(s.stats[first + 3].*field));
+    };
+
+    Avx2Lanes v;
+    v.hold = unsigned_bias(ints(s.hold_ms));
+    v.entry_time = ints(s.entry_time_ms);
+    v.entry_price = _mm256_loadu_pd(s.entry_price + first);
+    v.position = _mm256_setr_epi64x(-s.has_position[first], -s.has_position[first + 1],
+                                    -s.has_position[first + 2], -s.has_position[first + 3]);
+    v.trades = count(&PnlStats::trades);
+    v.wins = count(&PnlStats::wins);
+    v.total = stat(&PnlStats::total_pnl);
+    v.balance = stat(&PnlStats::balance);
+    v.peak = stat(&PnlStats::peak_balance);
+    v.drawdown = stat(&PnlStats::max_drawdown);
+    v.largest_win = stat(&PnlStats::largest_win);
+    v.largest_loss = stat(&PnlStats::largest_loss);
+    return v;
+}
+
+__attribute__((target("avx2")))
+void store_lanes(const Avx2Lanes& v, LaneState& s, size_t first)
+{
+    alignas(32) uint64_t ints[4];
+    alignas(32) double doubles[4];
+    auto ints_out = [&](__m256i x) { _mm256_store_si256(reinterpret_cast<__m256i*>(ints), x); };
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(s.entry_time_ms + first), v.entry_time);
+    _mm256_storeu_pd(s.entry_price + first, v.entry_price);
+    ints_out(v.position);
+    for (size_t l = 0; l < 4; ++l) s.has_position[first + l] = ints[l] != 0;
+    ints_out(v.trades);
+    for (size_t l = 0; l < 4; ++l) s.stats[first + l].trades = ints[l];
+    ints_out(v.wins);
+    for (size_t l = 0; l < 4; ++l) s.stats[first + l].wins = ints[l];
+
+    auto doubles_out = [&](__m256d x, double PnlStats::*field) {
+        _mm256_store_pd(doubles, x);
+        for (size_t l = 0; l < 4; ++l) s.stats[first + l].*field = doubles[l];
+    };
+    doubles_out(v.total, &PnlStats::total_pnl);
+    doubles_out(v.balance, &PnlStats::balance);
+    doubles_out(v.peak, &PnlStats::peak_balance);
+    doubles_out(v.drawdown, &PnlStats::max_drawdown);
+    doubles_out(v.largest_win, &PnlStats::largest_win);
+    doubles_out(v.largest_loss, &PnlStats::largest_loss);
+}
+
+// One bar for four lanes: the scalar branch structure as masks. Entering and exiting
+// lanes are disjoint (both are decided on the state before the bar).
+__attribute__((target("avx2"), always_inline))
+inline void step_lanes(Avx2Lanes& v, __m256i ts, __m256d price)
+{
+    const __m256i ones = _mm256_set1_epi64x(-1);
+    __m256i held = unsigned_bias(_mm256_sub_epi64(ts, v.entry_time));
+    __m256i not_due = _mm256_cmpgt_epi64(v.hold, held);
+    __m256i exit = _mm256_andnot_si256(not_due, v.position);
+    __m256i enter = _mm256_andnot_si256(v.position, ones);
+
+    if (!_mm256_testz_si256(exit, exit)) {
+        __m256d mask = _mm256_castsi256_pd(exit);
+        __m256d pnl = _mm256_sub_pd(price, v.entry_price);
+        __m256i won = _mm256_castpd_si256(_mm256_cmp_pd(pnl, _mm256_setzero_pd(), _CMP_GT_OQ));
+
+        v.trades = _mm256_sub_epi64(v.trades, exit);
+        v.wins = _mm256_sub_epi64(v.wins, _mm256_and_si256(won, exit));
+        v.total = _mm256_blendv_pd(v.total, _mm256_add_pd(v.total, pnl), mask);
+        __m256d balance = _mm256_add_pd(v.balance, pnl);
+        v.balance = _mm256_blendv_pd(v.balance, balance, mask);
+        // operand order keeps std::max / std::min semantics on ties
+        v.largest_win = _mm256_blendv_pd(v.largest_win, _mm256_max_pd(pnl, v.largest_win), mask);
+        v.largest_loss = _mm256_blendv_pd(v.largest_loss, _mm256_min_pd(pnl, v.largest_loss), mask);
+        __m256d peak = _mm256_max_pd(balance, v.peak);
+        v.peak = _mm256_blendv_pd(v.peak, peak, mask);
+        __m256d drawdown = _mm256_max_pd(_mm256_sub_pd(peak, balance), v.drawdown);
+        v.drawdown = _mm256_blendv_pd(v.drawdown, drawdown, mask);
+    }
+
+    v.entry_time = _mm256_blendv_epi8(v.entry_time, ts, enter);
+    v.entry_price = _mm256_blendv_pd(v.entry_price, price, _mm256_castsi256_pd(enter));
+    v.position = _mm256_or_si256(_mm256_andnot_si256(exit, v.position), enter);
+}
+
+__attribute__((target("avx2")))
+void run_lanes_avx2(span<const uint64_t> timestamp_ms, span<const double> close, LaneState& s)
+{
+    static_assert(kLanes == 8, "the AVX2 kernel runs two 4-wide halves");
+    Avx2Lanes lo = load_lanes(s, 0);
+    Avx2Lanes hi = load_lanes(s, 4);
+    for (size_t i = 0; i < timestamp_ms.size(); ++i) {
+        __m256i ts = _mm256_set1_epi64x(static_cast<long long>(timestamp_ms[i]));
+        __m256d price = _mm256_set1_pd(close[i]);
+        step_lanes(lo, ts, price);
+        step_lanes(hi, ts, price);
+    }
+    store_lanes(lo, s, 0);
+    store_lanes(hi, s, 4);
+}
+
+Statistics to_statistics(const PnlStats& pnl)
+{
+    if (pnl.trades == 0) {
+        return Statistics{0, 0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    }
+    return Statistics{
+        pnl.trades,
+        pnl.wins,
+        pnl.total_pnl,
+        (static_cast<double>(pnl.wins) / static_cast<double>(pnl.trades)) * 100.0,
+        pnl.max_drawdown,
+        pnl.largest_win,
+        pnl.largest_loss,
+        0.0,
+        0.0,
+        0.0,
+        0.0
+    };
+}
+
+}
+
+BatchSweep::BatchSweep(const KlineSeries& series, uint64_t initial_capital, unsigned threads)
+    : series_(series), initial_capital_(initial_capital), threads_(threads) {}
+
+vector<SweepResult> BatchSweep::run(const vector<SweepPoint>& grid) const
+{
+    vector<SweepResult> results(grid.size());
+    size_t batches = (grid.size() + kLanes - 1) / kLanes;
+    run_parallel(threads_, batches, [&](size_t b) {
+        size_t first = b * kLanes;
+        run_batch(grid.data() + first, min(kLanes, grid.size() - first), results.data() + first);
+    });
+    return results;
+}
+
+void BatchSweep::run_batch(const SweepPoint* points, size_t lanes, SweepResult* out) const
+{
+    auto start = chrono::steady_clock::now();
+
+    LaneState state;
+    for (size_t l = 0; l < kLanes; ++l) {
+        state.hold_ms[l] = l < lanes ? points[l].hold_duration_ms : UINT64_MAX;
+        state.entry_time_ms[l] = 0;
+        state.entry_price[l] = 0.0;
+        state.has_position[l] = false;
+        state.stats[l].reset(static_cast<double>(initial_capital_));
+    }
+
+    if (use_avx2()) {
+        run_lanes_avx2(series_.timestamp_ms(), series_.close(), state);
+    } else {
+        run_lanes_scalar(series_.timestamp_ms(), series_.close(), state);
+    }
+
+    double per_lane = chrono::duration<double>(chrono::steady_clock::now() - start).count() / static_cast<double>(lanes);
+    for (size_t l = 0; l < lanes; ++l) {
+        out[l] = SweepResult{points[l], to_statistics(state.stats[l]), per_lane};
+    }
+}
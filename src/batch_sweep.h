@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "kline_series.h"
+#include "sweep_runner.h"
+
+using namespace std;
+
+/* --- Lane-batched parameter sweep.
+Runs kBatchLanes Strategy variants (one hold_duration_ms each) side by side in one pass
+over the timestamp and close columns, instead of one ReplayEngine replay per grid point.
+Per-lane position, entry and PnlStats state sits in AVX2 registers (two 4-wide halves);
+a lane that exits on a bar updates its stats under a blend mask. The rules are the
+default Strategy + Executor (market fills at the close, quantity 1, no costs), and every
+lane applies the same IEEE operations in the same order as PnlStats::add, so results
+match SweepRunner::run_point bit for bit. Replayed bars have no fetch stamps: the latency
+fields are 0, as they are there. Batches run on the thread pool like SweepRunner runs. */
+class BatchSweep
+{
+public:
+    static constexpr size_t kBatchLanes = 8;
+
+    BatchSweep(const KlineSeries& series, uint64_t initial_capital, unsigned threads = 0);
+
+    // results in grid order; run_seconds is the batch time split evenly over its lanes
+    vector<SweepResult> run(const vector<SweepPoint>& grid) const;
+
+private:
+    void run_batch(const SweepPoint* points, size_t lanes, SweepResult* out) const;
+
+    const KlineSeries& series_;
+    uint64_t initial_capital_;
+    unsigned threads_;
+};
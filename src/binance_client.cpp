@@ -1,11 +1,14 @@
 #include "binance_client.h"
+#include "kline_json_decoder.h"
+#include "timing.h"
 #include <iostream>
-#include <nlohmann/json.hpp>
 #include <curl/curl.h>
+#include <algorithm>
+#include <cctype>
 #include <chrono>
+#include <deque>
 
 using namespace std;
-using json = nlohmann::json;
 
 static size_t write_callback(void* contents, size_t size, size_t nmemb, string* userp)
 {
@@ -17,14 +20,74 @@ static size_t write_callback(void* contents, size_t size, size_t nmemb, string*
     return size*nmemb;
 }
 
-string BinanceClient::make_request(const string& endpoint, const string& query_string)
+namespace {
+
+// options shared by every handle we hand to curl
+void configure_handle(CURL* curl)
+{
+    // 10L -> 10 sec ( l => long integer) Wait max 10 seconds
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 10L);
+    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
+    // keep idle connections alive between requests
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    // gzip/deflate, kline pages compress ~4x
+    curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, "");
+    // over HTTP/2 wait for an existing connection to multiplex on instead of opening another
+    curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L);
+}
+
+CURL* new_handle()
 {
-    // initilaise curl
     CURL* curl = curl_easy_init();
     if(!curl)
     {
         throw::runtime_error("Failed to initialise CURL");
     }
+    configure_handle(curl);
+    return curl;
+}
+
+// rate limited (429, 418 once Binance has banned the IP for ignoring 429s) or a
+// server hiccup, worth another try
+bool retryable_status(long http_code)
+{
+    return http_code == 429 || http_code == 418 || http_code >= 500;
+}
+
+// one page of a range fetch: open times in [start_ms, end_ms)
+struct PageRequest {
+    uint64_t start_ms;
+    uint64_t end_ms;
+    int attempts = 0;
+    bool receiving = false;
+    KlineJsonDecoder decoder;
+};
+
+// range fetch pages decode while the bytes arrive, no response body is kept
+size_t page_write_callback(void* contents, size_t size, size_t nmemb, PageRequest* page)
+{
+    if(!page->receiving)
+    {
+        // same wall-clock stamp parse_klines_json uses, taken at the first byte
+        page->decoder.reset(wall_clock_us());
+        page->receiving = true;
+    }
+    // a malformed page is reported after the transfer, so always take the bytes
+    page->decoder.feed(static_cast<const char*>(contents), size * nmemb);
+    return size * nmemb;
+}
+
+}
+
+string BinanceClient::make_request(const string& endpoint, const string& query_string)
+{
+    // one handle for the client's lifetime, so the TCP+TLS connection is reused
+    if(!handle_)
+    {
+        handle_ = new_handle();
+    }
+    CURL* curl = handle_;
 
     string url = api_base + endpoint+ query_string;
 
@@ -39,30 +102,17 @@ string BinanceClient::make_request(const string& endpoint, const string& query_s
     url.c_str()            // Value: the URL (converting into C string)
     );
 
-    // set timeout
-    // 10L -> 10 sec ( l => long integer) Wait max 10 seconds
-    curl_easy_setopt (curl, CURLOPT_TIMEOUT, 10L); 
-
-
-    // follow redirects
-    // 1 = true, 0 = false
-    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
-
-    // set callback function
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
-
     // pass data to callback
     curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response_data);
 
     //performing he http request
     CURLcode res = curl_easy_perform(curl);
+    ++requests_sent_;
 
     //check if the req succeeded
     if(res != CURLE_OK)
     {
-        string error_msg = "CURL request Failed: " + string(curl_easy_strerror(res));
-        curl_easy_cleanup(curl);
-        throw runtime_error(error_msg);
+        throw runtime_error("CURL request Failed: " + string(curl_easy_strerror(res)));
     }
 
     //check HTTP status code
@@ -75,13 +125,9 @@ string BinanceClient::make_request(const string& endpoint, const string& query_s
 
 if(http_code != 200)
 {
-    string error_msg = "HTTP error code: " + to_string(http_code);
-    curl_easy_cleanup(curl);
-    throw::runtime_error(error_msg);
+    throw::runtime_error("HTTP error code: " + to_string(http_code));
 }
 
-curl_easy_cleanup(curl);
-
 return response_data;
 
 
@@ -120,40 +166,240 @@ vector<Kline>BinanceClient::fetch_klines(
      
 }
 
-vector<Kline>BinanceClient::parse_klines_json(const string& json_response)
+uint64_t BinanceClient::interval_ms(const string& interval)
 {
-    auto now = chrono::high_resolution_clock::now();
-    // Store as microseconds since high_resolution_clock epoch
-    uint64_t fetch_time_ms = chrono::duration_cast<chrono::microseconds>(now.time_since_epoch()).count();
+    // "<count><unit>", unit one of s/m/h/d/w ("1M" has no fixed length)
+    size_t digits = 0;
+    while(digits < interval.size() && isdigit(static_cast<unsigned char>(interval[digits])))
+    {
+        ++digits;
+    }
+    if(digits == 0 || digits + 1 != interval.size())
+    {
+        throw runtime_error("Unsupported kline interval: " + interval);
+    }
+    uint64_t count = stoull(interval.substr(0, digits));
+    uint64_t unit_ms = 0;
+    switch(interval.back())
+    {
+        case 's': unit_ms = 1000; break;
+        case 'm': unit_ms = 60 * 1000; break;
+        case 'h': unit_ms = 60 * 60 * 1000; break;
+        case 'd': unit_ms = 24 * 60 * 60 * 1000; break;
+        case 'w': unit_ms = 7 * 24 * 60 * 60 * 1000; break;
+        default: throw runtime_error("Unsupported kline interval: " + interval);
+    }
+    if(count == 0)
+    {
+        throw runtime_error("Unsupported kline interval: " + interval);
+    }
+    return count * unit_ms;
+}
 
-    vector<Kline>klines;
-    try{
-        json parsed = json::parse(json_response);
-    
+vector<Kline> BinanceClient::fetch_klines_range(
+    const string& symbol,
+    const string& interval,
+    uint64_t start_ms,
+    uint64_t end_ms,
+    const RangeFetchOptions& options
+)
+{
+    if(options.page_limit <= 0 || options.max_in_flight <= 0)
+    {
+        throw runtime_error("fetch_klines_range: page_limit and max_in_flight must be positive");
+    }
+    if(end_ms <= start_ms)
+    {
+        return {};
+    }
 
-    for(const auto& kline_array : parsed)
+    // s1 -> split the range into pages of page_limit bars each
+    const uint64_t page_span_ms = interval_ms(interval) * static_cast<uint64_t>(options.page_limit);
+    vector<PageRequest> pages;
+    pages.reserve((end_ms - start_ms + page_span_ms - 1) / page_span_ms);
+    for(uint64_t t = start_ms; t < end_ms; )
     {
-        uint64_t timestamp_ms = kline_array[0].get<uint64_t>();
-        double open = stod(kline_array[1].get<string>());
-        double high = stod(kline_array[2].get<string>());
-        double low = stod(kline_array[3].get<string>());
-        double close = stod(kline_array[4].get<string>());
-        double volume = stod(kline_array[7].get<string>());
+        uint64_t page_end = end_ms - t > page_span_ms ? t + page_span_ms : end_ms;
+        pages.push_back(PageRequest{t, page_end, 0, false, KlineJsonDecoder()});
+        t = page_end;
+    }
 
-        //create and add kline to vec
-        Kline kline{timestamp_ms, fetch_time_ms, 0, open, high, low, close, volume};
-        klines.push_back(kline);
+    // s2 -> lazily set up the multi handle and enough pooled easy handles
+    if(!multi_)
+    {
+        multi_ = curl_multi_init();
+        if(!multi_)
+        {
+            throw runtime_error("Failed to initialise CURL multi handle");
+        }
+    }
+    while(pool_.size() < static_cast<size_t>(options.max_in_flight))
+    {
+        pool_.push_back(new_handle());
+    }
+    vector<CURL*> idle(pool_.begin(), pool_.begin() + options.max_in_flight);
+
+    // detach whatever is still in flight if we bail out with an exception
+    struct DetachOnExit {
+        CURLM* multi;
+        const vector<CURL*>& handles;
+        ~DetachOnExit() {
+            for(CURL* h : handles) curl_multi_remove_handle(multi, h);
+        }
+    } detach{multi_, pool_};
+
+    // s3 -> run the pages concurrently, at most one request start per rate-limit period
+    using clock = chrono::steady_clock;
+    const auto period = options.requests_per_second > 0
+        ? chrono::duration_cast<clock::duration>(chrono::duration<double>(1.0 / options.requests_per_second))
+        : clock::duration::zero();
+    auto next_slot = clock::now();
+
+    deque<size_t> pending;
+    for(size_t i = 0; i < pages.size(); ++i) pending.push_back(i);
+    size_t in_flight = 0;
+    const string prefix = api_base + "/api/v3/klines?symbol=" + symbol + "&interval=" + interval +
+                          "&limit=" + to_string(options.page_limit);
+
+    while(!pending.empty() || in_flight > 0)
+    {
+        auto now = clock::now();
+        while(!pending.empty() && !idle.empty() && now >= next_slot)
+        {
+            size_t p = pending.front();
+            pending.pop_front();
+            CURL* curl = idle.back();
+            idle.pop_back();
+
+            // Binance's endTime is inclusive
+            string url = prefix + "&startTime=" + to_string(pages[p].start_ms) +
+                         "&endTime=" + to_string(pages[p].end_ms - 1);
+            pages[p].receiving = false;
+            pages[p].decoder.reserve(static_cast<size_t>(options.page_limit));
+            curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+            curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, page_write_callback);
+            curl_easy_setopt(curl, CURLOPT_WRITEDATA, &pages[p]);
+            curl_easy_setopt(curl, CURLOPT_PRIVATE, &pages[p]);
+            curl_easy_setopt(curl, CURLOPT_FORBID_REUSE, options.reuse_connections ? 0L : 1L);
+            curl_multi_add_handle(multi_, curl);
+            ++in_flight;
+            ++requests_sent_;
+            next_slot = max(next_slot, now) + period;
+        }
+
+        int running = 0;
+        CURLMcode mc = curl_multi_perform(multi_, &running);
+        if(mc != CURLM_OK)
+        {
+            throw runtime_error("CURL multi failed: " + string(curl_multi_strerror(mc)));
+        }
+
+        int queued = 0;
+        while(CURLMsg* msg = curl_multi_info_read(multi_, &queued))
+        {
+            if(msg->msg != CURLMSG_DONE)
+            {
+                continue;
+            }
+            CURL* curl = msg->easy_handle;
+            CURLcode res = msg->data.result;
+            char* page_ptr = nullptr;
+            curl_easy_getinfo(curl, CURLINFO_PRIVATE, &page_ptr);
+            long http_code = 0;
+            curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+            curl_multi_remove_handle(multi_, curl);
+            idle.push_back(curl);
+            --in_flight;
+
+            PageRequest& page = *reinterpret_cast<PageRequest*>(page_ptr);
+            if(res == CURLE_OK && http_code == 200)
+            {
+                if(!page.receiving)
+                {
+                    page.decoder.reset(wall_clock_us());
+                }
+                try{
+                    page.decoder.finish();
+                } catch(const exception& e){
+                    throw runtime_error("Failed to parse klines JSON: " + string(e.what()));
+                }
+                continue;
+            }
+            bool retry = res != CURLE_OK || retryable_status(http_code);
+            if(retry && ++page.attempts <= options.max_retries)
+            {
+                // back off a little before the next request goes out
+                pending.push_front(static_cast<size_t>(&page - pages.data()));
+                next_slot = max(next_slot, clock::now()) + chrono::milliseconds(250 * page.attempts);
+                continue;
+            }
+            throw runtime_error(res != CURLE_OK
+                ? "CURL request Failed: " + string(curl_easy_strerror(res))
+                : "HTTP error code: " + to_string(http_code));
+        }
+
+        if(!pending.empty() || in_flight > 0)
+        {
+            // sleep until a transfer has work or the next rate-limit slot opens
+            int timeout_ms = 100;
+            if(!pending.empty() && !idle.empty())
+            {
+                auto wait = chrono::duration_cast<chrono::milliseconds>(next_slot - clock::now()).count();
+                timeout_ms = static_cast<int>(clamp<long long>(wait, 0, 100));
+            }
+            if(timeout_ms > 0 || in_flight > 0)
+            {
+                curl_multi_poll(multi_, nullptr, 0, timeout_ms, nullptr);
+            }
+        }
     }
-} catch(const exception& e){
-    throw runtime_error("Failed to parse klines JSON: " + string(e.what()));
- }
 
+    // s4 -> stitch the pages back in time order, dropping anything outside the page window
+    vector<Kline> klines;
+    klines.reserve((end_ms - start_ms) / interval_ms(interval) + 1);
+    for(const auto& page : pages)
+    {
+        for(const auto& kline : page.decoder.klines())
+        {
+            if(kline.timestamp_ms < page.start_ms || kline.timestamp_ms >= page.end_ms)
+            {
+                continue;
+            }
+            if(!klines.empty() && kline.timestamp_ms <= klines.back().timestamp_ms)
+            {
+                continue;
+            }
+            klines.push_back(kline);
+        }
+    }
+    return klines;
+}
 
-return klines;
+vector<Kline>BinanceClient::parse_klines_json(const string& json_response)
+{
+    // Stamped in microseconds on the shared wall clock, Executor measures fill latency against it
+    uint64_t fetch_time_ms = wall_clock_us();
 
-};
+    // streaming decoder straight into Klines, no DOM / per-field strings
+    try{
+        return KlineJsonDecoder::decode(json_response, fetch_time_ms);
+    } catch(const exception& e){
+        throw runtime_error("Failed to parse klines JSON: " + string(e.what()));
+    }
+}
 
 
 BinanceClient::BinanceClient(const string& api_base) 
     : api_base(api_base) {}
 
+BinanceClient::~BinanceClient()
+{
+    for(CURL* curl : pool_)
+    {
+        if(multi_) curl_multi_remove_handle(multi_, curl);
+        curl_easy_cleanup(curl);
+    }
+    if(multi_) curl_multi_cleanup(multi_);
+    if(handle_) curl_easy_cleanup(handle_);
+}
+
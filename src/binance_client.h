@@ -1,14 +1,33 @@
 #pragma once
 
 #include "types.h"
+#include <cstdint>
 #include <string>
 #include <vector>
 
 using namespace std;
 
+// opaque curl handles (same typedefs as <curl/curl.h>)
+typedef void CURL;
+typedef void CURLM;
+
+// Paging / concurrency knobs for fetch_klines_range
+struct RangeFetchOptions {
+    int page_limit = 1000;             // klines per request, Binance caps this at 1000
+    int max_in_flight = 8;             // concurrent requests on the multi handle
+    double requests_per_second = 20.0; // client-side rate limit, <= 0 disables it
+    int max_retries = 3;               // per page, on 429/418/5xx and transport errors
+    bool reuse_connections = true;     // false forces a fresh TCP(+TLS) connection per request
+};
+
 class BinanceClient {
     public:
-    BinanceClient(const string& api_base = "https://api.binanace.com");
+    BinanceClient(const string& api_base = "https://api.binance.com");
+    ~BinanceClient();
+
+    // owns curl handles (and their live connections)
+    BinanceClient(const BinanceClient&) = delete;
+    BinanceClient& operator=(const BinanceClient&) = delete;
 
     //fetch klines from binanace
     // return the vec of kline vectors
@@ -18,11 +37,36 @@ class BinanceClient {
         int limit
     );
 
+    // Bulk history: every kline with open time in [start_ms, end_ms).
+    // The range is split into page_limit-sized requests that run concurrently over
+    // reused keep-alive connections, then stitched back in time order.
+    vector<Kline> fetch_klines_range(
+        const string& symbol,
+        const string& interval,
+        uint64_t start_ms,
+        uint64_t end_ms,
+        const RangeFetchOptions& options = {}
+    );
+
+    // "1m" -> 60000 etc, throws on intervals without a fixed length ("1M")
+    static uint64_t interval_ms(const string& interval);
+
+    // requests sent so far, retries included
+    size_t requests_sent() const { return requests_sent_; }
+
     private:
     string api_base;
 
+    // persistent handle for single requests, keeps its connection alive between calls
+    CURL* handle_ = nullptr;
+    // multi handle + easy handle pool for range fetches; the multi handle owns the
+    // shared connection cache so connections outlive a single fetch
+    CURLM* multi_ = nullptr;
+    vector<CURL*> pool_;
+    size_t requests_sent_ = 0;
+
     // helper fn to make http req
     string make_request(const string& endpoint, const string& query_string);
 
     vector<Kline> parse_klines_json(const string& json_response);
-};
\ No newline at end of file
+};
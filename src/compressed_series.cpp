@@ -0,0 +1,372 @@
+#include "compressed_series.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+using namespace std;
+
+namespace {
+
+constexpr uint8_t kRawValues = 0xFF;
+constexpr uint8_t kMaxDecimals = 9;
+constexpr double kPow10[kMaxDecimals + 1] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9};
+// integers a double holds exactly; keeps every tick delta inside int64
+constexpr double kMaxTicks = 9007199254740992.0;
+
+// MSB-first bit stream appended to a word vector
+class BitWriter
+{
+public:
+    explicit BitWriter(vector<uint64_t>& words) : words_(words) {}
+
+    // bits in [1, 64]
+    void write(uint64_t value, unsigned bits)
+    {
+        if (bits < 64) value &= (1ULL << bits) - 1;
+        if (used_ == 0) words_.push_back(0);
+        unsigned free = 64 - used_;
+        if (bits <= free) {
+            words_.back() |= value << (free - bits);
+            used_ = (used_ + bits) & 63;
+        } else {
+            unsigned rest = bits - free;
+            words_.back() |= value >> rest;
+            words_.push_back(value << (64 - rest));
+            used_ = rest;
+        }
+    }
+
+private:
+    vector<uint64_t>& words_;
+    unsigned used_ = 0;   // bits used in words_.back(), 0 = start a new word
+};
+
+class BitReader
+{
+public:
+    explicit BitReader(const uint64_t* words) : words_(words) {}
+
+    // bits in [1, 64]; always touches the next word too, hence the pad word after a block
+    uint64_t read(unsigned bits)
+    {
+        size_t w = pos_ >> 6;
+        unsigned offset = pos_ & 63;
+        pos_ += bits;
+        uint64_t value = (words_[w] << offset) | ((words_[w + 1] >> 1) >> (63 - offset));
+        return value >> (64 - bits);
+    }
+
+    bool bit() { return read(1) != 0; }
+
+private:
+    const uint64_t* words_;
+    size_t pos_ = 0;
+};
+
+uint64_t zigzag(int64_t v) { return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63); }
+int64_t unzigzag(uint64_t u) { return static_cast<int64_t>(u >> 1) ^ -static_cast<int64_t>(u & 1); }
+
+// One integer column of a block: its bit width (7 bits), then every value at that width.
+// Widths come from the block's own values, so a quiet field costs 0 bits a bar.
+template <typename ValueOf>
+void write_column(BitWriter& out, vector<uint64_t>& values, ValueOf value_of)
+{
+    uint64_t all = 0;
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = value_of(i);
+        all |= values[i];
+    }
+    unsigned width = static_cast<unsigned>(bit_width(all));
+    out.write(width, 7);
+    if (width == 0) return;
+    for (uint64_t v : values) out.write(v, width);
+}
+
+// calls on_value(i, value) for the n values of a column
+template <typename OnValue>
+void read_column(BitReader& in, size_t n, OnValue on_value)
+{
+    unsigned width = static_cast<unsigned>(in.read(7));
+    if (width == 0) {
+        for (size_t i = 0; i < n; ++i) on_value(i, 0);
+        return;
+    }
+    // a local copy: on_value's uint64_t stores into Klines could alias `in`, which would
+    // otherwise force the position through memory on every value
+    BitReader local = in;
+    for (size_t i = 0; i < n; ++i) on_value(i, local.read(width));
+    in = local;
+}
+
+// a delta-of-delta column (first step, then the column) back into out[i].*Field
+template <uint64_t Kline::*Field>
+void read_delta_of_delta(BitReader& in, size_t n, uint64_t value, Kline* out)
+{
+    uint64_t step = in.read(64);
+    read_column(in, n, [&](size_t i, uint64_t dod) {
+        if (i > 0) {
+            step += static_cast<uint64_t>(unzigzag(dod));
+            value += step;
+        }
+        out[i].*Field = value;
+    });
+}
+
+// Gorilla XOR: '0' unchanged, else '1' + leading zeros (6) + length - 1 (6) + the bits
+void write_xor(BitWriter& out, double previous, double value)
+{
+    uint64_t x = bit_cast<uint64_t>(previous) ^ bit_cast<uint64_t>(value);
+    if (x == 0) {
+        out.write(0, 1);
+        return;
+    }
+    unsigned leading = static_cast<unsigned>(min(countl_zero(x), 63));
+    unsigned trailing = static_cast<unsigned>(countr_zero(x));
+    unsigned length = 64 - leading - trailing;
+    out.write((1ULL << 12) | (leading << 6) | (length - 1), 13);
+    out.write(x >> trailing, length);
+}
+
+double read_xor(BitReader& in, double previous)
+{
+    if (!in.bit()) return previous;
+    uint64_t header = in.read(12);
+    unsigned leading = static_cast<unsigned>(header >> 6);
+    unsigned length = static_cast<unsigned>(header & 63) + 1;
+    uint64_t x = in.read(length) << (64 - leading - length);
+    return bit_cast<double>(bit_cast<uint64_t>(previous) ^ x);
+}
+
+// v as an integer count of 10^-decimals, only if decoding gives back the same bits
+bool to_ticks(double v, double scale, int64_t& ticks)
+{
+    double t = nearbyint(v * scale);
+    if (!(fabs(t) <= kMaxTicks)) return false;   // also NaN / inf
+    ticks = static_cast<int64_t>(t);
+    return bit_cast<uint64_t>(static_cast<double>(ticks) / scale) == bit_cast<uint64_t>(v);
+}
+
+// fewest decimals every value in the block is exact at, or kRawValues
+template <typename Field>
+uint8_t pick_decimals(span<const Kline> bars, Field field)
+{
+    for (uint8_t d = 0; d <= kMaxDecimals; ++d) {
+        int64_t ticks;
+        bool exact = all_of(bars.begin(), bars.end(), [&](const Kline& k) { return to_ticks(field(k), kPow10[d], ticks); });
+        if (exact) return d;
+    }
+    return kRawValues;
+}
+
+int64_t ticks_of(double v, double scale) { return static_cast<int64_t>(nearbyint(v * scale)); }
+
+}
+
+CompressedSeries::CompressedSeries(size_t block_bars)
+    : block_bars_(block_bars)
+{
+    if (block_bars == 0 || block_bars > UINT32_MAX) {
+        throw runtime_error("CompressedSeries block size out of range: " + to_string(block_bars));
+    }
+    pending_.reserve(block_bars_);
+}
+
+CompressedSeries::CompressedSeries(span<const Kline> klines, size_t block_bars)
+    : CompressedSeries(block_bars)
+{
+    for (size_t first = 0; first + block_bars_ <= klines.size(); first += block_bars_) {
+        encode_block(klines.subspan(first, block_bars_));
+    }
+    pending_.assign(klines.begin() + static_cast<ptrdiff_t>(encoded_bars_), klines.end());
+    pending_.shrink_to_fit();
+    words_.shrink_to_fit();
+    blocks_.shrink_to_fit();
+}
+
+void CompressedSeries::push_back(const Kline& kline)
+{
+    pending_.push_back(kline);
+    if (pending_.size() == block_bars_) {
+        encode_block(pending_);
+        pending_.clear();
+    }
+}
+
+void CompressedSeries::encode_block(span<const Kline> bars)
+{
+    uint8_t price_decimals = pick_decimals(bars, [](const Kline& k) { return k.open; });
+    for (auto field : {&Kline::high, &Kline::low, &Kline::close}) {
+        if (price_decimals == kRawValues) break;
+        // one scale for all four, so high/low can be coded against open/close
+        price_decimals = max(price_decimals, pick_decimals(bars, [field](const Kline& k) { return k.*field; }));
+    }
+    if (price_decimals != kRawValues) {
+        int64_t ticks;
+        double scale = kPow10[price_decimals];
+        for (const auto& k : bars) {
+            if (!to_ticks(k.open, scale, ticks) || !to_ticks(k.high, scale, ticks) || !to_ticks(k.low, scale, ticks) ||
+                !to_ticks(k.close, scale, ticks)) {
+                price_decimals = kRawValues;
+                break;
+            }
+        }
+    }
+    uint8_t volume_decimals = pick_decimals(bars, [](const Kline& k) { return k.volume; });
+
+    blocks_.push_back(BlockIndex{words_.size(), static_cast<uint32_t>(bars.size()), price_decimals, volume_decimals});
+    BitWriter out(words_);
+    size_t n = bars.size();
+    vector<uint64_t> values(n);
+
+    // bar 0 in full, then delta-of-delta from the first step on
+    const Kline& first = bars[0];
+    out.write(first.timestamp_ms, 64);
+    out.write(first.fetch_time_ms, 64);
+    out.write(first.symbol_id, 32);
+    for (auto field : {&Kline::timestamp_ms, &Kline::fetch_time_ms}) {
+        int64_t step = n > 1 ? static_cast<int64_t>(bars[1].*field - first.*field) : 0;
+        out.write(static_cast<uint64_t>(step), 64);
+        write_column(out, values, [&](size_t i) {
+            if (i == 0) return uint64_t{0};
+            int64_t delta = static_cast<int64_t>(bars[i].*field - bars[i - 1].*field);
+            int64_t dod = delta - step;
+            step = delta;
+            return zigzag(dod);
+        });
+    }
+    write_column(out, values, [&](size_t i) {
+        return i == 0 ? 0 : zigzag(static_cast<int64_t>(bars[i].symbol_id) - static_cast<int64_t>(bars[i - 1].symbol_id));
+    });
+
+    if (price_decimals == kRawValues) {
+        for (auto field : {&Kline::open, &Kline::high, &Kline::low, &Kline::close}) {
+            double previous = 0.0;
+            for (const auto& k : bars) {
+                write_xor(out, previous, k.*field);
+                previous = k.*field;
+            }
+        }
+    } else {
+        double scale = kPow10[price_decimals];
+        vector<int64_t> open(n), close(n);
+        for (size_t i = 0; i < n; ++i) {
+            open[i] = ticks_of(bars[i].open, scale);
+            close[i] = ticks_of(bars[i].close, scale);
+        }
+        // close and open from the previous close (bar 0: its own open), high / low as
+        // distances outside the body
+        out.write(zigzag(open[0]), 64);
+        auto previous_close = [&](size_t i) { return i == 0 ? open[0] : close[i - 1]; };
+        write_column(out, values, [&](size_t i) { return zigzag(close[i] - previous_close(i)); });
+        write_column(out, values, [&](size_t i) { return zigzag(open[i] - previous_close(i)); });
+        write_column(out, values, [&](size_t i) {
+            return zigzag(ticks_of(bars[i].high, scale) - max(open[i], close[i]));
+        });
+        write_column(out, values, [&](size_t i) {
+            return zigzag(min(open[i], close[i]) - ticks_of(bars[i].low, scale));
+        });
+    }
+
+    if (volume_decimals == kRawValues) {
+        double previous = 0.0;
+        for (const auto& k : bars) {
+            write_xor(out, previous, k.volume);
+            previous = k.volume;
+        }
+    } else {
+        double scale = kPow10[volume_decimals];
+        write_column(out, values, [&](size_t i) { return zigzag(ticks_of(bars[i].volume, scale)); });
+    }
+    words_.push_back(0);   // pad word, see BitReader::read
+    encoded_bars_ += n;
+}
+
+size_t CompressedSeries::decode_block(size_t block, Kline* out) const
+{
+    if (block == blocks_.size() && !pending_.empty()) {
+        copy(pending_.begin(), pending_.end(), out);
+        return pending_.size();
+    }
+    if (block >= blocks_.size()) {
+        throw runtime_error("CompressedSeries block " + to_string(block) + " out of range");
+    }
+
+    const BlockIndex& index = blocks_[block];
+    BitReader in(words_.data() + index.first_word);
+    size_t n = index.bars;
+
+    uint64_t first_timestamp = in.read(64);
+    uint64_t first_fetch = in.read(64);
+    uint32_t first_symbol = static_cast<uint32_t>(in.read(32));
+    read_delta_of_delta<&Kline::timestamp_ms>(in, n, first_timestamp, out);
+    read_delta_of_delta<&Kline::fetch_time_ms>(in, n, first_fetch, out);
+    uint32_t symbol = first_symbol;
+    read_column(in, n, [&](size_t i, uint64_t delta) {
+        symbol += static_cast<uint32_t>(unzigzag(delta));
+        out[i].symbol_id = symbol;
+    });
+
+    if (index.price_decimals == kRawValues) {
+        for (auto field : {&Kline::open, &Kline::high, &Kline::low, &Kline::close}) {
+            double previous = 0.0;
+            for (size_t i = 0; i < n; ++i) {
+                previous = read_xor(in, previous);
+                out[i].*field = previous;
+            }
+        }
+    } else {
+        // open / close ticks are parked in their own slots (bit_cast) until high and low,
+        // the last columns that need them, have been decoded
+        double scale = kPow10[index.price_decimals];
+        int64_t base = unzigzag(in.read(64));
+        int64_t close = base;
+        read_column(in, n, [&](size_t i, uint64_t delta) {
+            close += unzigzag(delta);
+            out[i].close = bit_cast<double>(close);
+        });
+        read_column(in, n, [&](size_t i, uint64_t delta) {
+            int64_t previous = i == 0 ? base : bit_cast<int64_t>(out[i - 1].close);
+            out[i].open = bit_cast<double>(previous + unzigzag(delta));
+        });
+        read_column(in, n, [&](size_t i, uint64_t delta) {
+            int64_t top = max(bit_cast<int64_t>(out[i].open), bit_cast<int64_t>(out[i].close));
+            out[i].high = static_cast<double>(top + unzigzag(delta)) / scale;
+        });
+        read_column(in, n, [&](size_t i, uint64_t delta) {
+            int64_t open = bit_cast<int64_t>(out[i].open);
+            int64_t c = bit_cast<int64_t>(out[i].close);
+            out[i].low = static_cast<double>(min(open, c) - unzigzag(delta)) / scale;
+            out[i].open = static_cast<double>(open) / scale;
+            out[i].close = static_cast<double>(c) / scale;
+        });
+    }
+
+    if (index.volume_decimals == kRawValues) {
+        double previous = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            previous = read_xor(in, previous);
+            out[i].volume = previous;
+        }
+    } else {
+        double scale = kPow10[index.volume_decimals];
+        read_column(in, n, [&](size_t i, uint64_t v) { out[i].volume = static_cast<double>(unzigzag(v)) / scale; });
+    }
+    return n;
+}
+
+vector<Kline> CompressedSeries::to_klines() const
+{
+    vector<Kline> klines(size());
+    size_t at = 0;
+    for (size_t b = 0; b < block_count(); ++b) {
+        at += decode_block(b, klines.data() + at);
+    }
+    return klines;
+}
+
+size_t CompressedSeries::memory_bytes() const
+{
+    return words_.capacity() * sizeof(uint64_t) + blocks_.capacity() * sizeof(BlockIndex) +
+           pending_.capacity() * sizeof(Kline);
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "types.h"
+
+using namespace std;
+
+/* --- Compressed in-memory kline history.
+Bars are packed into independently decodable blocks of block_bars (default 1024) bars,
+each a bit stream starting on its own word with all predictor state reset. Inside a block
+every field is a column, and integer columns are bit-packed at the narrowest width that
+holds all of the block's values (a constant field costs 0 bits a bar):
+
+   timestamp_ms, fetch_time_ms   delta-of-delta after the first step
+   symbol_id                     delta from the previous bar
+   open/high/low/close           integer ticks at the block's price scale when every price
+                                 in the block is an exact decimal (the CSV case): close and
+                                 open as deltas from the previous close, high and low as
+                                 distances outside the body
+   volume                        integer ticks at the block's volume scale
+   either, not decimal           XOR with the previous value of the field (Gorilla)
+
+Decoding is lossless bit for bit, whichever path a block takes. Replay decodes one block
+at a time into a cache-resident buffer (ReplayEngine(const CompressedSeries&)), so long
+1s histories take ~8 bytes a bar on CSV-style prices instead of sizeof(Kline). */
+class CompressedSeries
+{
+public:
+    static constexpr size_t kDefaultBlockBars = 1024;
+
+    explicit CompressedSeries(size_t block_bars = kDefaultBlockBars);
+    explicit CompressedSeries(span<const Kline> klines, size_t block_bars = kDefaultBlockBars);
+
+    // appends one bar; a block is encoded every block_bars bars
+    void push_back(const Kline& kline);
+
+    size_t size() const { return encoded_bars_ + pending_.size(); }
+    bool empty() const { return size() == 0; }
+    size_t block_bars() const { return block_bars_; }
+    // the tail that hasn't filled a block yet counts as the last block
+    size_t block_count() const { return blocks_.size() + (pending_.empty() ? 0 : 1); }
+
+    // decodes block `block` into out (block_bars() capacity), returns its bar count
+    size_t decode_block(size_t block, Kline* out) const;
+
+    vector<Kline> to_klines() const;
+
+    // bytes held: bit streams, block index and the unencoded tail
+    size_t memory_bytes() const;
+
+private:
+    struct BlockIndex
+    {
+        size_t first_word;
+        uint32_t bars;
+        uint8_t price_decimals;    // kRawValues: XOR-coded doubles
+        uint8_t volume_decimals;
+    };
+
+    void encode_block(span<const Kline> bars);
+
+    size_t block_bars_;
+    size_t encoded_bars_ = 0;
+    vector<uint64_t> words_;
+    vector<BlockIndex> blocks_;
+    vector<Kline> pending_;
+};
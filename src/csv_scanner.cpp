@@ -0,0 +1,223 @@
+#include "csv_scanner.h"
+#include <charconv>
+#include <immintrin.h>
+#include <stdexcept>
+#include <string>
+using namespace std;
+
+namespace {
+
+void scan_scalar(const char* data, size_t len, size_t offset, vector<uint32_t>& out)
+{
+    for (size_t i = offset; i < len; ++i) {
+        if (data[i] == ',' || data[i] == '\n') {
+            out.push_back(static_cast<uint32_t>(i));
+        }
+    }
+}
+
+// turns the set bits of a match mask into offsets
+inline void emit_mask(uint64_t mask, size_t base, vector<uint32_t>& out)
+{
+    while (mask) {
+        out.push_back(static_cast<uint32_t>(base + __builtin_ctzll(mask)));
+        mask &= mask - 1;
+    }
+}
+
+__attribute__((target("sse4.2")))
+void scan_sse42(const char* data, size_t len, vector<uint32_t>& out)
+{
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i newline = _mm_set1_epi8('\n');
+
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(chunk, comma), _mm_cmpeq_epi8(chunk, newline));
+        emit_mask(static_cast<uint32_t>(_mm_movemask_epi8(hits)), i, out);
+    }
+    scan_scalar(data, len, i, out);
+}
+
+__attribute__((target("avx2")))
+void scan_avx2(const char* data, size_t len, vector<uint32_t>& out)
+{
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i newline = _mm256_set1_epi8('\n');
+
+    // two registers per step -> one 64-bit mask per 64 bytes
+    size_t i = 0;
+    for (; i + 64 <= len; i += 64) {
+        __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 32));
+        __m256i hits_lo = _mm256_or_si256(_mm256_cmpeq_epi8(lo, comma), _mm256_cmpeq_epi8(lo, newline));
+        __m256i hits_hi = _mm256_or_si256(_mm256_cmpeq_epi8(hi, comma), _mm256_cmpeq_epi8(hi, newline));
+        uint64_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(hits_lo)) |
+                        (static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(hits_hi))) << 32);
+        emit_mask(mask, i, out);
+    }
+    for (; i + 32 <= len; i += 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i hits = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, comma), _mm256_cmpeq_epi8(chunk, newline));
+        emit_mask(static_cast<uint32_t>(_mm256_movemask_epi8(hits)), i, out);
+    }
+    scan_scalar(data, len, i, out);
+}
+
+CsvScanner::Kernel detect_kernel()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return CsvScanner::Kernel::AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.2")) {
+        return CsvScanner::Kernel::SSE42;
+    }
+    return CsvScanner::Kernel::Scalar;
+}
+
+// exact powers of ten, the largest a double holds without rounding is 1e22
+constexpr double kPow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+double parse_decimal_slow(string_view field)
+{
+    double value = 0.0;
+    auto [ptr, ec] = from_chars(field.data(), field.data() + field.size(), value);
+    if (ec != errc() || ptr != field.data() + field.size()) {
+        throw runtime_error("Invalid number in kline field: '" + string(field) + "'");
+    }
+    return value;
+}
+
+}
+
+CsvScanner::Kernel CsvScanner::active_kernel()
+{
+    static const Kernel kernel = detect_kernel();
+    return kernel;
+}
+
+const char* CsvScanner::kernel_name(Kernel kernel)
+{
+    switch (kernel) {
+        case Kernel::AVX2: return "avx2";
+        case Kernel::SSE42: return "sse4.2";
+        case Kernel::Scalar: return "scalar";
+    }
+    return "unknown";
+}
+
+void CsvScanner::find_separators(const char* data, size_t len, vector<uint32_t>& out)
+{
+    find_separators(data, len, out, active_kernel());
+}
+
+void CsvScanner::find_separators(const char* data, size_t len, vector<uint32_t>& out, Kernel kernel)
+{
+    switch (kernel) {
+        case Kernel::AVX2: scan_avx2(data, len, out); break;
+        case Kernel::SSE42: scan_sse42(data, len, out); break;
+        case Kernel::Scalar: scan_scalar(data, len, 0, out); break;
+    }
+}
+
+double CsvScanner::parse_decimal(string_view field)
+{
+    const char* p = field.data();
+    const char* end = p + field.size();
+
+    bool negative = false;
+    if (p != end && *p == '-') {
+        negative = true;
+        ++p;
+    }
+
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int frac_digits = 0;
+    const char* int_start = p;
+    while (p != end && static_cast<unsigned>(*p - '0') < 10) {
+        mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+        ++digits;
+        ++p;
+    }
+    bool has_int = p != int_start;
+    if (p != end && *p == '.') {
+        ++p;
+        while (p != end && static_cast<unsigned>(*p - '0') < 10) {
+            mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+            ++digits;
+            ++frac_digits;
+            ++p;
+        }
+    }
+
+    // Exponents, odd shapes, or more than 15 significant digits: the mantissa may not be
+    // exactly representable, so leave correct rounding to from_chars.
+    if (p != end || !has_int || digits > 15) {
+        return parse_decimal_slow(field);
+    }
+
+    // both operands are exact doubles, so the single division is correctly rounded
+    double value = static_cast<double>(mantissa) / kPow10[frac_digits];
+    return negative ? -value : value;
+}
+
+int64_t CsvScanner::parse_fixed(string_view field, unsigned decimals)
+{
+    const char* p = field.data();
+    const char* end = p + field.size();
+
+    bool negative = false;
+    if (p != end && *p == '-') {
+        negative = true;
+        ++p;
+    }
+
+    // leading zeros don't count towards the 18 digits
+    while (p + 1 < end && *p == '0' && static_cast<unsigned>(p[1] - '0') < 10) {
+        ++p;
+    }
+
+    uint64_t value = 0;
+    int digits = 0;
+    const char* int_start = p;
+    while (p != end && static_cast<unsigned>(*p - '0') < 10) {
+        value = value * 10 + static_cast<unsigned>(*p - '0');
+        ++digits;
+        ++p;
+    }
+    bool has_int = p != int_start;
+
+    unsigned frac_digits = 0;
+    if (p != end && *p == '.') {
+        ++p;
+        while (p != end && static_cast<unsigned>(*p - '0') < 10) {
+            if (frac_digits < decimals) {
+                value = value * 10 + static_cast<unsigned>(*p - '0');
+                ++digits;
+                ++frac_digits;
+            } else if (*p != '0') {
+                throw runtime_error("More than " + to_string(decimals) + " decimals in '" + string(field) + "'");
+            }
+            ++p;
+        }
+    }
+    if (p != end || !has_int) {
+        throw runtime_error("Invalid number in kline field: '" + string(field) + "'");
+    }
+
+    for (; frac_digits < decimals; ++frac_digits) {
+        value *= 10;
+        ++digits;
+    }
+    if (digits > 18) {
+        throw runtime_error("Fixed-point value out of range: '" + string(field) + "'");
+    }
+    int64_t result = static_cast<int64_t>(value);
+    return negative ? -result : result;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+// Vectorised separator search for the kline CSV format.
+// Each kernel compares a whole register of bytes against ',' and '\n' at once and turns
+// the match mask into offsets, so the cost scales with separators, not with bytes.
+class CsvScanner
+{
+public:
+    enum class Kernel { Scalar, SSE42, AVX2 };
+
+    // best kernel this CPU supports, resolved once on first use
+    static Kernel active_kernel();
+    static const char* kernel_name(Kernel kernel);
+
+    // appends the offset of every ',' and '\n' in [data, data + len) to out
+    static void find_separators(const char* data, size_t len, vector<uint32_t>& out);
+    static void find_separators(const char* data, size_t len, vector<uint32_t>& out, Kernel kernel);
+
+    // Fixed-format decimal ("-123.45") parser for the price/volume columns.
+    // Short mantissas are converted exactly (integer / power of ten), anything else
+    // falls back to from_chars, so results always match from_chars bit for bit.
+    static double parse_decimal(string_view field);
+
+    // Same format straight to fixed point: "-123.45" at 4 decimals is -1234500. Exact or it
+    // throws: digits past `decimals` must be zeros and the result must fit 18 digits.
+    static int64_t parse_fixed(string_view field, unsigned decimals);
+};
@@ -1,6 +1,15 @@
 #include "data_loader.h"
+#include "csv_scanner.h"
+#include "mapped_file.h"
+#include "parser.h"
+#include<algorithm>
+#include<cctype>
+#include<charconv>
+#include<cstring>
 #include<fstream>
 #include<stdexcept>
+#include<string_view>
+#include<utility>
 using namespace std;
 
 vector<string>DataLoader::load_file(const string& filename)
@@ -25,4 +34,190 @@ vector<string>DataLoader::load_file(const string& filename)
         lines.push_back(line);
     }
     return lines;
-}
\ No newline at end of file
+}
+
+pmr::vector<pmr::string> DataLoader::load_file(const string& filename, pmr::memory_resource* resource)
+{
+    // mmap instead of ifstream, so nothing but the lines themselves is allocated
+    MappedFile file(filename);
+    string_view data = file.view();
+
+    pmr::vector<pmr::string> lines(resource);
+    lines.reserve(static_cast<size_t>(count(data.begin(), data.end(), '\n')) + 1);
+    size_t pos = 0;
+    while (pos < data.size())
+    {
+        size_t end = data.find('\n', pos);
+        if (end == string_view::npos)
+        {
+            end = data.size();
+        }
+        lines.emplace_back(data.substr(pos, end - pos));
+        pos = end + 1;
+    }
+    return lines;
+}
+
+namespace {
+
+// shared by the std:: and pmr:: overloads
+template <typename KlineVector>
+size_t load_klines_into(const string& filename, KlineVector& out)
+{
+    MappedFile file(filename);
+    string_view data = file.view();
+
+    // counting newlines is a vectorised pass, far cheaper than growing the vector while parsing
+    size_t line_count = static_cast<size_t>(count(data.begin(), data.end(), '\n')) + 1;
+    out.reserve(out.size() + line_count);
+
+    size_t before = out.size();
+    size_t pos = 0;
+    bool first_row = true;
+    while (pos < data.size())
+    {
+        size_t end = data.find('\n', pos);
+        if (end == string_view::npos)
+        {
+            end = data.size();
+        }
+        string_view line = data.substr(pos, end - pos);
+        pos = end + 1;
+
+        if (line.empty() || line == "\r")
+        {
+            continue;
+        }
+        // only the first row may be a header; any other bad row makes the parser throw
+        if (exchange(first_row, false) && !isdigit(static_cast<unsigned char>(line.front())))
+        {
+            continue;
+        }
+        out.push_back(Parser::parse_kline(line));
+    }
+
+    // same order as load_klines_parallel: by timestamp, file order among equal ones
+    auto by_time = [](const Kline& a, const Kline& b) { return a.timestamp_ms < b.timestamp_ms; };
+    if (!is_sorted(out.begin() + before, out.end(), by_time))
+    {
+        stable_sort(out.begin() + before, out.end(), by_time);
+    }
+    return out.size() - before;
+}
+
+}
+
+namespace {
+
+// anything before 2001-09-09 in microseconds is a millisecond timestamp
+constexpr uint64_t kMicrosecondTimestampFloor = 100000000000000ULL;
+
+Tick parse_agg_trade(string_view line, uint32_t symbol_id)
+{
+    string_view fields[7];
+    size_t count = 0;
+    size_t pos = 0;
+    while (count < 7)
+    {
+        size_t comma = line.find(',', pos);
+        fields[count++] = line.substr(pos, comma == string_view::npos ? string_view::npos : comma - pos);
+        if (comma == string_view::npos)
+        {
+            break;
+        }
+        pos = comma + 1;
+    }
+    if (count < 7)
+    {
+        throw runtime_error("Invalid aggTrade row: '" + string(line) + "'");
+    }
+
+    uint64_t timestamp = 0;
+    auto [ptr, ec] = from_chars(fields[5].data(), fields[5].data() + fields[5].size(), timestamp);
+    if (ec != errc() || ptr != fields[5].data() + fields[5].size())
+    {
+        throw runtime_error("Invalid aggTrade time: '" + string(fields[5]) + "'");
+    }
+    if (timestamp < kMicrosecondTimestampFloor)
+    {
+        timestamp *= 1000;
+    }
+
+    // "true" / "True"
+    char maker = fields[6].empty() ? 'f' : fields[6].front();
+    return Tick{timestamp, CsvScanner::parse_decimal(fields[1]), CsvScanner::parse_decimal(fields[2]),
+                symbol_id, maker == 't' || maker == 'T'};
+}
+
+}
+
+vector<Tick> DataLoader::load_agg_trades(const string& filename, string_view symbol)
+{
+    MappedFile file(filename);
+    string_view data = file.view();
+    uint32_t symbol_id = Parser::symbol_to_id(symbol);
+
+    vector<Tick> ticks;
+    ticks.reserve(static_cast<size_t>(count(data.begin(), data.end(), '\n')) + 1);
+    size_t pos = 0;
+    bool first_row = true;
+    while (pos < data.size())
+    {
+        const char* nl = static_cast<const char*>(memchr(data.data() + pos, '\n', data.size() - pos));
+        size_t end = nl ? static_cast<size_t>(nl - data.data()) : data.size();
+        string_view line = data.substr(pos, end - pos);
+        pos = end + 1;
+
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.remove_suffix(1);
+        }
+        if (line.empty())
+        {
+            continue;
+        }
+        // only the first row may be a header; any other bad row makes parse_agg_trade throw
+        if (exchange(first_row, false) && !isdigit(static_cast<unsigned char>(line.front())))
+        {
+            continue;
+        }
+        ticks.push_back(parse_agg_trade(line, symbol_id));
+    }
+    return ticks;
+}
+
+vector<Kline> DataLoader::load_klines(const string& filename)
+{
+    vector<Kline> klines;
+    load_klines(filename, klines);
+    return klines;
+}
+
+size_t DataLoader::load_klines(const string& filename, vector<Kline>& out)
+{
+    return load_klines_into(filename, out);
+}
+
+size_t DataLoader::load_klines(const string& filename, pmr::vector<Kline>& out)
+{
+    return load_klines_into(filename, out);
+}
+
+
+KlineColumns DataLoader::load_columns(const string& filename)
+{
+    MappedFile file(filename);
+    return Parser::parse_klines(span<const char>(file.data(), file.size()));
+}
+
+vector<FixedKline> DataLoader::load_fixed_klines(const string& filename)
+{
+    MappedFile file(filename);
+    return Parser::parse_klines_fixed(span<const char>(file.data(), file.size()));
+}
+
+vector<Kline> DataLoader::load_klines_parallel(const string& filename, unsigned threads)
+{
+    MappedFile file(filename);
+    return Parser::parse_klines_parallel(span<const char>(file.data(), file.size()), threads);
+}
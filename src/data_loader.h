@@ -1,10 +1,45 @@
 #pragma once
 
+#include <memory_resource>
 #include <vector>
 #include <string>
+#include <string_view>
+#include "parser.h"
+#include "types.h"
 // using namespace std;
 
 class DataLoader {
 public:
     static std::vector<std::string> load_file(const std::string& filename);
-};
\ No newline at end of file
+
+    // same lines, but every string (and the vector) lives in `resource`, e.g. a RunArena
+    static std::pmr::vector<std::pmr::string> load_file(const std::string& filename,
+                                                        std::pmr::memory_resource* resource);
+
+    // mmaps the CSV and parses it in place, no per-line allocations.
+    // Blank lines are skipped, and so is the first line if it does not start with a digit
+    // (the header row). Any other malformed row throws instead of being dropped.
+    // Rows come back sorted by timestamp (stable, so ties keep file order), exactly the
+    // order load_klines_parallel gives; a file that is already sorted costs one check pass.
+    static std::vector<Kline> load_klines(const std::string& filename);
+
+    // same, but appends into a caller-owned buffer so it can be reused between runs.
+    // Returns the number of klines appended.
+    static size_t load_klines(const std::string& filename, std::vector<Kline>& out);
+    static size_t load_klines(const std::string& filename, std::pmr::vector<Kline>& out);
+
+    // mmaps the CSV and hands it to the SIMD batch parser, one vector per field
+    static KlineColumns load_columns(const std::string& filename);
+
+    // Binance aggTrades dump (agg_trade_id,price,quantity,first_trade_id,last_trade_id,
+    // transact_time,is_buyer_maker[,is_best_match]), header row optional. Dumps carry no
+    // symbol column, so every tick gets `symbol`. Millisecond times are scaled to microseconds.
+    static std::vector<Tick> load_agg_trades(const std::string& filename, std::string_view symbol);
+
+    // mmaps the CSV and parses it to fixed point with each symbol's FixedScale
+    static std::vector<FixedKline> load_fixed_klines(const std::string& filename);
+
+    // mmaps the CSV and parses it on `threads` cores (0 = all), see Parser::parse_klines_parallel.
+    // Same rows in the same order as load_klines.
+    static std::vector<Kline> load_klines_parallel(const std::string& filename, unsigned threads = 0);
+};
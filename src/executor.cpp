@@ -1,67 +1,150 @@
 #include "executor.h"
-#include <chrono>
+#include <algorithm>
+#include "latency_probe.h"
+#include "timing.h"
 using namespace std;
 
+namespace {
 
-Executor::Executor(uint64_t initial_capital)
-    : entry_time_ms_(0),
+// Tick-to-fill latency: time since the bar was fetched, on the same wall clock that
+// stamped it. Replayed bars (CSV, .htx) carry no fetch stamp, so there is nothing to
+// measure and the clock isn't read at all.
+uint64_t fill_latency_us(uint64_t fetch_time_us)
+{
+    if (fetch_time_us == 0) {
+        return 0;
+    }
+    uint64_t now_us = wall_clock_us();
+    return now_us > fetch_time_us ? now_us - fetch_time_us : 0;
+}
+
+// frictionless fills, the default when no model is given
+const BarFillModel kIdealFills;
+
+}
+
+
+Executor::Executor(uint64_t initial_capital, const FillModel* fill_model)
+    : fill_model_(fill_model ? fill_model : &kIdealFills),
+      working_{false, OrderType::Market, 0.0, 0},
+      entry_time_ms_(0),
       entry_latency_us_(0),
       exit_latency_us_(0),
       quantity_(0),
+      exited_quantity_(0),
       next_trade_id_(0),
       initial_price_(static_cast<double>(initial_capital)),
       entry_price_(0.0),
+      exit_price_(0.0),
+      realized_pnl_(0.0),
+      entry_fees_(0.0),
       has_position_(false) {}
 
 bool Executor::has_position() const {
     return has_position_;
 }
 
-optional<Trade> Executor::on_kline(const Kline& kline, const Strategy::Decision& decision) {
-    // If strategy says don't trade, return nothing
+optional<Trade> Executor::on_kline(const Kline& kline, const Decision& decision) {
+    BarRange bar{kline.open, kline.high, kline.low, kline.close, kline.volume};
+    return on_bar(kline.timestamp_ms, kline.fetch_time_ms, bar, decision);
+}
+
+optional<Trade> Executor::on_kline(const KlineView& bar, const Decision& decision) {
+    BarRange range{bar.open(), bar.high(), bar.low(), bar.close(), bar.volume()};
+    return on_bar(bar.timestamp_ms(), bar.fetch_time_ms(), range, decision);
+}
+
+optional<Trade> Executor::on_bar(uint64_t timestamp_ms, uint64_t fetch_time_ms, const BarRange& bar,
+                                 const Decision& decision) {
+    HX_PROBE(Probe::Execution);
+
+    // An order left over from earlier bars gets this bar's range first
+    optional<Trade> closed;
+    if (working_.remaining > 0) {
+        closed = work_order(timestamp_ms, fetch_time_ms, bar, false);
+    }
+
+    // If strategy says don't trade, that's all for this bar
     if (!decision.should_trade) {
-        return nullopt;
+        return closed;
     }
-    
-    // BUYING: Enter a position
+
+    // A new decision replaces whatever is still working
+    working_.remaining = 0;
     if (decision.is_buy) {
-        entry_price_ = kline.close;
-        entry_time_ms_ = kline.timestamp_ms;
-        quantity_ = decision.quantity;
-        has_position_ = true;
-        // Record current time in microseconds for latency calculation
-        auto now = chrono::high_resolution_clock::now();
-        uint64_t exec_time_us = chrono::duration_cast<chrono::microseconds>(now.time_since_epoch()).count();
-        entry_latency_us_ = exec_time_us - kline.fetch_time_ms;
+        // BUYING: enter a position (already long: the cancelled exit was all there was to do)
+        if (has_position_) {
+            return closed;
+        }
+        working_ = WorkingOrder{true, decision.order_type, decision.price, decision.quantity};
+    } else {
+        // SELLING: close what is held (flat: the cancelled entry was all there was to do)
+        if (!has_position_) {
+            return closed;
+        }
+        working_ = WorkingOrder{false, decision.order_type, decision.price, quantity_ - exited_quantity_};
+    }
+
+    optional<Trade> now = work_order(timestamp_ms, fetch_time_ms, bar, true);
+    return now.has_value() ? now : closed;
+}
+
+optional<Trade> Executor::work_order(uint64_t timestamp_ms, uint64_t fetch_time_ms, const BarRange& bar,
+                                     bool decision_bar) {
+    Fill fill = fill_model_->fill(working_, bar, decision_bar);
+    if (fill.quantity == 0) {
+        return nullopt;
+    }
+    fill.quantity = min(fill.quantity, working_.remaining);
+    working_.remaining -= fill.quantity;
+    double q = static_cast<double>(fill.quantity);
+
+    if (working_.is_buy) {
+        if (!has_position_) {
+            entry_price_ = fill.price;
+            entry_time_ms_ = timestamp_ms;
+            entry_latency_us_ = fill_latency_us(fetch_time_ms);
+            has_position_ = true;
+        } else {
+            // partial fills: volume-weighted entry
+            double held = static_cast<double>(quantity_);
+            entry_price_ = (entry_price_ * held + fill.price * q) / (held + q);
+        }
+        quantity_ += fill.quantity;
+        entry_fees_ += fill.fee;
         return nullopt;  // Trade not complete yet
     }
-    
-    // SELLING: Close the position
-    double exit_price = kline.close;
-    uint64_t exit_time = kline.timestamp_ms;
-    double pnl = (exit_price - entry_price_) * static_cast<double>(quantity_);
-    // Record current time in microseconds for latency calculation
-    auto now_exit = chrono::high_resolution_clock::now();
-    uint64_t exec_time_us_exit = chrono::duration_cast<chrono::microseconds>(now_exit.time_since_epoch()).count();
-    exit_latency_us_ = exec_time_us_exit - kline.fetch_time_ms;
-    
+
+    // exit fill
+    double exited = static_cast<double>(exited_quantity_);
+    exit_price_ = exited_quantity_ == 0 ? fill.price : (exit_price_ * exited + fill.price * q) / (exited + q);
+    realized_pnl_ += (fill.price - entry_price_) * q - fill.fee;
+    exited_quantity_ += fill.quantity;
+    if (exited_quantity_ < quantity_) {
+        return nullopt;
+    }
+    exit_latency_us_ = fill_latency_us(fetch_time_ms);
+
     // Create completed Trade
     Trade completed_trade = {
         next_trade_id_,                      // trade_id
         entry_time_ms_,                      // entry_time_ms
-        exit_time,                           // exit_time_ms
+        timestamp_ms,                        // exit_time_ms
         entry_latency_us_,                   // entry_latency_us
         exit_latency_us_,                    // exit_latency_us
         entry_price_,                        // entry_price
-        exit_price,                          // exit_price
+        exit_price_,                         // exit_price
         static_cast<double>(quantity_),      // quantity (cast to double)
-        pnl                                  // pnl
+        realized_pnl_ - entry_fees_          // pnl, net of all fees
     };
-    
+
     // Update state
     has_position_ = false;
+    quantity_ = 0;
+    exited_quantity_ = 0;
+    realized_pnl_ = 0.0;
+    entry_fees_ = 0.0;
     next_trade_id_++;
-    
+
     return completed_trade;
 }
-
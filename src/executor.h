@@ -1,27 +1,45 @@
 #pragma once
 #include "types.h"
-#include "strategy.h"
+#include "fill_model.h"
+#include "kline_series.h"
 #include <optional>
 using namespace std;
 
+// Turns decisions into fills through a FillModel and closed positions into Trades.
+// One order works at a time; a new decision replaces it (a buy while long only cancels a
+// working exit, a sell while flat only cancels a working entry). Trade pnl is net of fees.
 class Executor{
 
     public:
-    explicit Executor(uint64_t initial_capital);
-    
-    optional<Trade> on_kline(const Kline& kline, const Strategy::Decision& decision);
+    // `fill_model` is borrowed and must outlive the executor; nullptr = frictionless bar fills
+    explicit Executor(uint64_t initial_capital, const FillModel* fill_model = nullptr);
+
+    optional<Trade> on_kline(const Kline& kline, const Decision& decision);
+    optional<Trade> on_kline(const KlineView& bar, const Decision& decision);
     bool has_position() const;
+    bool has_working_order() const { return working_.remaining > 0; }
 
     private:
+    optional<Trade> on_bar(uint64_t timestamp_ms, uint64_t fetch_time_ms, const BarRange& bar,
+                           const Decision& decision);
+    // asks the model for a fill of the working order; returns the Trade if it closed the position
+    optional<Trade> work_order(uint64_t timestamp_ms, uint64_t fetch_time_ms, const BarRange& bar,
+                               bool decision_bar);
+
+    const FillModel* fill_model_;
+    WorkingOrder working_;
     uint64_t entry_time_ms_;
     uint64_t entry_latency_us_;
     uint64_t exit_latency_us_;
-    uint64_t quantity_;
+    uint64_t quantity_;          // units held
+    uint64_t exited_quantity_;   // units sold so far out of the current position
     uint64_t next_trade_id_;
     double initial_capital_;
     double initial_price_;
-    double entry_price_;
+    double entry_price_;         // average over the entry fills
+    double exit_price_;          // average over the exit fills
+    double realized_pnl_;        // exit fills of the current position, net of their fees
+    double entry_fees_;
     bool has_position_;
 
 };
-
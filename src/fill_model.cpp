@@ -0,0 +1,73 @@
+#include "fill_model.h"
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+
+constexpr double kBps = 1e-4;
+
+// buys pay up, sells give up
+double slipped(double price, bool is_buy, double slippage_bps)
+{
+    double s = slippage_bps * kBps;
+    return is_buy ? price * (1.0 + s) : price * (1.0 - s);
+}
+
+// reference price this bar fills at, or a negative value when it doesn't fill
+double fill_price(const WorkingOrder& order, const BarRange& bar, bool decision_bar, double slippage_bps)
+{
+    bool buy = order.is_buy;
+    double p = order.price;
+
+    if (decision_bar) {
+        switch (order.type) {
+            case OrderType::Market:
+                return slipped(bar.close, buy, slippage_bps);
+            case OrderType::Limit:
+                return (buy ? bar.close <= p : bar.close >= p) ? bar.close : -1.0;
+            case OrderType::Stop:
+                return (buy ? bar.close >= p : bar.close <= p) ? slipped(bar.close, buy, slippage_bps) : -1.0;
+        }
+        return -1.0;
+    }
+
+    switch (order.type) {
+        case OrderType::Market:
+            return slipped(bar.open, buy, slippage_bps);
+        case OrderType::Limit:
+            if (buy ? bar.open <= p : bar.open >= p) return bar.open;   // gapped through: price improvement
+            if (buy ? bar.low <= p : bar.high >= p) return p;
+            return -1.0;
+        case OrderType::Stop:
+            if (buy ? bar.open >= p : bar.open <= p) return slipped(bar.open, buy, slippage_bps);
+            if (buy ? bar.high >= p : bar.low <= p) return slipped(p, buy, slippage_bps);
+            return -1.0;
+    }
+    return -1.0;
+}
+
+}
+
+Fill BarFillModel::fill(const WorkingOrder& order, const BarRange& bar, bool decision_bar) const
+{
+    double price = fill_price(order, bar, decision_bar, costs_.slippage_bps);
+    if (price < 0.0 || order.remaining == 0) {
+        return Fill{0.0, 0, 0.0};
+    }
+
+    uint64_t quantity = order.remaining;
+    if (costs_.max_participation > 0.0) {
+        // only a slice of the bar's volume is ours, the rest of the order waits for later bars.
+        // Compared as doubles: fractional volumes (0.3 BTC) make caps below one unit.
+        double cap = bar.volume * costs_.max_participation;
+        if (static_cast<double>(quantity) > cap) {
+            if (!(cap >= 1.0)) {
+                return Fill{0.0, 0, 0.0, true};
+            }
+            quantity = static_cast<uint64_t>(cap);
+        }
+    }
+    double fee = price * static_cast<double>(quantity) * costs_.fee_bps * kBps;
+    return Fill{price, quantity, fee};
+}
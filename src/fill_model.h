@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include "types.h"
+
+using namespace std;
+
+// The parts of a bar a fill model may look at
+struct BarRange
+{
+    double open;
+    double high;
+    double low;
+    double close;
+    double volume;
+};
+
+// An order Executor is working and what's left of it
+struct WorkingOrder
+{
+    bool is_buy;
+    OrderType type;
+    double price;          // limit price / stop trigger
+    uint64_t remaining;
+};
+
+struct Fill
+{
+    double price;          // per unit, slippage included
+    uint64_t quantity;     // 0 = nothing filled on this bar, the order keeps working
+    double fee;
+    bool participation_capped = false;  // price was reached but the cap allows less than one unit
+};
+
+/* --- Pluggable fill model.
+Executor asks the model once per bar while an order is working. On the decision bar the
+strategy has already seen the whole bar, so only what is executable at the close may fill
+there; later bars can fill against their open/high/low. Models are stateless and shared. */
+class FillModel
+{
+public:
+    virtual ~FillModel() = default;
+    virtual Fill fill(const WorkingOrder& order, const BarRange& bar, bool decision_bar) const = 0;
+};
+
+struct FillCosts
+{
+    double slippage_bps = 0.0;      // market and stop fills pay this much past the reference price
+    double fee_bps = 0.0;           // on traded notional, every fill
+    double max_participation = 0.0; // cap per bar as a fraction of bar volume (0 = no cap -> no partial fills)
+};
+
+/* --- Bar-level fills.
+    market: decision bar at the close, later bars (remainders) at the open, +- slippage
+    limit:  marketable at the close -> the close; later bars fill at the open if it gapped
+            through the limit, otherwise at the limit once low/high reaches it (no slippage)
+    stop:   triggered at the close -> the close; later bars at the open if it gapped through
+            the trigger, otherwise at the trigger once high/low reaches it, +- slippage
+With default costs this is the old instant-fill-at-close behaviour for market orders. */
+class BarFillModel : public FillModel
+{
+public:
+    explicit BarFillModel(const FillCosts& costs = {}) : costs_(costs) {}
+
+    Fill fill(const WorkingOrder& order, const BarRange& bar, bool decision_bar) const override;
+
+    const FillCosts& costs() const { return costs_; }
+
+private:
+    FillCosts costs_;
+};
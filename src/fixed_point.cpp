@@ -0,0 +1,104 @@
+#include "fixed_point.h"
+#include "latency_probe.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+using namespace std;
+
+int64_t pow10_fixed(unsigned decimals)
+{
+    static constexpr int64_t kPow10[19] = {
+        1LL, 10LL, 100LL, 1000LL, 10000LL, 100000LL, 1000000LL, 10000000LL, 100000000LL, 1000000000LL,
+        10000000000LL, 100000000000LL, 1000000000000LL, 10000000000000LL, 100000000000000LL,
+        1000000000000000LL, 10000000000000000LL, 100000000000000000LL, 1000000000000000000LL
+    };
+    if (decimals > 18) {
+        throw runtime_error("Fixed-point scale too large: " + to_string(decimals) + " decimals");
+    }
+    return kPow10[decimals];
+}
+
+optional<FixedTrade> FixedExecutor::on_kline(const FixedKline& kline, const Decision& decision)
+{
+    HX_PROBE(Probe::Execution);
+
+    if (!decision.should_trade) {
+        return nullopt;
+    }
+    if (decision.order_type != OrderType::Market) {
+        throw runtime_error("FixedExecutor only fills market orders");
+    }
+
+    if (decision.is_buy) {
+        if (!has_position_) {
+            if (decision.quantity > static_cast<uint64_t>(numeric_limits<int64_t>::max())) {
+                throw overflow_error("Fixed-point quantity out of range: " + to_string(decision.quantity));
+            }
+            entry_time_ms_ = kline.timestamp_ms;
+            entry_price_ = kline.close;
+            quantity_ = static_cast<int64_t>(decision.quantity);
+            has_position_ = true;
+        }
+        return nullopt;
+    }
+    if (!has_position_) {
+        return nullopt;
+    }
+
+    FixedTrade trade{
+        next_trade_id_,
+        entry_time_ms_,
+        kline.timestamp_ms,
+        0,
+        0,
+        entry_price_,
+        kline.close,
+        quantity_,
+        checked_mul(checked_sub(kline.close, entry_price_), quantity_)
+    };
+    has_position_ = false;
+    quantity_ = 0;
+    next_trade_id_++;
+    return trade;
+}
+
+FixedMetrics::FixedMetrics(uint64_t initial_capital, const FixedScale& scale)
+    : scale_(scale)
+{
+    if (initial_capital > static_cast<uint64_t>(numeric_limits<int64_t>::max())) {
+        throw overflow_error("Fixed-point capital out of range: " + to_string(initial_capital));
+    }
+    pnl_.reset(checked_mul(static_cast<int64_t>(initial_capital), pow10_fixed(scale.price_decimals)));
+}
+
+void FixedMetrics::on_trade(const FixedTrade& trade)
+{
+    // BasicPnlStats sums in plain int64; refuse a trade that would wrap any of its sums
+    checked_add(pnl_.total_pnl, trade.pnl);
+    int64_t balance = checked_add(pnl_.balance, trade.pnl);
+    checked_sub(max(pnl_.peak_balance, balance), balance);
+    pnl_.add(trade.pnl);
+}
+
+Statistics FixedMetrics::snapshot() const
+{
+    if (pnl_.trades == 0) {
+        return Statistics{0, 0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    }
+
+    unsigned decimals = scale_.price_decimals;
+    return Statistics{
+        pnl_.trades,
+        pnl_.wins,
+        from_fixed(pnl_.total_pnl, decimals),
+        (static_cast<double>(pnl_.wins) / static_cast<double>(pnl_.trades)) * 100.0,
+        from_fixed(pnl_.max_drawdown, decimals),
+        from_fixed(pnl_.largest_win, decimals),
+        from_fixed(pnl_.largest_loss, decimals),
+        0.0,
+        0.0,
+        0.0,
+        0.0
+    };
+}
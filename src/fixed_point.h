@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include "metrics.h"
+#include "symbol_table.h"
+#include "types.h"
+
+using namespace std;
+
+// 10^decimals for the fixed-point scales (decimals <= 18)
+int64_t pow10_fixed(unsigned decimals);
+
+// int64 arithmetic that throws instead of wrapping: an exact path must not silently overflow
+inline int64_t checked_add(int64_t a, int64_t b)
+{
+    int64_t result;
+    if (__builtin_add_overflow(a, b, &result)) {
+        throw overflow_error("Fixed-point overflow in " + to_string(a) + " + " + to_string(b));
+    }
+    return result;
+}
+
+inline int64_t checked_sub(int64_t a, int64_t b)
+{
+    int64_t result;
+    if (__builtin_sub_overflow(a, b, &result)) {
+        throw overflow_error("Fixed-point overflow in " + to_string(a) + " - " + to_string(b));
+    }
+    return result;
+}
+
+inline int64_t checked_mul(int64_t a, int64_t b)
+{
+    int64_t result;
+    if (__builtin_mul_overflow(a, b, &result)) {
+        throw overflow_error("Fixed-point overflow in " + to_string(a) + " * " + to_string(b));
+    }
+    return result;
+}
+
+// Fixed-point value -> double. One correctly rounded division, so a price parsed both ways
+// from the same CSV field comes out identical to CsvScanner::parse_decimal.
+inline double from_fixed(int64_t value, unsigned decimals)
+{
+    return static_cast<double>(value) / static_cast<double>(pow10_fixed(decimals));
+}
+
+/* --- Executor for the fixed-point path.
+Same rules as Executor with its default fill model: market orders fill at the decision
+bar's close, one position at a time, a Trade once it is sold. Prices stay in ticks and pnl
+is (exit - entry) * quantity in integers, so it is exact however long the run; a value that
+doesn't fit int64 throws overflow_error rather than wrapping. No fill models or fees here:
+those need fractional ticks. */
+class FixedExecutor
+{
+public:
+    optional<FixedTrade> on_kline(const FixedKline& kline, const Decision& decision);
+    bool has_position() const { return has_position_; }
+
+private:
+    uint64_t entry_time_ms_ = 0;
+    int64_t entry_price_ = 0;
+    int64_t quantity_ = 0;
+    uint64_t next_trade_id_ = 0;
+    bool has_position_ = false;
+};
+
+// Metrics over FixedTrades: the same PnlStats core on int64 ticks, converted to the
+// symbol's currency only in snapshot(). Capital and running sums that would overflow int64
+// throw overflow_error. Replayed fixed-point bars carry no fetch stamps, so the latency
+// fields stay 0.
+class FixedMetrics
+{
+public:
+    FixedMetrics(uint64_t initial_capital, const FixedScale& scale);
+
+    void on_trade(const FixedTrade& trade);
+    Statistics snapshot() const;
+
+    // the exact integer state, pnl in price ticks
+    const BasicPnlStats<int64_t>& pnl() const { return pnl_; }
+
+private:
+    FixedScale scale_;
+    BasicPnlStats<int64_t> pnl_;
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+
+/* --- .htx binary columnar kline file, version 1 (little-endian, native layout)
+
+   [HtxHeader]                       offset 0
+   [symbol dictionary]               per symbol: uint32 length + name bytes
+   [HtxBlockIndex x block_count]     min/max timestamp of every block_rows rows
+   [timestamp_ms  uint64 x rows]     each column starts on a 64-byte boundary
+   [symbol_id     uint32 x rows]
+   [open, high, low, close, volume   double x rows each]
+
+   Columns are read straight out of the mmap, nothing is parsed on load. */
+
+constexpr char kHtxMagic[4] = {'H', 'T', 'X', '1'};
+constexpr uint32_t kHtxVersion = 1;
+constexpr uint32_t kHtxBlockRows = 4096;
+constexpr uint64_t kHtxAlignment = 64;
+
+enum HtxColumn : uint32_t
+{
+    HTX_TIMESTAMP = 0,
+    HTX_SYMBOL_ID,
+    HTX_OPEN,
+    HTX_HIGH,
+    HTX_LOW,
+    HTX_CLOSE,
+    HTX_VOLUME,
+    HTX_COLUMN_COUNT
+};
+
+// header flags
+constexpr uint32_t kHtxSortedByTime = 1u << 0;
+
+struct HtxHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t flags;
+    uint32_t symbol_count;
+    uint64_t row_count;
+    uint32_t block_rows;
+    uint32_t reserved;
+    uint64_t block_count;
+    uint64_t symbols_offset;
+    uint64_t index_offset;
+    uint64_t column_offset[HTX_COLUMN_COUNT];
+    uint64_t file_size;
+};
+
+struct HtxBlockIndex
+{
+    uint64_t min_timestamp_ms;
+    uint64_t max_timestamp_ms;
+};
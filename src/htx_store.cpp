@@ -0,0 +1,265 @@
+#include "htx_store.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+using namespace std;
+
+namespace {
+
+uint64_t align_up(uint64_t offset)
+{
+    return (offset + kHtxAlignment - 1) & ~(kHtxAlignment - 1);
+}
+
+void pad_to(ofstream& out, uint64_t offset)
+{
+    static const char zeros[kHtxAlignment] = {};
+    uint64_t pos = static_cast<uint64_t>(out.tellp());
+    out.write(zeros, static_cast<streamsize>(offset - pos));
+}
+
+// writes one column in fixed-size batches so huge AoS inputs are never transposed in one go
+template <typename T, typename Get>
+void write_column(ofstream& out, size_t rows, Get get)
+{
+    constexpr size_t kBatch = 16384;
+    T buffer[kBatch];
+    for (size_t start = 0; start < rows; start += kBatch) {
+        size_t n = min(kBatch, rows - start);
+        for (size_t i = 0; i < n; ++i) {
+            buffer[i] = get(start + i);
+        }
+        out.write(reinterpret_cast<const char*>(buffer), static_cast<streamsize>(n * sizeof(T)));
+    }
+}
+
+// Shared writer: get_ts(i) / get_sym(i) / get_price(column, i) give access to row i
+template <typename GetTs, typename GetSym, typename GetPrice>
+void write_htx(const string& filename, size_t rows, const vector<string>& symbol_names,
+               GetTs get_ts, GetSym get_sym, GetPrice get_price)
+{
+    HtxHeader header{};
+    memcpy(header.magic, kHtxMagic, sizeof(header.magic));
+    header.version = kHtxVersion;
+    header.symbol_count = static_cast<uint32_t>(symbol_names.size());
+    header.row_count = rows;
+    header.block_rows = kHtxBlockRows;
+    header.block_count = (rows + kHtxBlockRows - 1) / kHtxBlockRows;
+
+    // per-block timestamp bounds, and whether the whole file is time-ordered
+    vector<HtxBlockIndex> index(header.block_count);
+    bool sorted = true;
+    for (size_t b = 0; b < index.size(); ++b) {
+        size_t begin = b * kHtxBlockRows;
+        size_t end = min<size_t>(begin + kHtxBlockRows, rows);
+        HtxBlockIndex entry{get_ts(begin), get_ts(begin)};
+        for (size_t i = begin; i < end; ++i) {
+            uint64_t ts = get_ts(i);
+            entry.min_timestamp_ms = min(entry.min_timestamp_ms, ts);
+            entry.max_timestamp_ms = max(entry.max_timestamp_ms, ts);
+            if (i > 0 && ts < get_ts(i - 1)) {
+                sorted = false;
+            }
+        }
+        index[b] = entry;
+    }
+    header.flags = sorted ? kHtxSortedByTime : 0;
+
+    // layout
+    uint64_t offset = sizeof(HtxHeader);
+    header.symbols_offset = offset;
+    for (const auto& name : symbol_names) {
+        offset += sizeof(uint32_t) + name.size();
+    }
+    offset = align_up(offset);
+    header.index_offset = offset;
+    offset = align_up(offset + index.size() * sizeof(HtxBlockIndex));
+
+    header.column_offset[HTX_TIMESTAMP] = offset;
+    offset = align_up(offset + rows * sizeof(uint64_t));
+    header.column_offset[HTX_SYMBOL_ID] = offset;
+    offset = align_up(offset + rows * sizeof(uint32_t));
+    for (uint32_t c = HTX_OPEN; c < HTX_COLUMN_COUNT; ++c) {
+        header.column_offset[c] = offset;
+        offset = align_up(offset + rows * sizeof(double));
+    }
+    header.file_size = offset;
+
+    ofstream out(filename, ios::binary | ios::trunc);
+    if (!out.is_open()) {
+        throw runtime_error("Cannot create file: " + filename);
+    }
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (const auto& name : symbol_names) {
+        uint32_t len = static_cast<uint32_t>(name.size());
+        out.write(reinterpret_cast<const char*>(&len), sizeof(len));
+        out.write(name.data(), static_cast<streamsize>(name.size()));
+    }
+
+    pad_to(out, header.index_offset);
+    out.write(reinterpret_cast<const char*>(index.data()), static_cast<streamsize>(index.size() * sizeof(HtxBlockIndex)));
+
+    pad_to(out, header.column_offset[HTX_TIMESTAMP]);
+    write_column<uint64_t>(out, rows, get_ts);
+    pad_to(out, header.column_offset[HTX_SYMBOL_ID]);
+    write_column<uint32_t>(out, rows, get_sym);
+    for (uint32_t c = HTX_OPEN; c < HTX_COLUMN_COUNT; ++c) {
+        pad_to(out, header.column_offset[c]);
+        write_column<double>(out, rows, [&](size_t i) { return get_price(c, i); });
+    }
+    pad_to(out, header.file_size);
+
+    if (!out.good()) {
+        throw runtime_error("Failed writing file: " + filename);
+    }
+}
+
+}
+
+void HtxWriter::write(const string& filename, span<const Kline> klines, const vector<string>& symbol_names)
+{
+    write_htx(filename, klines.size(), symbol_names,
+        [&](size_t i) { return klines[i].timestamp_ms; },
+        [&](size_t i) { return klines[i].symbol_id; },
+        [&](uint32_t c, size_t i) {
+            const Kline& k = klines[i];
+            switch (c) {
+                case HTX_OPEN: return k.open;
+                case HTX_HIGH: return k.high;
+                case HTX_LOW: return k.low;
+                case HTX_CLOSE: return k.close;
+                default: return k.volume;
+            }
+        });
+}
+
+void HtxWriter::write(const string& filename, const KlineColumns& columns, const vector<string>& symbol_names)
+{
+    const vector<double>* prices[HTX_COLUMN_COUNT] = {
+        nullptr, nullptr, &columns.open, &columns.high, &columns.low, &columns.close, &columns.volume
+    };
+    write_htx(filename, columns.size(), symbol_names,
+        [&](size_t i) { return columns.timestamp_ms[i]; },
+        [&](size_t i) { return columns.symbol_id[i]; },
+        [&](uint32_t c, size_t i) { return (*prices[c])[i]; });
+}
+
+HtxReader::HtxReader(const string& filename)
+    : file_(filename),
+      header_(reinterpret_cast<const HtxHeader*>(file_.data()))
+{
+    if (file_.size() < sizeof(HtxHeader) || memcmp(header_->magic, kHtxMagic, sizeof(kHtxMagic)) != 0) {
+        throw runtime_error("Not an .htx file: " + filename);
+    }
+    if (header_->version != kHtxVersion) {
+        throw runtime_error("Unsupported .htx version " + to_string(header_->version) + " in " + filename);
+    }
+    if (header_->file_size != file_.size()) {
+        throw runtime_error("Truncated .htx file: " + filename);
+    }
+
+    // every span handed out below must stay inside the mapping
+    const HtxHeader& h = *header_;
+    bool valid = h.symbols_offset <= h.index_offset &&
+                 (h.row_count == 0 || h.block_rows > 0) &&
+                 h.block_count == (h.row_count == 0 ? 0 : (h.row_count - 1) / h.block_rows + 1) &&
+                 file_.contains(h.index_offset, h.block_count, sizeof(HtxBlockIndex));
+    for (uint32_t c = 0; c < HTX_COLUMN_COUNT && valid; ++c) {
+        size_t width = c == HTX_TIMESTAMP ? sizeof(uint64_t) : c == HTX_SYMBOL_ID ? sizeof(uint32_t) : sizeof(double);
+        valid = h.column_offset[c] % kHtxAlignment == 0 && file_.contains(h.column_offset[c], h.row_count, width);
+    }
+    if (!valid) {
+        throw runtime_error("Corrupt .htx header in " + filename);
+    }
+
+    // symbol dictionary
+    const char* p = file_.data() + header_->symbols_offset;
+    const char* end = file_.data() + header_->index_offset;
+    symbol_names_.reserve(header_->symbol_count);
+    for (uint32_t i = 0; i < header_->symbol_count; ++i) {
+        uint32_t len = 0;
+        if (p + sizeof(len) > end) {
+            throw runtime_error("Corrupt symbol dictionary in " + filename);
+        }
+        memcpy(&len, p, sizeof(len));
+        p += sizeof(len);
+        if (p + len > end) {
+            throw runtime_error("Corrupt symbol dictionary in " + filename);
+        }
+        symbol_names_.emplace_back(p, len);
+        p += len;
+    }
+}
+
+span<const HtxBlockIndex> HtxReader::block_index() const
+{
+    return span<const HtxBlockIndex>(
+        reinterpret_cast<const HtxBlockIndex*>(file_.data() + header_->index_offset), header_->block_count);
+}
+
+size_t HtxReader::lower_bound(uint64_t target_ms) const
+{
+    // first block whose max reaches the timestamp, then search inside it
+    auto blocks = block_index();
+    auto block = std::lower_bound(blocks.begin(), blocks.end(), target_ms,
+        [](const HtxBlockIndex& b, uint64_t ts) { return b.max_timestamp_ms < ts; });
+    if (block == blocks.end()) {
+        return size();
+    }
+
+    auto ts = timestamp_ms();
+    size_t begin = static_cast<size_t>(block - blocks.begin()) * header_->block_rows;
+    size_t end = min<size_t>(begin + header_->block_rows, size());
+    return static_cast<size_t>(std::lower_bound(ts.begin() + begin, ts.begin() + end, target_ms) - ts.begin());
+}
+
+Kline HtxReader::at(size_t i) const
+{
+    return Kline{timestamp_ms()[i], 0, symbol_id()[i], open()[i], high()[i], low()[i], close()[i], volume()[i]};
+}
+
+vector<uint32_t> HtxReader::global_symbol_ids() const
+{
+    // file symbol IDs -> global IDs, usually the identity
+    vector<uint32_t> remap;
+    remap.reserve(symbol_names_.size());
+    for (const auto& name : symbol_names_) {
+        remap.push_back(Parser::symbol_to_id(name));
+    }
+    return remap;
+}
+
+vector<Kline> HtxReader::to_klines() const
+{
+    vector<uint32_t> remap = global_symbol_ids();
+
+    auto ts = timestamp_ms();
+    auto sym = symbol_id();
+    auto o = open(), h = high(), l = low(), c = close(), v = volume();
+
+    vector<Kline> klines(size());
+    for (size_t i = 0; i < klines.size(); ++i) {
+        uint32_t id = sym[i] < remap.size() ? remap[sym[i]] : sym[i];
+        klines[i] = Kline{ts[i], 0, id, o[i], h[i], l[i], c[i], v[i]};
+    }
+    return klines;
+}
+
+KlineSeries HtxReader::to_series() const
+{
+    vector<uint32_t> remap = global_symbol_ids();
+
+    auto ts = timestamp_ms();
+    auto sym = symbol_id();
+    auto o = open(), h = high(), l = low(), c = close(), v = volume();
+
+    KlineSeries series;
+    series.reserve(size());
+    for (size_t i = 0; i < size(); ++i) {
+        uint32_t id = sym[i] < remap.size() ? remap[sym[i]] : sym[i];
+        series.push_back(Kline{ts[i], 0, id, o[i], h[i], l[i], c[i], v[i]});
+    }
+    return series;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <span>
+#include <string>
+#include <vector>
+#include "htx_format.h"
+#include "kline_series.h"
+#include "mapped_file.h"
+#include "parser.h"
+#include "types.h"
+
+using namespace std;
+
+class HtxWriter
+{
+public:
+    // symbol_names[id] is the name of symbol_id `id` in the klines
+    static void write(const string& filename, span<const Kline> klines, const vector<string>& symbol_names);
+    static void write(const string& filename, const KlineColumns& columns, const vector<string>& symbol_names);
+};
+
+// mmaps an .htx file; every column is a span straight into the mapping
+class HtxReader
+{
+public:
+    explicit HtxReader(const string& filename);
+
+    size_t size() const { return header_->row_count; }
+    bool sorted_by_time() const { return header_->flags & kHtxSortedByTime; }
+
+    span<const uint64_t> timestamp_ms() const { return column<uint64_t>(HTX_TIMESTAMP); }
+    span<const uint32_t> symbol_id() const { return column<uint32_t>(HTX_SYMBOL_ID); }
+    span<const double> open() const { return column<double>(HTX_OPEN); }
+    span<const double> high() const { return column<double>(HTX_HIGH); }
+    span<const double> low() const { return column<double>(HTX_LOW); }
+    span<const double> close() const { return column<double>(HTX_CLOSE); }
+    span<const double> volume() const { return column<double>(HTX_VOLUME); }
+
+    const vector<string>& symbol_names() const { return symbol_names_; }
+    span<const HtxBlockIndex> block_index() const;
+
+    // first row with timestamp >= timestamp_ms, using the block index to skip whole blocks.
+    // Only meaningful for files sorted by time.
+    size_t lower_bound(uint64_t target_ms) const;
+
+    // Kline with the file's symbol IDs
+    Kline at(size_t i) const;
+
+    // file symbol ID -> Parser's global symbol ID, the remapping the two below apply
+    vector<uint32_t> global_symbol_ids() const;
+
+    // Materialises Klines with symbol IDs remapped into Parser's global symbol table
+    vector<Kline> to_klines() const;
+
+    // same remapping, straight into SoA columns
+    KlineSeries to_series() const;
+
+private:
+    template <typename T>
+    span<const T> column(HtxColumn c) const
+    {
+        return span<const T>(reinterpret_cast<const T*>(file_.data() + header_->column_offset[c]), header_->row_count);
+    }
+
+    MappedFile file_;
+    const HtxHeader* header_;
+    vector<string> symbol_names_;
+};
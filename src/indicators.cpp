@@ -0,0 +1,448 @@
+#include "indicators.h"
+#include <immintrin.h>
+#include <string>
+#include "aligned_allocator.h"
+#include "simd_dispatch.h"
+
+using namespace std;
+
+using indicator_detail::kNaN;
+
+namespace {
+
+void check(size_t period, size_t in, size_t out, const char* name)
+{
+    if (period == 0) {
+        throw runtime_error(string(name) + ": period must be positive");
+    }
+    if (in != out) {
+        throw runtime_error(string(name) + ": output column is " + to_string(out) + " long, input is " +
+                            to_string(in));
+    }
+}
+
+void fill_warmup(span<double> out, size_t bars)
+{
+    for (size_t i = 0; i < bars && i < out.size(); ++i) {
+        out[i] = kNaN;
+    }
+}
+
+// Per-thread scratch columns reused across calls (like SweepRunner's per-thread arena):
+// after the first call on a thread, batch kernels touch no fresh pages
+constexpr size_t kScratchSlots = 5;
+
+double* scratch(size_t slot, size_t size)
+{
+    static thread_local AlignedVector<double> columns[kScratchSlots];
+    if (columns[slot].size() < size) {
+        columns[slot].resize(size);
+    }
+    return columns[slot].data();
+}
+
+// Compensated prefix sums as two columns: P[0] = 0, P[k + 1] = P[k] + x[k], hi + lo.
+// Built with the same CompensatedSum PrefixWindow uses, so windows match bit for bit.
+struct Prefix
+{
+    double* hi;
+    double* lo;
+
+    // uses scratch slots `slot` and `slot + 1`
+    Prefix(size_t values, size_t slot) : hi(scratch(slot, values + 1)), lo(scratch(slot + 1, values + 1)) {}
+
+    void set(size_t k, const indicator_detail::CompensatedSum& sum)
+    {
+        hi[k] = sum.hi;
+        lo[k] = sum.lo;
+    }
+
+    // sum of the n values ending at index i
+    double window(size_t i, size_t n) const
+    {
+        return indicator_detail::window_sum(hi[i + 1], lo[i + 1], hi[i + 1 - n], lo[i + 1 - n]);
+    }
+};
+
+Prefix prefix_sum(span<const double> x)
+{
+    Prefix prefix(x.size(), 0);
+    indicator_detail::CompensatedSum sum;
+    prefix.set(0, sum);
+    for (size_t k = 0; k < x.size(); ++k) {
+        sum.add(x[k]);
+        prefix.set(k + 1, sum);
+    }
+    return prefix;
+}
+
+// window_sum() on four lanes
+__attribute__((target("avx2,fma")))
+inline __m256d window_avx2(const Prefix& p, size_t i, size_t n)
+{
+    __m256d hi = _mm256_sub_pd(_mm256_loadu_pd(p.hi + i + 1), _mm256_loadu_pd(p.hi + i + 1 - n));
+    __m256d lo = _mm256_sub_pd(_mm256_loadu_pd(p.lo + i + 1), _mm256_loadu_pd(p.lo + i + 1 - n));
+    return _mm256_add_pd(hi, lo);
+}
+
+// ---- window kernels, bars [first, bars), first >= n - 1
+
+void window_mean_scalar(const Prefix& p, size_t first, size_t bars, size_t n, double* out)
+{
+    double dn = static_cast<double>(n);
+    for (size_t i = first; i < bars; ++i) {
+        out[i] = p.window(i, n) / dn;
+    }
+}
+
+__attribute__((target("avx2,fma")))
+void window_mean_avx2(const Prefix& p, size_t bars, size_t n, double* out)
+{
+    const __m256d dn = _mm256_set1_pd(static_cast<double>(n));
+    size_t i = n - 1;
+    for (; i + 4 <= bars; i += 4) {
+        _mm256_storeu_pd(out + i, _mm256_div_pd(window_avx2(p, i, n), dn));
+    }
+    window_mean_scalar(p, i, bars, n, out);
+}
+
+void window_ratio_scalar(const Prefix& num, const Prefix& den, size_t first, size_t bars, size_t n, double* out)
+{
+    for (size_t i = first; i < bars; ++i) {
+        out[i] = num.window(i, n) / den.window(i, n);
+    }
+}
+
+__attribute__((target("avx2,fma")))
+void window_ratio_avx2(const Prefix& num, const Prefix& den, size_t bars, size_t n, double* out)
+{
+    size_t i = n - 1;
+    for (; i + 4 <= bars; i += 4) {
+        _mm256_storeu_pd(out + i, _mm256_div_pd(window_avx2(num, i, n), window_avx2(den, i, n)));
+    }
+    window_ratio_scalar(num, den, i, bars, n, out);
+}
+
+struct Bands
+{
+    double* middle;
+    double* upper;
+    double* lower;
+};
+
+void bands_scalar(const Prefix& sums, const Prefix& squares, size_t first, size_t bars, size_t n, double shift,
+                  double width, Bands out)
+{
+    double dn = static_cast<double>(n);
+    for (size_t i = first; i < bars; ++i) {
+        double mean = sums.window(i, n) / dn;
+        double mean_square = squares.window(i, n) / dn;
+        double variance = indicator_detail::clamp_variance(fma(-mean, mean, mean_square), mean_square);
+        double sd = sqrt(variance);
+        double mid = mean + shift;
+        out.middle[i] = mid;
+        out.upper[i] = fma(width, sd, mid);
+        out.lower[i] = fma(-width, sd, mid);
+    }
+}
+
+__attribute__((target("avx2,fma")))
+void bands_avx2(const Prefix& sums, const Prefix& squares, size_t bars, size_t n, double shift, double width,
+                Bands out)
+{
+    const __m256d dn = _mm256_set1_pd(static_cast<double>(n));
+    const __m256d vshift = _mm256_set1_pd(shift);
+    const __m256d vwidth = _mm256_set1_pd(width);
+    const __m256d floor = _mm256_set1_pd(indicator_detail::kVarianceFloor);
+    size_t i = n - 1;
+    for (; i + 4 <= bars; i += 4) {
+        __m256d mean = _mm256_div_pd(window_avx2(sums, i, n), dn);
+        __m256d sq = _mm256_div_pd(window_avx2(squares, i, n), dn);
+        __m256d variance = _mm256_fnmadd_pd(mean, mean, sq);
+        __m256d above_floor = _mm256_cmp_pd(variance, _mm256_mul_pd(floor, sq), _CMP_GT_OQ);
+        variance = _mm256_and_pd(variance, above_floor);
+        __m256d sd = _mm256_sqrt_pd(variance);
+        __m256d mid = _mm256_add_pd(mean, vshift);
+        _mm256_storeu_pd(out.middle + i, mid);
+        _mm256_storeu_pd(out.upper + i, _mm256_fmadd_pd(vwidth, sd, mid));
+        _mm256_storeu_pd(out.lower + i, _mm256_fnmadd_pd(vwidth, sd, mid));
+    }
+    bands_scalar(sums, squares, i, bars, n, shift, width, out);
+}
+
+// ---- per-bar input columns
+
+// gain[i] / loss[i] for i >= 1 (index 0 unused)
+void changes_scalar(const double* x, size_t bars, double* gain, double* loss)
+{
+    for (size_t i = 1; i < bars; ++i) {
+        gain[i] = max_of(x[i] - x[i - 1], 0.0);
+        loss[i] = max_of(x[i - 1] - x[i], 0.0);
+    }
+}
+
+__attribute__((target("avx2,fma")))
+void changes_avx2(const double* x, size_t bars, double* gain, double* loss)
+{
+    const __m256d zero = _mm256_setzero_pd();
+    size_t i = 1;
+    for (; i + 4 <= bars; i += 4) {
+        __m256d cur = _mm256_loadu_pd(x + i);
+        __m256d prev = _mm256_loadu_pd(x + i - 1);
+        _mm256_storeu_pd(gain + i, _mm256_max_pd(_mm256_sub_pd(cur, prev), zero));
+        _mm256_storeu_pd(loss + i, _mm256_max_pd(_mm256_sub_pd(prev, cur), zero));
+    }
+    for (; i < bars; ++i) {
+        gain[i] = max_of(x[i] - x[i - 1], 0.0);
+        loss[i] = max_of(x[i - 1] - x[i], 0.0);
+    }
+}
+
+// tr[i] for i >= 1 (index 0 is high - low, set by the caller)
+void true_range_scalar(const double* high, const double* low, const double* close, size_t bars, double* tr)
+{
+    for (size_t i = 1; i < bars; ++i) {
+        tr[i] = indicator_detail::true_range(high[i], low[i], close[i - 1]);
+    }
+}
+
+__attribute__((target("avx2,fma")))
+void true_range_avx2(const double* high, const double* low, const double* close, size_t bars, double* tr)
+{
+    const __m256d abs_mask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffLL));
+    size_t i = 1;
+    for (; i + 4 <= bars; i += 4) {
+        __m256d h = _mm256_loadu_pd(high + i);
+        __m256d l = _mm256_loadu_pd(low + i);
+        __m256d pc = _mm256_loadu_pd(close + i - 1);
+        __m256d hl = _mm256_sub_pd(h, l);
+        __m256d hc = _mm256_and_pd(_mm256_sub_pd(h, pc), abs_mask);
+        __m256d lc = _mm256_and_pd(_mm256_sub_pd(l, pc), abs_mask);
+        _mm256_storeu_pd(tr + i, _mm256_max_pd(_mm256_max_pd(hl, hc), lc));
+    }
+    for (; i < bars; ++i) {
+        tr[i] = indicator_detail::true_range(high[i], low[i], close[i - 1]);
+    }
+}
+
+void typical_scalar(const double* high, const double* low, const double* close, size_t bars, double* out)
+{
+    for (size_t i = 0; i < bars; ++i) {
+        out[i] = (high[i] + low[i] + close[i]) / 3.0;
+    }
+}
+
+__attribute__((target("avx2,fma")))
+void typical_avx2(const double* high, const double* low, const double* close, size_t bars, double* out)
+{
+    const __m256d three = _mm256_set1_pd(3.0);
+    size_t i = 0;
+    for (; i + 4 <= bars; i += 4) {
+        __m256d sum = _mm256_add_pd(_mm256_add_pd(_mm256_loadu_pd(high + i), _mm256_loadu_pd(low + i)),
+                                    _mm256_loadu_pd(close + i));
+        _mm256_storeu_pd(out + i, _mm256_div_pd(sum, three));
+    }
+    for (; i < bars; ++i) {
+        out[i] = (high[i] + low[i] + close[i]) / 3.0;
+    }
+}
+
+// Wilder smoothing over a column of per-bar inputs starting at `first`:
+// sum the first n, then avg = (avg * (n - 1) + v) / n, handing every average to emit(i, avg).
+template <typename Emit>
+void wilder(const double* values, size_t first, size_t bars, size_t n, Emit&& emit)
+{
+    double dn = static_cast<double>(n);
+    double avg = 0.0;
+    size_t i = first;
+    for (; i < bars && i + 1 < first + n; ++i) {
+        avg += values[i];
+    }
+    if (i >= bars) return;
+    avg = (avg + values[i]) / dn;
+    emit(i, avg);
+    for (++i; i < bars; ++i) {
+        avg = fma(avg, dn - 1.0, values[i]) / dn;
+        emit(i, avg);
+    }
+}
+
+}
+
+void Indicators::sma(span<const double> x, size_t period, span<double> out)
+{
+    check(period, x.size(), out.size(), "sma");
+    fill_warmup(out, period - 1);
+    if (x.size() < period) return;
+
+    Prefix prefix = prefix_sum(x);
+    if (use_avx2_fma()) {
+        window_mean_avx2(prefix, x.size(), period, out.data());
+    } else {
+        window_mean_scalar(prefix, period - 1, x.size(), period, out.data());
+    }
+}
+
+void Indicators::ema(span<const double> x, size_t period, span<double> out)
+{
+    check(period, x.size(), out.size(), "ema");
+    fill_warmup(out, period - 1);
+    if (x.size() < period) return;
+
+    // a recurrence: no lanes to spread it over, but the same ops as Ema::update
+    double alpha = 2.0 / (static_cast<double>(period) + 1.0);
+    double sum = 0.0;
+    for (size_t i = 0; i < period; ++i) {
+        sum += x[i];
+    }
+    double ema = sum / static_cast<double>(period);
+    out[period - 1] = ema;
+    for (size_t i = period; i < x.size(); ++i) {
+        ema = fma(alpha, x[i] - ema, ema);
+        out[i] = ema;
+    }
+}
+
+void Indicators::rsi(span<const double> close, size_t period, span<double> out)
+{
+    check(period, close.size(), out.size(), "rsi");
+    fill_warmup(out, period);
+    if (close.size() <= period) return;
+
+    double* gain = scratch(0, close.size());
+    double* loss = scratch(1, close.size());
+    if (use_avx2_fma()) {
+        changes_avx2(close.data(), close.size(), gain, loss);
+    } else {
+        changes_scalar(close.data(), close.size(), gain, loss);
+    }
+
+    // both Wilder averages in one pass: two independent divide chains overlap
+    double n = static_cast<double>(period);
+    double avg_gain = 0.0, avg_loss = 0.0;
+    for (size_t i = 1; i < period; ++i) {
+        avg_gain += gain[i];
+        avg_loss += loss[i];
+    }
+    avg_gain = (avg_gain + gain[period]) / n;
+    avg_loss = (avg_loss + loss[period]) / n;
+    out[period] = indicator_detail::rsi_from(avg_gain, avg_loss);
+    for (size_t i = period + 1; i < close.size(); ++i) {
+        avg_gain = fma(avg_gain, n - 1.0, gain[i]) / n;
+        avg_loss = fma(avg_loss, n - 1.0, loss[i]) / n;
+        out[i] = indicator_detail::rsi_from(avg_gain, avg_loss);
+    }
+}
+
+void Indicators::atr(span<const double> high, span<const double> low, span<const double> close, size_t period,
+                     span<double> out)
+{
+    check(period, close.size(), out.size(), "atr");
+    if (high.size() != close.size() || low.size() != close.size()) {
+        throw runtime_error("atr: high/low/close columns differ in length");
+    }
+    fill_warmup(out, period - 1);
+    if (close.size() < period) return;
+
+    double* tr = scratch(0, close.size());
+    tr[0] = high[0] - low[0];
+    if (use_avx2_fma()) {
+        true_range_avx2(high.data(), low.data(), close.data(), close.size(), tr);
+    } else {
+        true_range_scalar(high.data(), low.data(), close.data(), close.size(), tr);
+    }
+    wilder(tr, 0, close.size(), period, [&](size_t i, double avg) { out[i] = avg; });
+}
+
+void Indicators::bollinger(span<const double> x, size_t period, double width, span<double> middle,
+                           span<double> upper, span<double> lower)
+{
+    check(period, x.size(), middle.size(), "bollinger");
+    if (upper.size() != x.size() || lower.size() != x.size()) {
+        throw runtime_error("bollinger: band columns differ in length from the input");
+    }
+    fill_warmup(middle, period - 1);
+    fill_warmup(upper, period - 1);
+    fill_warmup(lower, period - 1);
+    if (x.size() < period) return;
+
+    // deviations from the first sample, summed exactly like Bollinger::update
+    double shift = x[0];
+    Prefix sums(x.size(), 0), squares(x.size(), 2);
+    indicator_detail::CompensatedSum s, q;
+    sums.set(0, s);
+    squares.set(0, q);
+    for (size_t k = 0; k < x.size(); ++k) {
+        double d = x[k] - shift;
+        s.add(d);
+        q.add_product(d, d);
+        sums.set(k + 1, s);
+        squares.set(k + 1, q);
+    }
+    Bands bands{middle.data(), upper.data(), lower.data()};
+    if (use_avx2_fma()) {
+        bands_avx2(sums, squares, x.size(), period, shift, width, bands);
+    } else {
+        bands_scalar(sums, squares, period - 1, x.size(), period, shift, width, bands);
+    }
+}
+
+void Indicators::vwap(span<const double> high, span<const double> low, span<const double> close,
+                      span<const double> volume, size_t period, span<double> out)
+{
+    check(period ? period : 1, close.size(), out.size(), "vwap");
+    if (high.size() != close.size() || low.size() != close.size() || volume.size() != close.size()) {
+        throw runtime_error("vwap: high/low/close/volume columns differ in length");
+    }
+    size_t bars = close.size();
+    double* typical = scratch(4, bars);
+    if (use_avx2_fma()) {
+        typical_avx2(high.data(), low.data(), close.data(), bars, typical);
+    } else {
+        typical_scalar(high.data(), low.data(), close.data(), bars, typical);
+    }
+
+    Prefix pv(bars, 0), v(bars, 2);
+    indicator_detail::CompensatedSum pv_sum, v_sum;
+    pv.set(0, pv_sum);
+    v.set(0, v_sum);
+    for (size_t k = 0; k < bars; ++k) {
+        pv_sum.add_product(typical[k], volume[k]);
+        v_sum.add(volume[k]);
+        pv.set(k + 1, pv_sum);
+        v.set(k + 1, v_sum);
+    }
+
+    if (period == 0) {
+        for (size_t i = 0; i < bars; ++i) {
+            out[i] = (pv.hi[i + 1] + pv.lo[i + 1]) / (v.hi[i + 1] + v.lo[i + 1]);
+        }
+        return;
+    }
+    fill_warmup(out, period - 1);
+    if (bars < period) return;
+    if (use_avx2_fma()) {
+        window_ratio_avx2(pv, v, bars, period, out.data());
+    } else {
+        window_ratio_scalar(pv, v, period - 1, bars, period, out.data());
+    }
+}
+
+void Indicators::rolling_max(span<const double> x, size_t period, span<double> out)
+{
+    check(period, x.size(), out.size(), "rolling_max");
+    // the deque is inherently sequential; amortised O(1) per bar either way
+    indicator_detail::MonotonicWindow<indicator_detail::KeepGreater> window(period);
+    for (size_t i = 0; i < x.size(); ++i) {
+        out[i] = window.update(x[i]);
+    }
+}
+
+void Indicators::rolling_min(span<const double> x, size_t period, span<double> out)
+{
+    check(period, x.size(), out.size(), "rolling_min");
+    indicator_detail::MonotonicWindow<indicator_detail::KeepLess> window(period);
+    for (size_t i = 0; i < x.size(); ++i) {
+        out[i] = window.update(x[i]);
+    }
+}
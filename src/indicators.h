@@ -0,0 +1,405 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <vector>
+#include "simd_dispatch.h"
+#include "types.h"
+
+using namespace std;
+
+/* --- Technical indicators, batch and incremental.
+Every indicator comes twice: a batch function in Indicators that fills a whole column
+(AVX2 where the math allows it), and a small class with an O(1) update() for bar-by-bar
+use in strategies and the live pipeline. Both evaluate the same IEEE operations in the
+same order, so they agree bit for bit: windowed means come from running prefix sums,
+recurrences (EMA, Wilder smoothing) use explicit fma(), and nothing is left for the
+compiler to contract. Bars before a window is full are NaN in both modes.
+
+Prefix sums are compensated (two-sum), so O(1) windows don't lose precision as the
+running total grows over millions of bars. Bollinger sums deviations from the first
+sample to keep the variance subtraction well conditioned. */
+
+// ---- incremental (per bar)
+
+namespace indicator_detail {
+
+constexpr double kNaN = numeric_limits<double>::quiet_NaN();
+
+inline double true_range(double high, double low, double prev_close)
+{
+    double hl = high - low;
+    double hc = fabs(high - prev_close);
+    double lc = fabs(low - prev_close);
+    return max_of(max_of(hl, hc), lc);
+}
+
+// E[d^2] - mean^2 cancels to a few ulps of E[d^2] when the spread is ~0 (constant
+// prices, period 1); anything under that floor is rounding noise, not variance
+constexpr double kVarianceFloor = 16 * numeric_limits<double>::epsilon();
+
+inline double clamp_variance(double variance, double mean_square)
+{
+    return variance > kVarianceFloor * mean_square ? variance : 0.0;
+}
+
+inline double rsi_from(double avg_gain, double avg_loss)
+{
+    if (avg_loss == 0.0) {
+        return avg_gain == 0.0 ? 50.0 : 100.0;
+    }
+    return 100.0 - 100.0 / (1.0 + avg_gain / avg_loss);
+}
+
+// Knuth's two-sum: a + b == sum + err exactly
+inline void two_sum(double a, double b, double& sum, double& err)
+{
+    sum = a + b;
+    double bb = sum - a;
+    err = (a - (sum - bb)) + (b - bb);
+}
+
+// Compensated running sum: hi carries the sum, lo the rounding error two-sum recovered.
+// Window sums (hi_i - hi_j) + (lo_i - lo_j) stay accurate however large the total grows.
+struct CompensatedSum
+{
+    double hi = 0.0;
+    double lo = 0.0;
+
+    void add(double x)
+    {
+        double err;
+        two_sum(hi, x, hi, err);
+        lo = lo + err;
+    }
+
+    // adds a * b, keeping the product's rounding error too
+    void add_product(double a, double b)
+    {
+        double p = a * b;
+        double p_err = fma(a, b, -p);
+        double err;
+        two_sum(hi, p, hi, err);
+        lo = lo + (err + p_err);
+    }
+
+    double value() const { return hi + lo; }
+};
+
+inline double window_sum(double hi_end, double lo_end, double hi_begin, double lo_begin)
+{
+    return (hi_end - hi_begin) + (lo_end - lo_begin);
+}
+
+// Running compensated prefix sum plus the last period+1 prefix values: window sums in O(1)
+class PrefixWindow
+{
+public:
+    explicit PrefixWindow(size_t period) : hi_(period + 1, 0.0), lo_(period + 1, 0.0), period_(period) {}
+
+    void add(double x)
+    {
+        sum_.add(x);
+        push();
+    }
+    void add_product(double a, double b)
+    {
+        sum_.add_product(a, b);
+        push();
+    }
+
+    size_t count() const { return count_; }
+    bool full() const { return count_ >= period_; }
+    double total() const { return sum_.value(); }
+    // sum of the last `period` values, valid once full()
+    double window() const
+    {
+        size_t begin = (count_ - period_) % (period_ + 1);
+        return window_sum(sum_.hi, sum_.lo, hi_[begin], lo_[begin]);
+    }
+
+private:
+    void push()
+    {
+        ++count_;
+        hi_[count_ % (period_ + 1)] = sum_.hi;
+        lo_[count_ % (period_ + 1)] = sum_.lo;
+    }
+
+    vector<double> hi_;
+    vector<double> lo_;
+    size_t period_;
+    size_t count_ = 0;
+    CompensatedSum sum_;
+};
+
+// Monotonic deque over the last `period` values in a fixed ring; Better(a, b) keeps a over b
+template <typename Better>
+class MonotonicWindow
+{
+public:
+    explicit MonotonicWindow(size_t period) : values_(period), indices_(period), period_(period) {}
+
+    // pushes x and returns the extreme of the last `period` values (NaN until full)
+    double update(double x)
+    {
+        size_t i = count_++;
+        while (size_ > 0 && !Better{}(values_[back()], x)) {
+            --size_;
+        }
+        if (size_ > 0 && indices_[head_] + period_ <= i) {
+            head_ = (head_ + 1) % period_;
+            --size_;
+        }
+        size_t slot = (head_ + size_) % period_;
+        values_[slot] = x;
+        indices_[slot] = i;
+        ++size_;
+        return count_ >= period_ ? values_[head_] : kNaN;
+    }
+
+private:
+    size_t back() const { return (head_ + size_ - 1) % period_; }
+
+    vector<double> values_;
+    vector<size_t> indices_;
+    size_t period_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+    size_t count_ = 0;
+};
+
+struct KeepGreater { bool operator()(double kept, double x) const { return kept > x; } };
+struct KeepLess { bool operator()(double kept, double x) const { return kept < x; } };
+
+inline size_t checked_period(size_t period)
+{
+    if (period == 0) {
+        throw runtime_error("Indicator period must be positive");
+    }
+    return period;
+}
+
+}
+
+class Sma
+{
+public:
+    explicit Sma(size_t period) : window_(indicator_detail::checked_period(period)), period_(period) {}
+
+    double update(double x)
+    {
+        window_.add(x);
+        return window_.full() ? window_.window() / static_cast<double>(period_) : indicator_detail::kNaN;
+    }
+
+private:
+    indicator_detail::PrefixWindow window_;
+    size_t period_;
+};
+
+// Seeded with the SMA of the first `period` values, then e += alpha * (x - e)
+class Ema
+{
+public:
+    explicit Ema(size_t period)
+        : period_(indicator_detail::checked_period(period)), alpha_(2.0 / (static_cast<double>(period) + 1.0)) {}
+
+    double update(double x)
+    {
+        if (count_ < period_) {
+            sum_ += x;
+            if (++count_ < period_) return indicator_detail::kNaN;
+            ema_ = sum_ / static_cast<double>(period_);
+            return ema_;
+        }
+        ema_ = fma(alpha_, x - ema_, ema_);
+        return ema_;
+    }
+
+private:
+    size_t period_;
+    double alpha_;
+    size_t count_ = 0;
+    double sum_ = 0.0;
+    double ema_ = 0.0;
+};
+
+// Wilder's RSI; the first value is out at bar `period` (it needs period price changes)
+class Rsi
+{
+public:
+    explicit Rsi(size_t period) : period_(indicator_detail::checked_period(period)) {}
+
+    double update(double x)
+    {
+        size_t i = count_++;
+        if (i == 0) {
+            prev_ = x;
+            return indicator_detail::kNaN;
+        }
+        double gain = max_of(x - prev_, 0.0);
+        double loss = max_of(prev_ - x, 0.0);
+        prev_ = x;
+
+        double n = static_cast<double>(period_);
+        if (i < period_) {
+            avg_gain_ += gain;
+            avg_loss_ += loss;
+            return indicator_detail::kNaN;
+        }
+        if (i == period_) {
+            avg_gain_ = (avg_gain_ + gain) / n;
+            avg_loss_ = (avg_loss_ + loss) / n;
+        } else {
+            avg_gain_ = fma(avg_gain_, n - 1.0, gain) / n;
+            avg_loss_ = fma(avg_loss_, n - 1.0, loss) / n;
+        }
+        return indicator_detail::rsi_from(avg_gain_, avg_loss_);
+    }
+
+private:
+    size_t period_;
+    size_t count_ = 0;
+    double prev_ = 0.0;
+    double avg_gain_ = 0.0;   // running sums until the first value, then Wilder averages
+    double avg_loss_ = 0.0;
+};
+
+// Wilder's ATR; the first bar's true range is just high - low
+class Atr
+{
+public:
+    explicit Atr(size_t period) : period_(indicator_detail::checked_period(period)) {}
+
+    double update(double high, double low, double close)
+    {
+        size_t i = count_++;
+        double tr = i == 0 ? high - low : indicator_detail::true_range(high, low, prev_close_);
+        prev_close_ = close;
+
+        double n = static_cast<double>(period_);
+        if (i + 1 < period_) {
+            atr_ += tr;
+            return indicator_detail::kNaN;
+        }
+        atr_ = i + 1 == period_ ? (atr_ + tr) / n : fma(atr_, n - 1.0, tr) / n;
+        return atr_;
+    }
+    double update(const Kline& kline) { return update(kline.high, kline.low, kline.close); }
+
+private:
+    size_t period_;
+    size_t count_ = 0;
+    double prev_close_ = 0.0;
+    double atr_ = 0.0;
+};
+
+struct BollingerBand
+{
+    double middle;
+    double upper;
+    double lower;
+};
+
+// SMA middle band +- width * population standard deviation
+class Bollinger
+{
+public:
+    Bollinger(size_t period, double width)
+        : sum_(indicator_detail::checked_period(period)), squares_(period), period_(period), width_(width) {}
+
+    BollingerBand update(double x)
+    {
+        if (sum_.count() == 0) shift_ = x;
+        double d = x - shift_;
+        sum_.add(d);
+        squares_.add_product(d, d);
+        if (!sum_.full()) {
+            return {indicator_detail::kNaN, indicator_detail::kNaN, indicator_detail::kNaN};
+        }
+        double n = static_cast<double>(period_);
+        double mean = sum_.window() / n;
+        double mean_square = squares_.window() / n;
+        double variance = indicator_detail::clamp_variance(fma(-mean, mean, mean_square), mean_square);
+        double sd = sqrt(variance);
+        double middle = mean + shift_;
+        return {middle, fma(width_, sd, middle), fma(-width_, sd, middle)};
+    }
+
+private:
+    indicator_detail::PrefixWindow sum_;
+    indicator_detail::PrefixWindow squares_;
+    size_t period_;
+    double width_;
+    double shift_ = 0.0;
+};
+
+// Volume-weighted typical price (high + low + close) / 3 over the last `period` bars;
+// period 0 anchors it at the first bar (classic session VWAP). 0/0 volume gives NaN.
+class Vwap
+{
+public:
+    explicit Vwap(size_t period) : price_volume_(period ? period : 1), volume_(period ? period : 1), period_(period) {}
+
+    double update(double high, double low, double close, double volume)
+    {
+        double typical = (high + low + close) / 3.0;
+        price_volume_.add_product(typical, volume);
+        volume_.add(volume);
+        if (period_ == 0) {
+            return price_volume_.total() / volume_.total();
+        }
+        return volume_.full() ? price_volume_.window() / volume_.window() : indicator_detail::kNaN;
+    }
+    double update(const Kline& kline) { return update(kline.high, kline.low, kline.close, kline.volume); }
+
+private:
+    indicator_detail::PrefixWindow price_volume_;
+    indicator_detail::PrefixWindow volume_;
+    size_t period_;
+};
+
+class RollingMax
+{
+public:
+    explicit RollingMax(size_t period) : window_(indicator_detail::checked_period(period)) {}
+    double update(double x) { return window_.update(x); }
+
+private:
+    indicator_detail::MonotonicWindow<indicator_detail::KeepGreater> window_;
+};
+
+class RollingMin
+{
+public:
+    explicit RollingMin(size_t period) : window_(indicator_detail::checked_period(period)) {}
+    double update(double x) { return window_.update(x); }
+
+private:
+    indicator_detail::MonotonicWindow<indicator_detail::KeepLess> window_;
+};
+
+// ---- batch (whole columns)
+
+// Column versions of the classes above. `out` must be as long as the input; results are
+// bit-identical to calling update() bar by bar. Throws runtime_error on bad arguments.
+class Indicators
+{
+public:
+    static void sma(span<const double> x, size_t period, span<double> out);
+    static void ema(span<const double> x, size_t period, span<double> out);
+    static void rsi(span<const double> close, size_t period, span<double> out);
+    static void atr(span<const double> high, span<const double> low, span<const double> close, size_t period,
+                    span<double> out);
+    static void bollinger(span<const double> x, size_t period, double width, span<double> middle,
+                          span<double> upper, span<double> lower);
+    static void vwap(span<const double> high, span<const double> low, span<const double> close,
+                     span<const double> volume, size_t period, span<double> out);
+    static void rolling_max(span<const double> x, size_t period, span<double> out);
+    static void rolling_min(span<const double> x, size_t period, span<double> out);
+};
@@ -0,0 +1,272 @@
+#include "kline_cache.h"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <stdexcept>
+#include <sys/file.h>
+#include <unistd.h>
+#include "htx_store.h"
+#include "parser.h"
+#include "timing.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace {
+
+// more range files than this per (symbol, interval) triggers a compaction
+constexpr size_t kMaxSegments = 32;
+
+// symbols and intervals become directory names: [A-Za-z0-9]+ only, so no "..", separators
+// or hidden files can reach the path
+bool is_key_part(const string& part)
+{
+    return !part.empty() && all_of(part.begin(), part.end(), [](char c) {
+        return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9');
+    });
+}
+
+// flock on a lock file, released when the object (and its fd) goes away
+class DirLock {
+public:
+    DirLock(const string& path, bool exclusive)
+    {
+        fd_ = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd_ < 0) {
+            throw runtime_error("Cannot open cache lock " + path + ": " + strerror(errno));
+        }
+        lock(exclusive);
+    }
+    ~DirLock() { close(fd_); }
+
+    DirLock(const DirLock&) = delete;
+    DirLock& operator=(const DirLock&) = delete;
+
+    // converting shared -> exclusive is not atomic, callers re-check after it
+    void lock(bool exclusive)
+    {
+        while (flock(fd_, exclusive ? LOCK_EX : LOCK_SH) != 0) {
+            if (errno != EINTR) {
+                throw runtime_error(string("flock failed: ") + strerror(errno));
+            }
+        }
+    }
+
+private:
+    int fd_ = -1;
+};
+
+bool parse_u64(string_view text, uint64_t& value)
+{
+    auto [ptr, ec] = from_chars(text.data(), text.data() + text.size(), value);
+    return ec == errc() && ptr == text.data() + text.size();
+}
+
+string segment_name(TimeRange range)
+{
+    return to_string(range.start_ms) + "-" + to_string(range.end_ms) + ".htx";
+}
+
+// appends the rows of one range file that fall in [start_ms, end_ms)
+void append_range(const string& path, uint32_t symbol_id, uint64_t start_ms, uint64_t end_ms, vector<Kline>& out)
+{
+    HtxReader reader(path);
+    size_t first = reader.lower_bound(start_ms);
+    size_t last = reader.lower_bound(end_ms);
+    auto ts = reader.timestamp_ms();
+    auto o = reader.open(), h = reader.high(), l = reader.low(), c = reader.close(), v = reader.volume();
+    for (size_t i = first; i < last; ++i) {
+        out.push_back(Kline{ts[i], 0, symbol_id, o[i], h[i], l[i], c[i], v[i]});
+    }
+}
+
+}
+
+KlineCache::KlineCache(const string& cache_dir, BinanceClient& client, RangeFetchOptions options)
+    : cache_dir_(cache_dir), client_(client), options_(options) {}
+
+string KlineCache::key_dir(const string& symbol, const string& interval) const
+{
+    if (!is_key_part(symbol) || !is_key_part(interval)) {
+        throw runtime_error("Invalid cache key: " + symbol + " " + interval);
+    }
+    return (fs::path(cache_dir_) / symbol / interval).string();
+}
+
+vector<KlineCache::Segment> KlineCache::list_segments(const string& dir)
+{
+    vector<Segment> segments;
+    if (!fs::exists(dir)) {
+        return segments;
+    }
+    for (const auto& entry : fs::directory_iterator(dir)) {
+        if (!entry.is_regular_file() || entry.path().extension() != ".htx") {
+            continue;
+        }
+        // "<start>-<end>.htx", anything else (temp files from a crashed writer) is ignored
+        string stem = entry.path().stem().string();
+        size_t dash = stem.find('-');
+        TimeRange range{};
+        if (dash == string::npos ||
+            !parse_u64(string_view(stem).substr(0, dash), range.start_ms) ||
+            !parse_u64(string_view(stem).substr(dash + 1), range.end_ms) ||
+            range.end_ms <= range.start_ms) {
+            continue;
+        }
+        segments.push_back(Segment{range, entry.path().string()});
+    }
+    sort(segments.begin(), segments.end(),
+         [](const Segment& a, const Segment& b) { return a.range.start_ms < b.range.start_ms; });
+    return segments;
+}
+
+vector<TimeRange> KlineCache::gaps(const vector<Segment>& segments, uint64_t start_ms, uint64_t end_ms)
+{
+    vector<TimeRange> result;
+    uint64_t cursor = start_ms;
+    for (const auto& segment : segments) {
+        if (cursor >= end_ms) break;
+        if (segment.range.end_ms <= cursor) continue;
+        if (segment.range.start_ms > cursor) {
+            result.push_back(TimeRange{cursor, min(segment.range.start_ms, end_ms)});
+        }
+        cursor = max(cursor, segment.range.end_ms);
+    }
+    if (cursor < end_ms) {
+        result.push_back(TimeRange{cursor, end_ms});
+    }
+    return result;
+}
+
+void KlineCache::write_segment(const string& dir, const string& symbol, TimeRange range, const vector<Kline>& klines)
+{
+    // write under a temp name and rename, readers never see a half-written file
+    string path = (fs::path(dir) / segment_name(range)).string();
+    string tmp = path + ".tmp";
+    HtxWriter::write(tmp, klines, {symbol});
+    fs::rename(tmp, path);
+}
+
+vector<TimeRange> KlineCache::missing(const string& symbol, const string& interval, uint64_t start_ms, uint64_t end_ms) const
+{
+    if (end_ms <= start_ms) return {};
+    string dir = key_dir(symbol, interval);
+    if (!fs::exists(dir)) return {TimeRange{start_ms, end_ms}};
+    DirLock lock((fs::path(dir) / ".lock").string(), false);
+    return gaps(list_segments(dir), start_ms, end_ms);
+}
+
+vector<Kline> KlineCache::get(const string& symbol, const string& interval, uint64_t start_ms, uint64_t end_ms)
+{
+    stats_ = CacheStats{};
+    if (end_ms <= start_ms) return {};
+
+    const uint64_t step_ms = BinanceClient::interval_ms(interval);
+    const uint32_t symbol_id = Parser::symbol_to_id(symbol);
+    string dir = key_dir(symbol, interval);
+    fs::create_directories(dir);
+
+    DirLock lock((fs::path(dir) / ".lock").string(), false);
+    vector<Segment> segments = list_segments(dir);
+    vector<TimeRange> todo = gaps(segments, start_ms, end_ms);
+
+    // bars that haven't closed yet: returned to the caller, never cached
+    vector<Kline> open_bars;
+    size_t written = 0;
+    if (!todo.empty()) {
+        lock.lock(true);
+        // someone may have filled the gaps while we waited for the exclusive lock
+        segments = list_segments(dir);
+        todo = gaps(segments, start_ms, end_ms);
+
+        // Closure is decided per bar: bars aren't aligned to the epoch (1w opens on Monday,
+        // the epoch was a Thursday), so a floor of now to the interval says nothing.
+        // A bar that opened before `horizon` has closed whatever its alignment, which
+        // lets empty stretches (before a listing) be cached too.
+        uint64_t now_ms = wall_clock_us() / 1000;
+        uint64_t horizon = now_ms >= step_ms ? now_ms - step_ms + 1 : 0;
+        for (const auto& gap : todo) {
+            vector<Kline> fetched = client_.fetch_klines_range(symbol, interval, gap.start_ms, gap.end_ms, options_);
+            ++stats_.fetched_ranges;
+            stats_.fetched_klines += fetched.size();
+
+            auto split = partition_point(fetched.begin(), fetched.end(),
+                                         [&](const Kline& k) { return k.timestamp_ms + step_ms <= now_ms; });
+            // covered up to the end of the last closed bar, or the start of the first open one
+            uint64_t covered = horizon;
+            if (split != fetched.begin()) covered = max(covered, prev(split)->timestamp_ms + step_ms);
+            if (split != fetched.end()) covered = max(covered, split->timestamp_ms);
+            TimeRange cached{gap.start_ms, min(gap.end_ms, covered)};
+            for (auto it = split; it != fetched.end(); ++it) {
+                open_bars.push_back(*it);
+            }
+            fetched.erase(split, fetched.end());
+            if (cached.end_ms > cached.start_ms) {
+                write_segment(dir, symbol, cached, fetched);
+                written += fetched.size();
+            }
+        }
+
+        segments = list_segments(dir);
+        if (segments.size() > kMaxSegments) {
+            compact_locked(dir, symbol);
+            segments = list_segments(dir);
+        }
+    }
+
+    // everything that is on disk now comes straight out of the mmapped files
+    vector<Kline> klines;
+    klines.reserve((end_ms - start_ms) / step_ms + 1);
+    // (read_to skips overlap left behind by a compaction that died half way)
+    uint64_t read_to = start_ms;
+    for (const auto& segment : segments) {
+        uint64_t from = max(read_to, segment.range.start_ms);
+        uint64_t to = min(end_ms, segment.range.end_ms);
+        if (from >= to) continue;
+        append_range(segment.path, symbol_id, from, to, klines);
+        read_to = to;
+    }
+    stats_.cached_klines = klines.size() - written;
+
+    for (auto& kline : open_bars) {
+        kline.symbol_id = symbol_id;
+        klines.push_back(kline);
+    }
+    return klines;
+}
+
+size_t KlineCache::compact(const string& symbol, const string& interval)
+{
+    string dir = key_dir(symbol, interval);
+    if (!fs::exists(dir)) return 0;
+    DirLock lock((fs::path(dir) / ".lock").string(), true);
+    return compact_locked(dir, symbol);
+}
+
+size_t KlineCache::compact_locked(const string& dir, const string& symbol)
+{
+    vector<Segment> segments = list_segments(dir);
+    size_t files = 0;
+    for (size_t i = 0; i < segments.size();) {
+        // run of files where each one starts exactly where the previous ended
+        size_t j = i + 1;
+        while (j < segments.size() && segments[j].range.start_ms == segments[j - 1].range.end_ms) ++j;
+        ++files;
+        if (j - i > 1) {
+            TimeRange merged{segments[i].range.start_ms, segments[j - 1].range.end_ms};
+            vector<Kline> klines;
+            for (size_t k = i; k < j; ++k) {
+                append_range(segments[k].path, 0, segments[k].range.start_ms, segments[k].range.end_ms, klines);
+            }
+            write_segment(dir, symbol, merged, klines);
+            for (size_t k = i; k < j; ++k) {
+                fs::remove(segments[k].path);
+            }
+        }
+        i = j;
+    }
+    return files;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "binance_client.h"
+#include "types.h"
+
+using namespace std;
+
+// half-open [start_ms, end_ms)
+struct TimeRange {
+    uint64_t start_ms;
+    uint64_t end_ms;
+};
+
+// what the last KlineCache::get had to do
+struct CacheStats {
+    size_t fetched_ranges = 0;  // gaps downloaded
+    size_t fetched_klines = 0;
+    size_t cached_klines = 0;   // served from disk
+};
+
+// On-disk kline cache in front of BinanceClient.
+//
+// Layout: <cache_dir>/<SYMBOL>/<interval>/<start_ms>-<end_ms>.htx, one file per downloaded
+// range. The file name records what range was asked for (so empty stretches, e.g. before a
+// listing, count as covered too) and the body is a plain mmapped .htx file.
+// get() works out which parts of the requested range no file covers, fetches only those,
+// and serves the rest from the mmapped files. An flock on <interval>/.lock makes concurrent
+// processes safe: readers share it, a run that has to fetch takes it exclusively.
+class KlineCache {
+public:
+    KlineCache(const string& cache_dir, BinanceClient& client, RangeFetchOptions options = {});
+
+    // klines with open time in [start_ms, end_ms), symbol_id from Parser's symbol table.
+    // Bars that have not closed yet are returned but never written to disk.
+    vector<Kline> get(const string& symbol, const string& interval, uint64_t start_ms, uint64_t end_ms);
+
+    // sub-ranges of [start_ms, end_ms) that get() would have to download
+    vector<TimeRange> missing(const string& symbol, const string& interval, uint64_t start_ms, uint64_t end_ms) const;
+
+    // merges runs of touching range files into one file each, returns the file count after
+    size_t compact(const string& symbol, const string& interval);
+
+    const CacheStats& last_stats() const { return stats_; }
+
+private:
+    struct Segment {
+        TimeRange range;
+        string path;
+    };
+
+    string cache_dir_;
+    BinanceClient& client_;
+    RangeFetchOptions options_;
+    CacheStats stats_;
+
+    string key_dir(const string& symbol, const string& interval) const;
+    static vector<Segment> list_segments(const string& dir);
+    static vector<TimeRange> gaps(const vector<Segment>& segments, uint64_t start_ms, uint64_t end_ms);
+    static void write_segment(const string& dir, const string& symbol, TimeRange range, const vector<Kline>& klines);
+    static size_t compact_locked(const string& dir, const string& symbol);
+};
@@ -0,0 +1,231 @@
+#include "kline_json_decoder.h"
+#include "csv_scanner.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+// columns we keep: open time, OHLC and quote asset volume (what the old DOM parser read)
+inline bool wanted_field(uint32_t field)
+{
+    return field <= 4 || field == 7;
+}
+
+inline bool is_space(char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+inline bool is_number_char(char c)
+{
+    return static_cast<unsigned>(c - '0') < 10 || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+}
+
+constexpr size_t kMaxErrorBody = 256;
+
+}
+
+KlineJsonDecoder::KlineJsonDecoder(uint64_t fetch_time_ms, uint32_t symbol_id)
+    : fetch_time_ms_(fetch_time_ms), symbol_id_(symbol_id) {}
+
+void KlineJsonDecoder::reset(uint64_t fetch_time_ms)
+{
+    klines_.clear();
+    fetch_time_ms_ = fetch_time_ms;
+    state_ = State::Start;
+    field_ = 0;
+    token_len_ = 0;
+    error_.clear();
+}
+
+void KlineJsonDecoder::fail(const string& what)
+{
+    state_ = State::Failed;
+    error_ = what;
+}
+
+void KlineJsonDecoder::append_token(const char* begin, const char* end)
+{
+    if (!wanted_field(field_)) return;
+    size_t n = static_cast<size_t>(end - begin);
+    if (token_len_ + n > kMaxToken) {
+        fail("kline field " + to_string(field_) + " too long");
+        return;
+    }
+    memcpy(token_ + token_len_, begin, n);
+    token_len_ += static_cast<uint32_t>(n);
+}
+
+void KlineJsonDecoder::begin_row()
+{
+    row_ = Kline{0, fetch_time_ms_, symbol_id_, 0.0, 0.0, 0.0, 0.0, 0.0};
+    field_ = 0;
+    token_len_ = 0;
+    state_ = State::FieldStart;
+}
+
+void KlineJsonDecoder::end_field()
+{
+    state_ = State::AfterField;
+    if (!wanted_field(field_)) return;
+
+    string_view token(token_, token_len_);
+    token_len_ = 0;
+    if (field_ == 0) {
+        auto [ptr, ec] = from_chars(token.data(), token.data() + token.size(), row_.timestamp_ms);
+        if (ec != errc() || ptr != token.data() + token.size()) {
+            fail("Invalid kline open time: '" + string(token) + "'");
+        }
+        return;
+    }
+
+    double value = 0.0;
+    try {
+        value = CsvScanner::parse_decimal(token);
+    } catch (const exception& e) {
+        fail(e.what());
+        return;
+    }
+    switch (field_) {
+        case 1: row_.open = value; break;
+        case 2: row_.high = value; break;
+        case 3: row_.low = value; break;
+        case 4: row_.close = value; break;
+        default: row_.volume = value; break;
+    }
+}
+
+void KlineJsonDecoder::end_row()
+{
+    // need every column up to the quote volume
+    if (field_ < 8) {
+        fail("kline row has " + to_string(field_) + " fields, expected at least 8");
+        return;
+    }
+    klines_.push_back(row_);
+    state_ = State::AfterRow;
+}
+
+bool KlineJsonDecoder::feed(const char* data, size_t len)
+{
+    const char* p = data;
+    const char* end = data + len;
+
+    while (p < end) {
+        switch (state_) {
+            case State::String: {
+                // bulk copy up to the closing quote (Binance never escapes inside numbers)
+                const char* quote = static_cast<const char*>(memchr(p, '"', static_cast<size_t>(end - p)));
+                const char* stop = quote ? quote : end;
+                append_token(p, stop);
+                p = stop;
+                if (quote && state_ != State::Failed) {
+                    ++p;
+                    end_field();
+                }
+                continue;
+            }
+            case State::Number: {
+                const char* stop = p;
+                while (stop < end && is_number_char(*stop)) ++stop;
+                append_token(p, stop);
+                p = stop;
+                // the terminating byte is handled by AfterField
+                if (p < end && state_ != State::Failed) end_field();
+                continue;
+            }
+            case State::ErrorObject: {
+                size_t n = min(static_cast<size_t>(end - p), kMaxErrorBody - min(kMaxErrorBody, error_.size()));
+                error_.append(p, n);
+                return true;
+            }
+            case State::Failed:
+                return false;
+            default:
+                break;
+        }
+
+        char c = *p++;
+        if (is_space(c)) continue;
+
+        switch (state_) {
+            case State::Start:
+                if (c == '[') {
+                    state_ = State::RowOrEnd;
+                } else if (c == '{') {
+                    state_ = State::ErrorObject;
+                    error_ = "{";
+                } else {
+                    fail(string("Expected '[' at start of klines JSON, got '") + c + "'");
+                }
+                break;
+            case State::RowOrEnd:
+                if (c == '[') begin_row();
+                else if (c == ']') state_ = State::Done;
+                else fail(string("Expected kline row, got '") + c + "'");
+                break;
+            case State::RowStart:
+                if (c == '[') begin_row();
+                else fail(string("Expected kline row, got '") + c + "'");
+                break;
+            case State::FieldStart:
+                if (c == '"') {
+                    state_ = State::String;
+                } else if (is_number_char(c)) {
+                    state_ = State::Number;
+                    append_token(p - 1, p);
+                } else {
+                    fail(string("Unexpected '") + c + "' in kline field " + to_string(field_));
+                }
+                break;
+            case State::AfterField:
+                if (c == ',') {
+                    ++field_;
+                    state_ = State::FieldStart;
+                } else if (c == ']') {
+                    ++field_;
+                    end_row();
+                } else {
+                    fail(string("Unexpected '") + c + "' after kline field " + to_string(field_));
+                }
+                break;
+            case State::AfterRow:
+                if (c == ',') state_ = State::RowStart;
+                else if (c == ']') state_ = State::Done;
+                else fail(string("Unexpected '") + c + "' between kline rows");
+                break;
+            case State::Done:
+                fail("Trailing data after klines JSON");
+                break;
+            default:
+                break;
+        }
+    }
+    return state_ != State::Failed;
+}
+
+void KlineJsonDecoder::finish()
+{
+    switch (state_) {
+        case State::Done:
+            return;
+        case State::ErrorObject:
+            throw runtime_error("Binance API error: " + error_);
+        case State::Failed:
+            throw runtime_error(error_);
+        default:
+            throw runtime_error("Truncated klines JSON");
+    }
+}
+
+vector<Kline> KlineJsonDecoder::decode(string_view json, uint64_t fetch_time_ms)
+{
+    KlineJsonDecoder decoder(fetch_time_ms);
+    decoder.feed(json);
+    decoder.finish();
+    return move(decoder.klines_);
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "types.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+// Streaming decoder for the /api/v3/klines response shape:
+//   [[open_time,"open","high","low","close","volume",close_time,"quote_volume",...],...]
+// A byte-level state machine that writes straight into Klines, no DOM and no per-field
+// strings. Bytes can be fed in any chunking (e.g. from the curl write callback as they
+// arrive), a field split across two chunks is carried over in a small fixed buffer.
+class KlineJsonDecoder {
+public:
+    explicit KlineJsonDecoder(uint64_t fetch_time_ms = 0, uint32_t symbol_id = 0);
+
+    // start a new document, drops previously decoded klines (keeps their capacity)
+    void reset(uint64_t fetch_time_ms);
+    void reserve(size_t rows) { klines_.reserve(rows); }
+
+    // Next bytes of the document. Never throws so it is safe inside a C callback;
+    // returns false once the input is known to be bad, finish() reports why.
+    bool feed(const char* data, size_t len);
+    bool feed(string_view chunk) { return feed(chunk.data(), chunk.size()); }
+
+    // end of input: throws runtime_error on malformed/truncated JSON or an API error object
+    void finish();
+
+    vector<Kline>& klines() { return klines_; }
+    const vector<Kline>& klines() const { return klines_; }
+
+    // whole document in one go
+    static vector<Kline> decode(string_view json, uint64_t fetch_time_ms = 0);
+
+private:
+    enum class State : uint8_t {
+        Start,       // before the outer '['
+        RowOrEnd,    // after the outer '[': a row or ']' (empty response)
+        RowStart,    // after ',' between rows
+        FieldStart,
+        String,
+        Number,
+        AfterField,  // ',' or ']'
+        AfterRow,    // ',' or the outer ']'
+        Done,
+        ErrorObject, // {"code":...,"msg":...} instead of an array
+        Failed
+    };
+
+    static constexpr size_t kMaxToken = 48;
+
+    vector<Kline> klines_;
+    Kline row_{};
+    uint64_t fetch_time_ms_;
+    uint32_t symbol_id_;
+    State state_ = State::Start;
+    uint32_t field_ = 0;
+    uint32_t token_len_ = 0;
+    char token_[kMaxToken] = {};
+    string error_;  // only touched on failure
+
+    void append_token(const char* begin, const char* end);
+    void begin_row();
+    void end_field();
+    void end_row();
+    void fail(const string& what);
+};
@@ -0,0 +1,57 @@
+#include "kline_series.h"
+#include "parser.h"
+using namespace std;
+
+KlineSeries::KlineSeries(span<const Kline> klines)
+{
+    reserve(klines.size());
+    for (const auto& kline : klines) {
+        push_back(kline);
+    }
+}
+
+KlineSeries::KlineSeries(const KlineColumns& columns)
+    : timestamp_ms_(columns.timestamp_ms.begin(), columns.timestamp_ms.end()),
+      fetch_time_ms_(columns.size(), 0),
+      symbol_id_(columns.symbol_id.begin(), columns.symbol_id.end()),
+      open_(columns.open.begin(), columns.open.end()),
+      high_(columns.high.begin(), columns.high.end()),
+      low_(columns.low.begin(), columns.low.end()),
+      close_(columns.close.begin(), columns.close.end()),
+      volume_(columns.volume.begin(), columns.volume.end()) {}
+
+void KlineSeries::reserve(size_t n)
+{
+    timestamp_ms_.reserve(n);
+    fetch_time_ms_.reserve(n);
+    symbol_id_.reserve(n);
+    open_.reserve(n);
+    high_.reserve(n);
+    low_.reserve(n);
+    close_.reserve(n);
+    volume_.reserve(n);
+}
+
+void KlineSeries::push_back(const Kline& kline)
+{
+    timestamp_ms_.push_back(kline.timestamp_ms);
+    fetch_time_ms_.push_back(kline.fetch_time_ms);
+    symbol_id_.push_back(kline.symbol_id);
+    open_.push_back(kline.open);
+    high_.push_back(kline.high);
+    low_.push_back(kline.low);
+    close_.push_back(kline.close);
+    volume_.push_back(kline.volume);
+}
+
+void KlineSeries::clear()
+{
+    timestamp_ms_.clear();
+    fetch_time_ms_.clear();
+    symbol_id_.clear();
+    open_.clear();
+    high_.clear();
+    low_.clear();
+    close_.clear();
+    volume_.clear();
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <span>
+#include <vector>
+#include "aligned_allocator.h"
+#include "types.h"
+
+using namespace std;
+
+struct KlineColumns;
+class KlineSeries;
+
+// Per-bar view into a KlineSeries. Only the columns that are read get pulled through cache.
+class KlineView
+{
+public:
+    KlineView(const KlineSeries& series, size_t index) : series_(&series), index_(index) {}
+
+    uint64_t timestamp_ms() const;
+    uint64_t fetch_time_ms() const;
+    uint32_t symbol_id() const;
+    double open() const;
+    double high() const;
+    double low() const;
+    double close() const;
+    double volume() const;
+
+    size_t index() const { return index_; }
+    Kline to_kline() const;
+
+private:
+    const KlineSeries* series_;
+    size_t index_;
+};
+
+/* --- Struct-of-arrays kline storage.
+Every field is its own contiguous, 64-byte aligned column, so a loop that
+only needs close() streams 8 bytes per bar instead of the whole Kline. */
+class KlineSeries
+{
+public:
+    KlineSeries() = default;
+    explicit KlineSeries(span<const Kline> klines);
+    explicit KlineSeries(const KlineColumns& columns);
+
+    void reserve(size_t n);
+    void push_back(const Kline& kline);
+    void clear();
+
+    size_t size() const { return timestamp_ms_.size(); }
+    bool empty() const { return timestamp_ms_.empty(); }
+
+    span<const uint64_t> timestamp_ms() const { return timestamp_ms_; }
+    span<const uint64_t> fetch_time_ms() const { return fetch_time_ms_; }
+    span<const uint32_t> symbol_id() const { return symbol_id_; }
+    span<const double> open() const { return open_; }
+    span<const double> high() const { return high_; }
+    span<const double> low() const { return low_; }
+    span<const double> close() const { return close_; }
+    span<const double> volume() const { return volume_; }
+
+    KlineView operator[](size_t i) const { return KlineView(*this, i); }
+
+    // gathers one bar back into AoS form
+    Kline at(size_t i) const
+    {
+        return Kline{timestamp_ms_[i], fetch_time_ms_[i], symbol_id_[i], open_[i], high_[i], low_[i], close_[i], volume_[i]};
+    }
+
+private:
+    friend class KlineView;
+
+    AlignedVector<uint64_t> timestamp_ms_;
+    AlignedVector<uint64_t> fetch_time_ms_;
+    AlignedVector<uint32_t> symbol_id_;
+    AlignedVector<double> open_;
+    AlignedVector<double> high_;
+    AlignedVector<double> low_;
+    AlignedVector<double> close_;
+    AlignedVector<double> volume_;
+};
+
+inline uint64_t KlineView::timestamp_ms() const { return series_->timestamp_ms_[index_]; }
+inline uint64_t KlineView::fetch_time_ms() const { return series_->fetch_time_ms_[index_]; }
+inline uint32_t KlineView::symbol_id() const { return series_->symbol_id_[index_]; }
+inline double KlineView::open() const { return series_->open_[index_]; }
+inline double KlineView::high() const { return series_->high_[index_]; }
+inline double KlineView::low() const { return series_->low_[index_]; }
+inline double KlineView::close() const { return series_->close_[index_]; }
+inline double KlineView::volume() const { return series_->volume_[index_]; }
+inline Kline KlineView::to_kline() const { return series_->at(index_); }
@@ -0,0 +1,106 @@
+#include "latency_probe.h"
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+using namespace std;
+
+namespace {
+
+constexpr size_t kProbeCount = static_cast<size_t>(Probe::Count);
+
+struct ThreadHistograms
+{
+    atomic<uint64_t> counts[kProbeCount][LatencyProbes::kBuckets] = {};
+};
+
+// owns every thread's histograms so they outlive the threads that wrote them
+mutex registry_lock;
+vector<unique_ptr<ThreadHistograms>>& registry()
+{
+    static vector<unique_ptr<ThreadHistograms>> histograms;
+    return histograms;
+}
+
+ThreadHistograms& local_histograms()
+{
+    thread_local ThreadHistograms* local = [] {
+        lock_guard<mutex> guard(registry_lock);
+        registry().push_back(make_unique<ThreadHistograms>());
+        return registry().back().get();
+    }();
+    return *local;
+}
+
+}
+
+void LatencyProbes::record(Probe probe, uint64_t ticks)
+{
+    auto& slot = local_histograms().counts[static_cast<size_t>(probe)][bucket_of(ticks)];
+    // only this thread writes the slot, so load + store is enough
+    slot.store(slot.load(memory_order_relaxed) + 1, memory_order_relaxed);
+}
+
+const char* LatencyProbes::name(Probe probe)
+{
+    switch (probe) {
+        case Probe::Parse: return "parse";
+        case Probe::Strategy: return "strategy";
+        case Probe::Execution: return "execution";
+        case Probe::Metrics: return "metrics";
+        case Probe::Count: break;
+    }
+    return "unknown";
+}
+
+void LatencyProbes::report(ostream& out)
+{
+    vector<uint64_t> merged(kBuckets);
+
+    out << left << setw(12) << "stage" << setw(14) << "count"
+        << setw(12) << "p50 ns" << setw(12) << "p99 ns" << "p999 ns" << endl;
+
+    lock_guard<mutex> guard(registry_lock);
+    for (size_t p = 0; p < kProbeCount; ++p) {
+        fill(merged.begin(), merged.end(), 0);
+        uint64_t total = 0;
+        for (const auto& histograms : registry()) {
+            for (uint32_t b = 0; b < kBuckets; ++b) {
+                uint64_t c = histograms->counts[p][b].load(memory_order_relaxed);
+                merged[b] += c;
+                total += c;
+            }
+        }
+        if (total == 0) {
+            continue;
+        }
+
+        auto quantile_ns = [&](double q) {
+            uint64_t rank = min(static_cast<uint64_t>(q * static_cast<double>(total)), total - 1);
+            uint64_t seen = 0;
+            for (uint32_t b = 0; b < kBuckets; ++b) {
+                seen += merged[b];
+                if (seen > rank) {
+                    return TscClock::to_ns(bucket_floor(b));
+                }
+            }
+            return 0.0;
+        };
+
+        out << left << setw(12) << name(static_cast<Probe>(p)) << setw(14) << total
+            << fixed << setprecision(1)
+            << setw(12) << quantile_ns(0.50) << setw(12) << quantile_ns(0.99) << quantile_ns(0.999) << endl;
+    }
+}
+
+void LatencyProbes::reset()
+{
+    lock_guard<mutex> guard(registry_lock);
+    for (auto& histograms : registry()) {
+        for (auto& per_probe : histograms->counts) {
+            for (auto& c : per_probe) {
+                c.store(0, memory_order_relaxed);
+            }
+        }
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include "timing.h"
+
+using namespace std;
+
+// Pipeline stages with a named probe
+enum class Probe : uint32_t
+{
+    Parse = 0,
+    Strategy,
+    Execution,
+    Metrics,
+    Count
+};
+
+/* --- Per-thread latency histograms fed by TSC probes.
+Every thread records into its own histograms (single writer, relaxed atomics, no locks
+and no shared cache lines), and report() merges all threads at the end of a run.
+Buckets are log-linear on TSC ticks (32 sub-buckets per power of two, ~3% resolution). */
+class LatencyProbes
+{
+public:
+    static constexpr uint32_t kSubBits = 5;
+    static constexpr uint32_t kSubBuckets = 1u << kSubBits;
+    static constexpr uint32_t kBuckets = (64 - kSubBits + 1) * kSubBuckets;
+
+    static void record(Probe probe, uint64_t ticks);
+
+    // per-stage count and p50/p99/p999 in nanoseconds, all threads merged
+    static void report(ostream& out);
+    static void reset();
+
+    static const char* name(Probe probe);
+
+    static uint32_t bucket_of(uint64_t ticks)
+    {
+        if (ticks < kSubBuckets) {
+            return static_cast<uint32_t>(ticks);
+        }
+        uint32_t exponent = 63 - static_cast<uint32_t>(__builtin_clzll(ticks));
+        uint32_t sub = static_cast<uint32_t>(ticks >> (exponent - kSubBits)) & (kSubBuckets - 1);
+        return (exponent - kSubBits + 1) * kSubBuckets + sub;
+    }
+
+    // lowest tick count that maps to the bucket
+    static uint64_t bucket_floor(uint32_t bucket)
+    {
+        if (bucket < kSubBuckets) {
+            return bucket;
+        }
+        uint32_t exponent = bucket / kSubBuckets + kSubBits - 1;
+        uint64_t sub = bucket % kSubBuckets;
+        return (1ULL << exponent) | (sub << (exponent - kSubBits));
+    }
+};
+
+// Times the enclosing scope and records it under `probe`
+class ProbeScope
+{
+public:
+    explicit ProbeScope(Probe probe) : probe_(probe), start_(TscClock::now()) {}
+    ~ProbeScope() { LatencyProbes::record(probe_, TscClock::now_serialized() - start_); }
+
+    ProbeScope(const ProbeScope&) = delete;
+    ProbeScope& operator=(const ProbeScope&) = delete;
+
+private:
+    Probe probe_;
+    uint64_t start_;
+};
+
+// Probes compile away unless the build enables them (cmake -DHYPERTRADEX_PROBES=ON)
+#ifdef HYPERTRADEX_PROBES
+#define HX_PROBE(stage) ProbeScope hx_probe_scope_(stage)
+#else
+#define HX_PROBE(stage) ((void)0)
+#endif
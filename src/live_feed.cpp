@@ -0,0 +1,73 @@
+#include "live_feed.h"
+#include <algorithm>
+#include <thread>
+#include "timing.h"
+
+using namespace std;
+
+RecordedFeed::RecordedFeed(span<const Kline> klines, double speed, size_t batch)
+    : klines_(klines), speed_(speed), batch_(max<size_t>(batch, 1)) {}
+
+bool RecordedFeed::poll(vector<Kline>& out)
+{
+    if (next_ >= klines_.size()) {
+        return false;
+    }
+    uint64_t now_us = wall_clock_us();
+    if (start_wall_us_ == 0) {
+        start_wall_us_ = now_us;
+    }
+
+    size_t end = min(next_ + batch_, klines_.size());
+    if (speed_ > 0.0) {
+        // release only bars whose (scaled) time has come, sleep a little if none has
+        const uint64_t first_ms = klines_.front().timestamp_ms;
+        auto due_us = [&](size_t i) {
+            return start_wall_us_ + static_cast<uint64_t>(static_cast<double>(klines_[i].timestamp_ms - first_ms) * 1000.0 / speed_);
+        };
+        size_t ready = next_;
+        while (ready < end && due_us(ready) <= now_us) ++ready;
+        if (ready == next_) {
+            this_thread::sleep_for(chrono::microseconds(min<uint64_t>(due_us(next_) - now_us, 1000)));
+            return true;
+        }
+        end = ready;
+    }
+
+    for (; next_ < end; ++next_) {
+        Kline kline = klines_[next_];
+        kline.fetch_time_ms = wall_clock_us();
+        out.push_back(kline);
+    }
+    return true;
+}
+
+BinancePollingFeed::BinancePollingFeed(BinanceClient& client, const string& symbol, const string& interval,
+                                       uint64_t poll_interval_ms, uint64_t max_bars)
+    : client_(client), symbol_(symbol), interval_(interval), step_ms_(BinanceClient::interval_ms(interval)),
+      poll_interval_ms_(poll_interval_ms), max_bars_(max_bars) {}
+
+bool BinancePollingFeed::poll(vector<Kline>& out)
+{
+    if (max_bars_ && emitted_ >= max_bars_) {
+        return false;
+    }
+    uint64_t now_us = wall_clock_us();
+    if (now_us < next_poll_us_) {
+        this_thread::sleep_for(chrono::microseconds(min<uint64_t>(next_poll_us_ - now_us, 10000)));
+        return true;
+    }
+    next_poll_us_ = now_us + poll_interval_ms_ * 1000;
+
+    // the last two bars: the one that just closed and the one still forming
+    uint64_t now_ms = now_us / 1000;
+    for (const auto& kline : client_.fetch_klines(symbol_, interval_, 2)) {
+        bool closed = kline.timestamp_ms + step_ms_ <= now_ms;
+        if (closed && kline.timestamp_ms > last_open_ms_) {
+            out.push_back(kline);
+            last_open_ms_ = kline.timestamp_ms;
+            if (max_bars_ && ++emitted_ >= max_bars_) break;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+#include "binance_client.h"
+#include "types.h"
+
+using namespace std;
+
+// Source of live bars for LivePipeline. poll() runs on the feed thread and appends
+// whatever is new (possibly nothing); it returns false once the feed has ended.
+// Every bar must carry fetch_time_ms = wall_clock_us() from when it was received.
+class KlineFeed
+{
+public:
+    virtual ~KlineFeed() = default;
+    virtual bool poll(vector<Kline>& out) = 0;
+};
+
+// Recorded-stream stand-in: replays stored bars as if they arrived live, stamping each
+// with the wall clock on release. speed == 0 releases them back to back, otherwise bar
+// times are replayed `speed` times faster than real time.
+class RecordedFeed : public KlineFeed
+{
+public:
+    explicit RecordedFeed(span<const Kline> klines, double speed = 0.0, size_t batch = 64);
+    bool poll(vector<Kline>& out) override;
+
+private:
+    span<const Kline> klines_;
+    double speed_;
+    size_t batch_;
+    size_t next_ = 0;
+    uint64_t start_wall_us_ = 0;
+};
+
+// Polls the REST klines endpoint and emits each bar once it has closed.
+// Stops after max_bars bars (0 = run until the process is stopped).
+class BinancePollingFeed : public KlineFeed
+{
+public:
+    BinancePollingFeed(BinanceClient& client, const string& symbol, const string& interval,
+                       uint64_t poll_interval_ms = 1000, uint64_t max_bars = 0);
+    bool poll(vector<Kline>& out) override;
+
+private:
+    BinanceClient& client_;
+    string symbol_;
+    string interval_;
+    uint64_t step_ms_;
+    uint64_t poll_interval_ms_;
+    uint64_t max_bars_;
+    uint64_t emitted_ = 0;
+    uint64_t last_open_ms_ = 0;
+    uint64_t next_poll_us_ = 0;
+};
@@ -0,0 +1,112 @@
+#include "live_pipeline.h"
+#include <algorithm>
+#include <atomic>
+#include <pthread.h>
+#include <sched.h>
+#include <thread>
+#include <vector>
+#include "executor.h"
+#include "metrics.h"
+#include "strategy.h"
+#include "timing.h"
+
+using namespace std;
+
+LivePipeline::LivePipeline(const LiveConfig& config) : config_(config) {}
+
+bool LivePipeline::pin_current_thread(int cpu)
+{
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+LiveReport LivePipeline::run(KlineFeed& feed, ostream* trade_log)
+{
+    SpscRing<Kline> bars(config_.ring_capacity, config_.wait_mode);
+    SpscRing<Trade> trades(config_.ring_capacity, config_.wait_mode);
+    LiveReport report;
+    atomic<unsigned> pin_failures{0};
+
+    auto pin = [&](int cpu) {
+        if (cpu >= 0 && !pin_current_thread(cpu)) ++pin_failures;
+    };
+
+    // metrics + trade log
+    Metrics metrics(config_.initial_capital);
+    thread metrics_thread([&] {
+        pin(config_.metrics_cpu);
+        if (trade_log) {
+            *trade_log << "trade_id,entry_time_ms,exit_time_ms,entry_latency_us,exit_latency_us,"
+                          "entry_price,exit_price,quantity,pnl\n";
+        }
+        Trade trade;
+        while (trades.pop(trade)) {
+            metrics.on_trade(trade);
+            if (trade_log) {
+                *trade_log << trade.trade_id << ',' << trade.entry_time_ms << ',' << trade.exit_time_ms << ','
+                           << trade.entry_latency_us << ',' << trade.exit_latency_us << ',' << trade.entry_price << ','
+                           << trade.exit_price << ',' << trade.quantity << ',' << trade.pnl << '\n';
+            }
+        }
+    });
+
+    // strategy + executor, the latency-critical hop
+    thread strategy_thread([&] {
+        pin(config_.strategy_cpu);
+        Strategy strategy(config_.hold_duration_ms);
+        Executor executor(config_.initial_capital);
+        Kline kline;
+        while (bars.pop(kline)) {
+            auto decision = strategy.on_kline(kline);
+            uint64_t decided_us = wall_clock_us();
+            double latency = static_cast<double>(decided_us > kline.fetch_time_ms ? decided_us - kline.fetch_time_ms : 0);
+            report.tick_to_decision_us.add(latency);
+            report.max_tick_to_decision_us = max(report.max_tick_to_decision_us, latency);
+            ++report.bars;
+
+            auto result = executor.on_kline(kline, decision);
+            if (result.has_value()) {
+                trades.push(result.value());
+            }
+        }
+        trades.close();
+    });
+
+    // the feed runs on the calling thread, its affinity is put back afterwards
+    cpu_set_t caller_affinity;
+    bool restore_affinity = config_.feed_cpu >= 0 &&
+        pthread_getaffinity_np(pthread_self(), sizeof(caller_affinity), &caller_affinity) == 0;
+    pin(config_.feed_cpu);
+    auto finish = [&] {
+        bars.close();
+        strategy_thread.join();
+        metrics_thread.join();
+        if (restore_affinity) {
+            pthread_setaffinity_np(pthread_self(), sizeof(caller_affinity), &caller_affinity);
+        }
+    };
+    vector<Kline> batch;
+    try {
+        while (true) {
+            batch.clear();
+            bool more = feed.poll(batch);
+            for (const auto& kline : batch) {
+                bars.push(kline);
+            }
+            if (!more) break;
+        }
+    } catch (...) {
+        finish();
+        throw;
+    }
+    finish();
+
+    report.stats = metrics.snapshot();
+    report.pin_failures = pin_failures.load();
+    return report;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include "live_feed.h"
+#include "quantile_sketch.h"
+#include "spsc_ring.h"
+#include "types.h"
+
+using namespace std;
+
+struct LiveConfig
+{
+    uint64_t hold_duration_ms = 5000;
+    uint64_t initial_capital = 1000000;
+    WaitMode wait_mode = WaitMode::Blocking;
+    size_t ring_capacity = 4096;
+    // CPU to pin each thread to, -1 leaves it to the scheduler
+    int feed_cpu = -1;
+    int strategy_cpu = -1;
+    int metrics_cpu = -1;
+};
+
+struct LiveReport
+{
+    Statistics stats;
+    uint64_t bars = 0;
+    // bar received (fetch_time_ms stamp) -> strategy decision, in microseconds on wall_clock_us()
+    QuantileSketch tick_to_decision_us;
+    double max_tick_to_decision_us = 0.0;
+    // threads that asked for a CPU but could not be pinned
+    unsigned pin_failures = 0;
+};
+
+/* --- Live / paper trading.
+    feed thread  --SpscRing<Kline>-->  strategy+executor thread  --SpscRing<Trade>-->  metrics thread
+The feed thread polls the KlineFeed, the strategy thread runs Strategy and Executor bar by
+bar (the same code as the backtest) and the metrics thread folds closed trades into
+streaming Metrics and optionally logs them. run() returns once the feed ends and both
+rings have drained. */
+class LivePipeline
+{
+public:
+    explicit LivePipeline(const LiveConfig& config);
+
+    // trade_log, if given, gets one CSV line per closed trade (written by the metrics thread)
+    LiveReport run(KlineFeed& feed, ostream* trade_log = nullptr);
+
+    // pins the calling thread, false if the CPU doesn't exist or isn't allowed
+    static bool pin_current_thread(int cpu);
+
+private:
+    LiveConfig config_;
+};
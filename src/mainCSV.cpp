@@ -1,85 +1,588 @@
+#include <algorithm>
+#include <chrono>
+#include <fstream>
 #include <iostream>
 #include <iomanip>
+#include <memory>
+#include <optional>
+#include <string>
 #include <vector>
+#include "binance_client.h"
 #include "data_loader.h"
+#include "htx_store.h"
+#include "tick_store.h"
+#include "kline_cache.h"
 #include "parser.h"
+#include "multi_replay_engine.h"
 #include "replay_engine.h"
+#include "backtest.h"
 #include "strategy.h"
 #include "executor.h"
+#include "fixed_point.h"
+#include "latency_probe.h"
+#include "live_pipeline.h"
 #include "metrics.h"
+#include "robustness.h"
+#include "batch_sweep.h"
+#include "sweep_runner.h"
 
 using namespace std;
 
-int main() {
-    try {
-        cout << "=== HyperTradeX Phase 1 - End-to-End Backtest ===" << endl;
-        
+namespace {
+
+bool ends_with(const string& s, const string& suffix) {
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// hypertradex convert <in.csv> <out.htx>
+// hypertradex convert --binance <SYMBOL> <interval> <limit> <out.htx>
+// hypertradex convert --binance <SYMBOL> <interval> <start_ms> <end_ms> <out.htx>
+// hypertradex convert --agg-trades <SYMBOL> <aggTrades.csv> <out.htt>
+int run_convert(int argc, char* argv[]) {
+    if (argc == 4) {
+        string in = argv[2], out = argv[3];
+        cout << "Converting " << in << " -> " << out << endl;
+        KlineColumns columns = DataLoader::load_columns(in);
+        HtxWriter::write(out, columns, Parser::symbols().names());
+        cout << "Wrote " << columns.size() << " klines" << endl;
+        return 0;
+    }
+    if (argc == 6 && string(argv[2]) == "--agg-trades") {
+        string symbol = argv[3], in = argv[4], out = argv[5];
+        cout << "Converting " << in << " -> " << out << endl;
+        vector<Tick> ticks = DataLoader::load_agg_trades(in, symbol);
+        TickWriter::write(out, ticks, Parser::symbols().names());
+        cout << "Wrote " << ticks.size() << " ticks" << endl;
+        return 0;
+    }
+    if (argc == 7 && string(argv[2]) == "--binance") {
+        string symbol = argv[3], interval = argv[4], out = argv[6];
+        BinanceClient client("https://api.binance.com");
+        vector<Kline> klines = client.fetch_klines(symbol, interval, stoi(argv[5]));
+        // fetched klines all carry symbol_id 0
+        HtxWriter::write(out, klines, {symbol});
+        cout << "Wrote " << klines.size() << " klines -> " << out << endl;
+        return 0;
+    }
+    if (argc == 8 && string(argv[2]) == "--binance") {
+        // bulk history: paged, concurrent, rate limited
+        string symbol = argv[3], interval = argv[4], out = argv[7];
+        BinanceClient client("https://api.binance.com");
+        vector<Kline> klines = client.fetch_klines_range(symbol, interval, stoull(argv[5]), stoull(argv[6]));
+        HtxWriter::write(out, klines, {symbol});
+        cout << "Wrote " << klines.size() << " klines (" << client.requests_sent() << " requests) -> " << out << endl;
+        return 0;
+    }
+    cerr << "usage: hypertradex convert <in.csv> <out.htx>\n"
+         << "       hypertradex convert --binance <SYMBOL> <interval> <limit> <out.htx>\n"
+         << "       hypertradex convert --binance <SYMBOL> <interval> <start_ms> <end_ms> <out.htx>\n"
+         << "       hypertradex convert --agg-trades <SYMBOL> <aggTrades.csv> <out.htt>" << endl;
+    return 1;
+}
+
+
+// "binance:<SYMBOL>:<interval>:<start_ms>:<end_ms>", e.g. binance:BTCUSDT:1m:1672531200000:1704067200000
+bool parse_binance_spec(const string& spec, string& symbol, string& interval, uint64_t& start_ms, uint64_t& end_ms) {
+    if (spec.rfind("binance:", 0) != 0) return false;
+    vector<string> parts;
+    size_t pos = 0;
+    while (pos <= spec.size()) {
+        size_t colon = spec.find(':', pos);
+        if (colon == string::npos) colon = spec.size();
+        parts.push_back(spec.substr(pos, colon - pos));
+        pos = colon + 1;
+    }
+    if (parts.size() != 5) {
+        throw runtime_error("expected binance:<SYMBOL>:<interval>:<start_ms>:<end_ms>, got " + spec);
+    }
+    symbol = parts[1];
+    interval = parts[2];
+    start_ms = stoull(parts[3]);
+    end_ms = stoull(parts[4]);
+    return true;
+}
+
+// Steps 1+2 of a run: picks the loader from the file type and flags
+vector<Kline> load_input(const string& csv_file, bool legacy_loader, unsigned parse_threads) {
+    vector<Kline> klines;
+    string symbol, interval;
+    uint64_t start_ms = 0, end_ms = 0;
+    if (parse_binance_spec(csv_file, symbol, interval, start_ms, end_ms)) {
+        // Steps 1+2: Binance history through the on-disk cache, only missing ranges are downloaded
+        cout << "\n[1] Opening kline cache (data/cache)..." << endl;
+        BinanceClient client("https://api.binance.com");
+        KlineCache cache("data/cache", client);
+        cout << "\n[2] Reading klines..." << endl;
+        klines = cache.get(symbol, interval, start_ms, end_ms);
+        const CacheStats& stats = cache.last_stats();
+        cout << "Cache: " << stats.cached_klines << " klines from disk, " << stats.fetched_klines
+             << " downloaded in " << stats.fetched_ranges << " ranges" << endl;
+    } else if (ends_with(csv_file, ".htx")) {
+        // Steps 1+2: binary columnar file, mmapped and gathered without parsing. This copies
+        // the store into Klines, which sweep / robust / live need; the plain backtest replays
+        // a single-symbol store from the mapping instead (see main)
+        cout << "\n[1] Mapping HTX file..." << endl;
+        HtxReader reader(csv_file);
+        cout << "\n[2] Reading klines..." << endl;
+        klines = reader.to_klines();
+    } else if (legacy_loader) {
         // Step 1: Load CSV file
         cout << "\n[1] Loading CSV file..." << endl;
-        auto lines = DataLoader::load_file("data/BTCUSDT_1m.csv");
+        auto lines = DataLoader::load_file(csv_file);
         cout << "Loaded " << lines.size() << " lines" << endl;
         
         // Step 2: Parse klines (skip header)
         cout << "\n[2] Parsing klines..." << endl;
-        vector<Kline> klines;
         for (size_t i = 1; i < lines.size(); ++i) {
             klines.push_back(Parser::parse_kline(lines[i]));
         }
-        cout << "Parsed " << klines.size() << " klines" << endl;
-        
-        // Step 3: Create backtest components
-        cout << "\n[3] Creating backtest components..." << endl;
+    } else if (parse_threads != 1) {
+        // Steps 1+2: mmap the CSV and parse chunks on several cores
+        cout << "\n[1] Loading CSV file (mmap)..." << endl;
+        cout << "\n[2] Parsing klines in parallel..." << endl;
+        klines = DataLoader::load_klines_parallel(csv_file, parse_threads);
+    } else {
+        // Steps 1+2: mmap the CSV and parse it in place
+        cout << "\n[1] Loading CSV file (mmap)..." << endl;
+        cout << "\n[2] Parsing klines..." << endl;
+        DataLoader::load_klines(csv_file, klines);
+    }
+    return klines;
+}
+
+// hypertradex sweep [data_file] --hold <grid> [--threads N] [--out results.csv] [--batched]
+int run_sweep(int argc, char* argv[]) {
+    string data_file = "data/BTCUSDT_1m.csv";
+    string hold_spec;
+    string out_file = "sweep_results.csv";
+    unsigned threads = 0;
+    bool batched = false;
+    for (int i = 2; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--batched") {
+            batched = true;
+        } else if (arg == "--hold" && i + 1 < argc) {
+            hold_spec = argv[++i];
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = static_cast<unsigned>(stoul(argv[++i]));
+        } else if (arg == "--out" && i + 1 < argc) {
+            out_file = argv[++i];
+        } else {
+            data_file = arg;
+        }
+    }
+    if (hold_spec.empty()) {
+        cerr << "usage: hypertradex sweep [data_file] --hold <a,b,c | start:end:step> [--threads N] [--out results.csv] [--batched]" << endl;
+        return 1;
+    }
+
+    cout << "=== HyperTradeX - Parameter Sweep ===" << endl;
+    vector<Kline> klines = load_input(data_file, false, 1);
+    cout << "Parsed " << klines.size() << " klines" << endl;
+
+    const uint64_t initial_capital = 1000000;
+    vector<SweepPoint> grid = SweepRunner::parse_hold_grid(hold_spec);
+    cout << "\n[3] Running " << grid.size() << " backtests..." << endl;
+
+    auto start = chrono::steady_clock::now();
+    vector<SweepResult> results;
+    if (batched) {
+        // same results, BatchSweep::kBatchLanes grid points per pass over the columns
+        KlineSeries series(klines);
+        results = BatchSweep(series, initial_capital, threads).run(grid);
+    } else {
+        SweepRunner runner(klines, initial_capital, threads);
+        results = runner.run(grid);
+    }
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << "\n" << left << setw(18) << "hold_ms" << setw(10) << "trades" << setw(12) << "win_rate"
+         << setw(16) << "total_pnl" << "max_drawdown" << endl;
+    cout << fixed << setprecision(2);
+    for (const auto& r : results) {
+        cout << left << setw(18) << r.params.hold_duration_ms << setw(10) << r.stats.total_trades
+             << setw(12) << r.stats.win_rate << setw(16) << r.stats.total_pnl << r.stats.max_drawdown << endl;
+    }
+
+    SweepRunner::write_csv(out_file, results);
+    cout << "\nSweep took " << secs << " s, results written to " << out_file << endl;
+    return 0;
+}
+
+// --price-decimals / --quantity-decimals; pow10_fixed stops at 10^18
+uint8_t parse_decimals(const string& flag, const string& value) {
+    unsigned long decimals = stoul(value);
+    if (decimals > 18) {
+        throw runtime_error(flag + " must be at most 18, got " + value);
+    }
+    return static_cast<uint8_t>(decimals);
+}
+
+// Step 6 of a run
+void print_results(uint64_t initial_capital, const Statistics& stats) {
+    cout << "\n";
+    cout << "==========================================" << endl;
+    cout << "           BACKTEST RESULTS" << endl;
+    cout << "==========================================" << endl;
+    cout << fixed << setprecision(2);
+    cout << left << setw(25) << "Initial Capital:" << "$" << initial_capital << endl;
+    cout << left << setw(25) << "Total Trades:" << stats.total_trades << endl;
+    cout << left << setw(25) << "Winning Trades:" << stats.winning_trades << endl;
+    cout << left << setw(25) << "Win Rate:" << stats.win_rate << "%" << endl;
+    cout << left << setw(25) << "Total PnL:" << "$" << stats.total_pnl << endl;
+    cout << left << setw(25) << "Max Drawdown:" << "$" << stats.max_drawdown << endl;
+    cout << left << setw(25) << "Largest Win:" << "$" << stats.largest_win << endl;
+    cout << left << setw(25) << "Largest Loss:" << "$" << stats.largest_loss << endl;
+    cout << "-------------------------------------------" << endl;
+    cout << left << setw(25) << "Avg Entry Latency:" << stats.avg_entry_latency_us << " μs" << endl;
+    cout << left << setw(25) << "Avg Exit Latency:" << stats.avg_exit_latency_us << " μs" << endl;
+    cout << left << setw(25) << "P99 Latency:" << stats.p99_latency_us << " μs" << endl;
+    cout << left << setw(25) << "P50 Latency:" << stats.p50_latency_us << " μs" << endl;
+    cout << "==========================================" << endl;
+}
+
+// Steps 1-4 on the fixed-point path: the CSV is parsed straight to int64 ticks and every
+// price comparison and pnl sum is exact. One symbol per run, FixedMetrics has one scale.
+Statistics run_fixed_point(const string& csv_file, uint64_t initial_capital, uint64_t hold_duration_ms) {
+    cout << "\n[1] Loading CSV file (mmap)..." << endl;
+    cout << "\n[2] Parsing klines to fixed point..." << endl;
+    vector<FixedKline> klines = DataLoader::load_fixed_klines(csv_file);
+    cout << "Parsed " << klines.size() << " klines" << endl;
+    for (const auto& kline : klines) {
+        if (kline.symbol_id != klines.front().symbol_id) {
+            throw runtime_error("--fixed-point runs one symbol at a time");
+        }
+    }
+
+    cout << "\n[3] Creating backtest components..." << endl;
+    FixedScale scale = klines.empty() ? FixedScale{} : Parser::fixed_scale(klines.front().symbol_id);
+    Strategy strategy(hold_duration_ms);
+    FixedExecutor executor;
+    FixedMetrics metrics(initial_capital, scale);
+
+    cout << "\n[4] Running backtest (fixed point, " << static_cast<int>(scale.price_decimals) << " price decimals)..." << endl;
+    for (const auto& kline : klines) {
+        auto result = executor.on_kline(kline, strategy.on_kline(kline));
+        if (result.has_value()) {
+            metrics.on_trade(result.value());
+        }
+    }
+    return metrics.snapshot();
+}
+
+// hypertradex robust [data_file] --hold <ms> [--resamples N] [--block L] [--seed S]
+//                    [--walk-forward TRAIN:TEST --grid <grid>] [--threads N]
+int run_robust(int argc, char* argv[]) {
+    string data_file = "data/BTCUSDT_1m.csv";
+    string grid_spec, walk_spec;
+    uint64_t hold_ms = 0;
+    ResampleConfig config;
+    for (int i = 2; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--hold" && i + 1 < argc) {
+            hold_ms = stoull(argv[++i]);
+        } else if (arg == "--resamples" && i + 1 < argc) {
+            config.resamples = stoull(argv[++i]);
+        } else if (arg == "--block" && i + 1 < argc) {
+            config.block_length = stoull(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            config.seed = stoull(argv[++i]);
+        } else if (arg == "--walk-forward" && i + 1 < argc) {
+            walk_spec = argv[++i];
+        } else if (arg == "--grid" && i + 1 < argc) {
+            grid_spec = argv[++i];
+        } else if (arg == "--threads" && i + 1 < argc) {
+            config.threads = static_cast<unsigned>(stoul(argv[++i]));
+        } else {
+            data_file = arg;
+        }
+    }
+    size_t colon = walk_spec.find(':');
+    if (hold_ms == 0 || (!walk_spec.empty() && (colon == string::npos || grid_spec.empty()))) {
+        cerr << "usage: hypertradex robust [data_file] --hold <ms> [--resamples N] [--block L] [--seed S]\n"
+             << "                          [--walk-forward TRAIN_BARS:TEST_BARS --grid <a,b,c | start:end:step>] [--threads N]" << endl;
+        return 1;
+    }
+
+    cout << "=== HyperTradeX - Robustness ===" << endl;
+    vector<Kline> klines = load_input(data_file, false, 1);
+    cout << "Parsed " << klines.size() << " klines" << endl;
+    const uint64_t initial_capital = 1000000;
+
+    // the run being stress-tested
+    Strategy strategy(hold_ms);
+    Executor executor(initial_capital);
+    ReplayEngine engine(klines);
+    vector<Trade> trades;
+    run_backtest(engine, strategy, executor, [&](const Trade& trade) { trades.push_back(trade); });
+
+    cout << "\n[3] Bootstrapping " << trades.size() << " trades x " << config.resamples << " resamples..." << endl;
+    auto start = chrono::steady_clock::now();
+    ResampleResult mc = MonteCarlo(trades, initial_capital).run(config);
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << fixed << setprecision(2);
+    cout << "\n" << left << setw(16) << "" << setw(14) << "p05" << setw(14) << "p50" << setw(14) << "p95" << "mean" << endl;
+    cout << left << setw(16) << "total pnl" << setw(14) << mc.pnl.p05 << setw(14) << mc.pnl.p50 << setw(14)
+         << mc.pnl.p95 << mc.pnl.mean << endl;
+    cout << left << setw(16) << "max drawdown" << setw(14) << mc.drawdown.p05 << setw(14) << mc.drawdown.p50
+         << setw(14) << mc.drawdown.p95 << mc.drawdown.mean << endl;
+    cout << "P(loss) " << mc.probability_of_loss * 100.0 << "%, took " << secs << " s" << endl;
+
+    if (!walk_spec.empty()) {
+        WalkForwardConfig wf{stoull(walk_spec.substr(0, colon)), stoull(walk_spec.substr(colon + 1))};
+        wf.threads = config.threads;
+        vector<SweepPoint> grid = SweepRunner::parse_hold_grid(grid_spec);
+        vector<WalkForwardResult> windows = WalkForward(klines, initial_capital).run(wf, grid);
+
+        cout << "\n[4] Walk-forward, " << windows.size() << " windows" << endl;
+        cout << left << setw(12) << "test_begin" << setw(14) << "chosen_hold" << setw(16) << "in_sample_pnl"
+             << "out_of_sample_pnl" << endl;
+        double oos = 0.0;
+        for (const auto& w : windows) {
+            cout << left << setw(12) << w.test_begin << setw(14) << w.chosen.hold_duration_ms << setw(16)
+                 << w.in_sample.total_pnl << w.out_of_sample.total_pnl << endl;
+            oos += w.out_of_sample.total_pnl;
+        }
+        cout << "Out-of-sample total: $" << oos << endl;
+    }
+    return 0;
+}
+
+// hypertradex live [data_file | --binance SYM interval] [--speed X] [--bars N] [--busy-poll]
+//                  [--cpus feed,strategy,metrics] [--log trades.csv]
+int run_live(int argc, char* argv[]) {
+    string data_file = "data/BTCUSDT_1m.csv";
+    string symbol, interval, log_file;
+    double speed = 0.0;
+    uint64_t max_bars = 0;
+    LiveConfig config;
+    for (int i = 2; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--binance" && i + 2 < argc) {
+            symbol = argv[++i];
+            interval = argv[++i];
+        } else if (arg == "--speed" && i + 1 < argc) {
+            speed = stod(argv[++i]);
+        } else if (arg == "--bars" && i + 1 < argc) {
+            max_bars = stoull(argv[++i]);
+        } else if (arg == "--busy-poll") {
+            config.wait_mode = WaitMode::BusyPoll;
+        } else if (arg == "--cpus" && i + 1 < argc) {
+            // "2,3,4" -> feed, strategy, metrics
+            string cpus = argv[++i];
+            int* slots[] = {&config.feed_cpu, &config.strategy_cpu, &config.metrics_cpu};
+            size_t pos = 0;
+            for (int* slot : slots) {
+                if (pos > cpus.size()) break;
+                size_t comma = cpus.find(',', pos);
+                if (comma == string::npos) comma = cpus.size();
+                *slot = stoi(cpus.substr(pos, comma - pos));
+                pos = comma + 1;
+            }
+        } else if (arg == "--log" && i + 1 < argc) {
+            log_file = argv[++i];
+        } else {
+            data_file = arg;
+        }
+    }
+
+    cout << "=== HyperTradeX - Live (paper) ===" << endl;
+    vector<Kline> recorded;
+    unique_ptr<BinanceClient> client;
+    unique_ptr<KlineFeed> feed;
+    if (!symbol.empty()) {
+        cout << "Polling Binance " << symbol << " " << interval << " klines" << endl;
+        client = make_unique<BinanceClient>("https://api.binance.com");
+        feed = make_unique<BinancePollingFeed>(*client, symbol, interval, 1000, max_bars);
+    } else {
+        recorded = load_input(data_file, false, 1);
+        if (max_bars && max_bars < recorded.size()) recorded.resize(max_bars);
+        cout << "Replaying " << recorded.size() << " recorded klines as a live stream" << endl;
+        feed = make_unique<RecordedFeed>(recorded, speed);
+    }
+
+    ofstream log;
+    if (!log_file.empty()) {
+        log.open(log_file);
+        if (!log.is_open()) throw runtime_error("Cannot create file: " + log_file);
+    }
+
+    LivePipeline pipeline(config);
+    LiveReport report = pipeline.run(*feed, log_file.empty() ? nullptr : &log);
+    if (report.pin_failures) {
+        cerr << "warning: " << report.pin_failures << " thread(s) could not be pinned" << endl;
+    }
+
+    const auto& stats = report.stats;
+    cout << fixed << setprecision(2);
+    cout << "\n" << left << setw(25) << "Bars:" << report.bars << endl;
+    cout << left << setw(25) << "Total Trades:" << stats.total_trades << endl;
+    cout << left << setw(25) << "Win Rate:" << stats.win_rate << "%" << endl;
+    cout << left << setw(25) << "Total PnL:" << "$" << stats.total_pnl << endl;
+    cout << left << setw(25) << "Max Drawdown:" << "$" << stats.max_drawdown << endl;
+    cout << "-------------------------------------------" << endl;
+    cout << "Tick-to-decision latency (" << (config.wait_mode == WaitMode::BusyPoll ? "busy-poll" : "blocking") << ")" << endl;
+    cout << left << setw(25) << "P50:" << report.tick_to_decision_us.quantile(0.50) << " μs" << endl;
+    cout << left << setw(25) << "P99:" << report.tick_to_decision_us.quantile(0.99) << " μs" << endl;
+    cout << left << setw(25) << "P99.9:" << report.tick_to_decision_us.quantile(0.999) << " μs" << endl;
+    cout << left << setw(25) << "Max:" << report.max_tick_to_decision_us << " μs" << endl;
+    return 0;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        if (argc > 1 && string(argv[1]) == "convert") {
+            return run_convert(argc, argv);
+        }
+        if (argc > 1 && string(argv[1]) == "sweep") {
+            return run_sweep(argc, argv);
+        }
+        if (argc > 1 && string(argv[1]) == "robust") {
+            return run_robust(argc, argv);
+        }
+        if (argc > 1 && string(argv[1]) == "live") {
+            return run_live(argc, argv);
+        }
+
+        // usage: hypertradex [csv_file | htx_file | binance:SYM:interval:start_ms:end_ms] [--legacy-loader] [--threads N]
+        //                    [--slippage-bps X] [--fee-bps X] [--max-participation F]
+        //                    [--fixed-point [--price-decimals N] [--quantity-decimals N]]
+        string csv_file = "data/BTCUSDT_1m.csv";
+        bool legacy_loader = false;
+        bool fixed_point = false;
+        FixedScale scale;
+        unsigned parse_threads = 1;
+        FillCosts costs;
+        // flags only one of the two paths reads, so a mix can be refused instead of ignored
+        string double_only_flag, fixed_only_flag;
+        for (int i = 1; i < argc; ++i) {
+            string arg = argv[i];
+            if (arg == "--legacy-loader") {
+                legacy_loader = true;
+                double_only_flag = arg;
+            } else if (arg == "--threads" && i + 1 < argc) {
+                parse_threads = static_cast<unsigned>(stoul(argv[++i]));
+                double_only_flag = arg;
+            } else if (arg == "--slippage-bps" && i + 1 < argc) {
+                costs.slippage_bps = stod(argv[++i]);
+                double_only_flag = arg;
+            } else if (arg == "--fee-bps" && i + 1 < argc) {
+                costs.fee_bps = stod(argv[++i]);
+                double_only_flag = arg;
+            } else if (arg == "--max-participation" && i + 1 < argc) {
+                costs.max_participation = stod(argv[++i]);
+                double_only_flag = arg;
+            } else if (arg == "--fixed-point") {
+                fixed_point = true;
+            } else if (arg == "--price-decimals" && i + 1 < argc) {
+                scale.price_decimals = parse_decimals(arg, argv[++i]);
+                fixed_only_flag = arg;
+            } else if (arg == "--quantity-decimals" && i + 1 < argc) {
+                scale.quantity_decimals = parse_decimals(arg, argv[++i]);
+                fixed_only_flag = arg;
+            } else {
+                csv_file = arg;
+            }
+        }
+        // FixedExecutor fills at the close with no costs, and only CSV has an exact decimal form
+        if (fixed_point && !double_only_flag.empty()) {
+            throw runtime_error("--fixed-point does not support " + double_only_flag);
+        }
+        if (fixed_point && (ends_with(csv_file, ".htx") || csv_file.rfind("binance:", 0) == 0)) {
+            throw runtime_error("--fixed-point reads CSV files only, got " + csv_file);
+        }
+        if (!fixed_point && !fixed_only_flag.empty()) {
+            throw runtime_error(fixed_only_flag + " needs --fixed-point");
+        }
+
+        cout << "=== HyperTradeX Phase 1 - End-to-End Backtest ===" << endl;
         const uint64_t initial_capital = 1000000;  // 1M capital
         const uint64_t hold_duration_ms = 5000;    // Hold 5 seconds
+
+        if (fixed_point) {
+            Parser::set_default_fixed_scale(scale);
+            Statistics stats = run_fixed_point(csv_file, initial_capital, hold_duration_ms);
+            print_results(initial_capital, stats);
+            return 0;
+        }
         
-        Strategy strategy(hold_duration_ms);
-        Executor executor(initial_capital);
-        Metrics metrics(initial_capital);
-        vector<Trade> trades;
+        // A single-symbol .htx store replays straight from its mapped columns. Anything else
+        // is loaded into Klines (a multi-symbol store too: the portfolio merge regroups it).
+        optional<HtxReader> htx;
+        vector<Kline> klines;
+        if (ends_with(csv_file, ".htx")) {
+            cout << "\n[1] Mapping HTX file..." << endl;
+            htx.emplace(csv_file);
+            cout << "\n[2] Replaying mapped columns..." << endl;
+            if (htx->symbol_names().size() > 1) {
+                klines = htx->to_klines();
+            }
+        } else {
+            klines = load_input(csv_file, legacy_loader, parse_threads);
+        }
+        bool replay_mapped = htx && htx->symbol_names().size() <= 1;
+        cout << "Parsed " << (replay_mapped ? htx->size() : klines.size()) << " klines" << endl;
         
-        ReplayEngine engine(klines);
+        // Step 3: Create backtest components
+        cout << "\n[3] Creating backtest components..." << endl;
         
-        // Step 4: Run backtest
-        cout << "\n[4] Running backtest..." << endl;
-        engine.replay([&](const Kline& kline) {
-            // Strategy decides
-            auto decision = strategy.on_kline(kline);
+        // bar fills with the requested costs; all zero reproduces fill-at-close exactly
+        BarFillModel fill_model(costs);
+
+        // streaming metrics: updated per closed trade, no trade vector kept around
+        Metrics metrics(initial_capital);
+
+        uint32_t symbol_count = 0;
+        for (const auto& kline : klines) {
+            symbol_count = max(symbol_count, kline.symbol_id + 1);
+        }
+
+        if (symbol_count > 1) {
+            // Portfolio run: one time-sorted stream per symbol, merged by timestamp.
+            // Strategy/executor state lives in flat arrays indexed by symbol_id.
+            vector<Kline> grouped;
+            MultiReplayEngine engine(MultiReplayEngine::group_by_symbol(klines, grouped));
+            vector<Strategy> strategies(symbol_count, Strategy(hold_duration_ms));
+            vector<Executor> executors(symbol_count, Executor(initial_capital, &fill_model));
+
+            // Step 4: Run backtest
+            cout << "\n[4] Running backtest over " << symbol_count << " symbols..." << endl;
+            engine.replay([&](uint64_t, span<const Kline> bars) {
+                for (const auto& kline : bars) {
+                    auto decision = strategies[kline.symbol_id].on_kline(kline);
+                    auto result = executors[kline.symbol_id].on_kline(kline, decision);
+                    if (result.has_value()) {
+                        metrics.on_trade(result.value());
+                    }
+                }
+            });
+        } else {
+            Strategy strategy(hold_duration_ms);
+            Executor executor(initial_capital, &fill_model);
             
-            // Executor executes
-            auto result = executor.on_kline(kline, decision);
+            ReplayEngine engine = replay_mapped ? ReplayEngine(*htx) : ReplayEngine(klines);
             
-            // If trade closed, record it
-            if (result.has_value()) {
-                trades.push_back(result.value());
-            }
-        });
-        
-        cout << "Backtest complete! Closed " << trades.size() << " trades" << endl;
+            // Step 4: Run backtest
+            cout << "\n[4] Running backtest..." << endl;
+            // Strategy decides, Executor executes, closed trades are recorded
+            run_backtest(engine, strategy, executor, [&](const Trade& trade) { metrics.on_trade(trade); });
+        }
         
         // Step 5: Calculate metrics
         cout << "\n[5] Calculating metrics..." << endl;
-        auto stats = metrics.calculate(trades);
+        auto stats = metrics.snapshot();
+        cout << "Backtest complete! Closed " << stats.total_trades << " trades" << endl;
         
         // Step 6: Print results
-        cout << "\n";
-        cout << "==========================================" << endl;
-        cout << "           BACKTEST RESULTS" << endl;
-        cout << "==========================================" << endl;
-        cout << fixed << setprecision(2);
-        cout << left << setw(25) << "Initial Capital:" << "$" << initial_capital << endl;
-        cout << left << setw(25) << "Total Trades:" << stats.total_trades << endl;
-        cout << left << setw(25) << "Winning Trades:" << stats.winning_trades << endl;
-        cout << left << setw(25) << "Win Rate:" << stats.win_rate << "%" << endl;
-        cout << left << setw(25) << "Total PnL:" << "$" << stats.total_pnl << endl;
-        cout << left << setw(25) << "Max Drawdown:" << "$" << stats.max_drawdown << endl;
-        cout << left << setw(25) << "Largest Win:" << "$" << stats.largest_win << endl;
-        cout << left << setw(25) << "Largest Loss:" << "$" << stats.largest_loss << endl;
-        cout << "-------------------------------------------" << endl;
-        cout << left << setw(25) << "Avg Entry Latency:" << stats.avg_entry_latency_us << " μs" << endl;
-        cout << left << setw(25) << "Avg Exit Latency:" << stats.avg_exit_latency_us << " μs" << endl;
-        cout << left << setw(25) << "P99 Latency:" << stats.p99_latency_us << " μs" << endl;
-        cout << left << setw(25) << "P50 Latency:" << stats.p50_latency_us << " μs" << endl;
-        cout << "==========================================" << endl;
+        print_results(initial_capital, stats);
+
+#ifdef HYPERTRADEX_PROBES
+        cout << "\nPer-stage latency (TSC probes)" << endl;
+        LatencyProbes::report(cout);
+#endif
         
         return 0;
         
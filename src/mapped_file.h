@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Read-only memory mapping of a whole file.
+// The mapping lives as long as the object, so string_views into it stay valid until then.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& filename);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+    std::string_view view() const { return std::string_view(data_, size_); }
+
+    // true if `count` items of `item_size` bytes starting at byte `offset` lie inside the
+    // mapping; overflow-safe, for validating offsets read from a file header
+    bool contains(uint64_t offset, uint64_t count, size_t item_size) const
+    {
+        return offset <= size_ && count <= (size_ - offset) / item_size;
+    }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+};
@@ -1,13 +1,19 @@
 #include "metrics.h"
+#include "latency_probe.h"
 #include "types.h"
 #include <algorithm>
 #include <limits>
 using namespace std;
 
-Metrics::Metrics(uint64_t initial_capital)
-    : initial_capital_(initial_capital) {}
+Metrics::Metrics(uint64_t initial_capital, pmr::memory_resource* resource)
+    : initial_capital_(initial_capital),
+      resource_(resource),
+      latency_sketch_(0.01, 2048, resource)
+{
+    reset();
+}
 
-Statistics Metrics::calculate(const vector<Trade>& trades)
+Statistics Metrics::calculate(span<const Trade> trades)
 {
     // Handle empty trades case
     if (trades.empty()) {
@@ -21,7 +27,8 @@ Statistics Metrics::calculate(const vector<Trade>& trades)
     double largest_loss = numeric_limits<double>::max();
     double total_entry_latency = 0.0;
     double total_exit_latency = 0.0;
-    vector<double> all_latencies;
+    pmr::vector<double> all_latencies(resource_);
+    all_latencies.reserve(trades.size());
 
     // For drawdown calculation
     double balance = static_cast<double>(initial_capital_);
@@ -62,13 +69,15 @@ Statistics Metrics::calculate(const vector<Trade>& trades)
     double avg_exit_latency = total_exit_latency / total_trades;
     
     // Calculate P99 latency
-    sort(all_latencies.begin(), all_latencies.end());
-    int p99_index = static_cast<int>(0.99 * all_latencies.size());
+    // nth_element is enough for one rank, no need to sort everything (twice)
+    size_t p99_index = static_cast<size_t>(0.99 * all_latencies.size());
+    nth_element(all_latencies.begin(), all_latencies.begin() + p99_index, all_latencies.end());
     double p99_latency = all_latencies[p99_index];
 
     //Calculate P50 latency
-    sort(all_latencies.begin(), all_latencies.end());
-    int p50_index = static_cast<int>(0.50 * all_latencies.size());
+    // everything left of p99_index is already <= it, select inside that part only
+    size_t p50_index = static_cast<size_t>(0.50 * all_latencies.size());
+    nth_element(all_latencies.begin(), all_latencies.begin() + p50_index, all_latencies.begin() + p99_index + 1);
     double p50_latency = all_latencies[p50_index];
     
     
@@ -89,4 +98,43 @@ Statistics Metrics::calculate(const vector<Trade>& trades)
     };
 }
 
+void Metrics::reset()
+{
+    pnl_.reset(static_cast<double>(initial_capital_));
+    total_entry_latency_ = 0.0;
+    total_exit_latency_ = 0.0;
+    latency_sketch_.clear();
+}
+
+void Metrics::on_trade(const Trade& trade)
+{
+    HX_PROBE(Probe::Metrics);
+
+    // same update order as calculate(), so the sums match it bit for bit
+    pnl_.add(trade.pnl);
+
+    total_entry_latency_ += trade.entry_latency_us;
+    total_exit_latency_ += trade.exit_latency_us;
+    latency_sketch_.add(static_cast<double>(trade.entry_latency_us + trade.exit_latency_us));
+}
+
+Statistics Metrics::snapshot() const
+{
+    if (pnl_.trades == 0) {
+        return Statistics{0, 0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    }
 
+    return Statistics{
+        pnl_.trades,
+        pnl_.wins,
+        pnl_.total_pnl,
+        (static_cast<double>(pnl_.wins) / static_cast<double>(pnl_.trades)) * 100.0,
+        pnl_.max_drawdown,
+        pnl_.largest_win,
+        pnl_.largest_loss,
+        total_entry_latency_ / pnl_.trades,
+        total_exit_latency_ / pnl_.trades,
+        latency_sketch_.quantile(0.99),
+        latency_sketch_.quantile(0.50)
+    };
+}
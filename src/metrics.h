@@ -1,15 +1,81 @@
 #pragma once
 #include "types.h"
+#include "quantile_sketch.h"
+#include <algorithm>
+#include <limits>
+#include <memory_resource>
+#include <span>
 #include <vector>
 using namespace std;
 
+// The pnl half of the streaming stats: balance, peak, drawdown and win/loss extremes.
+// Metrics::on_trade runs on it, and so does anything that replays pnl sequences
+// (MonteCarlo resamples), so every path updates in the same order and agrees bit for bit.
+// Value = int64_t is the fixed-point path (FixedMetrics), where every sum is exact.
+template <typename Value>
+struct BasicPnlStats
+{
+    uint64_t trades;
+    uint64_t wins;
+    Value total_pnl;
+    Value balance;
+    Value peak_balance;
+    Value max_drawdown;
+    Value largest_win;
+    Value largest_loss;
+
+    void reset(Value initial_capital)
+    {
+        trades = 0;
+        wins = 0;
+        total_pnl = 0;
+        balance = initial_capital;
+        peak_balance = balance;
+        max_drawdown = 0;
+        largest_win = numeric_limits<Value>::lowest();
+        largest_loss = numeric_limits<Value>::max();
+    }
+
+    void add(Value pnl)
+    {
+        trades++;
+        total_pnl += pnl;
+        balance += pnl;
+        wins += pnl > 0;
+        largest_win = max(largest_win, pnl);
+        largest_loss = min(largest_loss, pnl);
+        if (balance > peak_balance) {
+            peak_balance = balance;
+        }
+        max_drawdown = max(max_drawdown, peak_balance - balance);
+    }
+};
+
+using PnlStats = BasicPnlStats<double>;
+
 class Metrics {
     public:
-    explicit Metrics(uint64_t initial_capital);
+    // scratch space (latency sketch, calculate()'s latency buffer) comes from `resource`,
+    // e.g. a per-run RunArena
+    explicit Metrics(uint64_t initial_capital, pmr::memory_resource* resource = pmr::get_default_resource());
+
+    // exact batch computation over a finished run
+    Statistics calculate(span<const Trade> trades);
 
-    Statistics calculate(const vector<Trade>& trades);
+    // Streaming mode: feed trades as they close, O(1) per trade and fixed memory.
+    // Latency quantiles come from a QuantileSketch (1% relative error); everything
+    // else matches calculate() exactly. snapshot() can be called at any point in the run.
+    void on_trade(const Trade& trade);
+    Statistics snapshot() const;
+    void reset();
 
     private:
     uint64_t initial_capital_;
-};
+    pmr::memory_resource* resource_;
 
+    // streaming state
+    PnlStats pnl_;
+    double total_entry_latency_;
+    double total_exit_latency_;
+    QuantileSketch latency_sketch_;
+};
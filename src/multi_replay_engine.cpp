@@ -0,0 +1,99 @@
+#include "multi_replay_engine.h"
+#include <algorithm>
+#include <stdexcept>
+using namespace std;
+
+MultiReplayEngine::MultiReplayEngine(vector<span<const Kline>> streams)
+    : streams_(move(streams)),
+      positions_(streams_.size(), 0),
+      losers_(streams_.size(), kExhausted)
+{
+    if (streams_.size() > kStreamMask) {
+        throw runtime_error("Too many streams for MultiReplayEngine: " + to_string(streams_.size()));
+    }
+    for (const auto& stream : streams_) {
+        for (const auto& kline : stream) {
+            if (kline.timestamp_ms > kMaxTimestamp) {
+                throw runtime_error("Timestamp out of range for MultiReplayEngine: " + to_string(kline.timestamp_ms));
+            }
+        }
+    }
+    batch_.reserve(streams_.size());
+}
+
+uint64_t MultiReplayEngine::head_key(uint32_t stream) const
+{
+    size_t pos = positions_[stream];
+    if (pos >= streams_[stream].size()) {
+        return kExhausted;
+    }
+    // With hundreds of streams the hardware prefetcher can't follow them all. This stream
+    // is next read roughly one batch from now, so pull its following bar in already.
+    __builtin_prefetch(streams_[stream].data() + pos + 1);
+    return (streams_[stream][pos].timestamp_ms << kStreamBits) | stream;
+}
+
+void MultiReplayEngine::build_tree()
+{
+    const uint32_t k = static_cast<uint32_t>(streams_.size());
+    fill(positions_.begin(), positions_.end(), 0);
+    if (k == 0) {
+        return;
+    }
+
+    // leaves sit at k..2k-1; every internal node keeps the loser and passes the winner up
+    vector<uint64_t> winners(2 * k);
+    for (uint32_t i = 0; i < k; ++i) {
+        winners[k + i] = head_key(i);
+    }
+    for (uint32_t node = k - 1; node >= 1; --node) {
+        winners[node] = min(winners[2 * node], winners[2 * node + 1]);
+        losers_[node] = max(winners[2 * node], winners[2 * node + 1]);
+    }
+    losers_[0] = winners[1];
+}
+
+void MultiReplayEngine::advance(uint32_t stream)
+{
+    ++positions_[stream];
+
+    // replay the path from this leaf to the root; min/max compile to branch-free cmovs
+    const uint32_t k = static_cast<uint32_t>(streams_.size());
+    uint64_t winner = head_key(stream);
+    for (uint32_t node = (stream + k) / 2; node >= 1; node /= 2) {
+        uint64_t loser = losers_[node];
+        losers_[node] = max(loser, winner);
+        winner = min(loser, winner);
+    }
+    losers_[0] = winner;
+}
+
+vector<span<const Kline>> MultiReplayEngine::group_by_symbol(span<const Kline> klines, vector<Kline>& storage)
+{
+    uint32_t symbol_count = 0;
+    for (const auto& kline : klines) {
+        symbol_count = max(symbol_count, kline.symbol_id + 1);
+    }
+
+    // counting sort by symbol keeps each symbol's bars in their original (time) order
+    vector<size_t> offsets(symbol_count + 1, 0);
+    for (const auto& kline : klines) {
+        ++offsets[kline.symbol_id + 1];
+    }
+    for (uint32_t s = 0; s < symbol_count; ++s) {
+        offsets[s + 1] += offsets[s];
+    }
+
+    storage.resize(klines.size());
+    vector<size_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (const auto& kline : klines) {
+        storage[cursor[kline.symbol_id]++] = kline;
+    }
+
+    vector<span<const Kline>> streams;
+    streams.reserve(symbol_count);
+    for (uint32_t s = 0; s < symbol_count; ++s) {
+        streams.emplace_back(storage.data() + offsets[s], offsets[s + 1] - offsets[s]);
+    }
+    return streams;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+#include "types.h"
+
+using namespace std;
+
+// k-way merge replay over many time-sorted kline streams (typically one per symbol).
+// A loser tree picks the next stream in O(log k) with one comparison per level, and all
+// bars that share a timestamp are handed to the callback together as one batch.
+// Streams are borrowed and must outlive the engine.
+class MultiReplayEngine {
+public:
+    explicit MultiReplayEngine(vector<span<const Kline>> streams);
+
+    // on_batch(timestamp_ms, span<const Kline> bars)
+    template <typename Callback>
+        requires invocable<Callback&, uint64_t, span<const Kline>>
+    void replay(Callback&& on_batch);
+
+    uint64_t current_time_ms() const { return current_time_ms_; }
+    size_t stream_count() const { return streams_.size(); }
+
+    // Stable-partitions klines by symbol_id into storage and returns one span per
+    // symbol_id (empty spans for IDs that never appear).
+    static vector<span<const Kline>> group_by_symbol(span<const Kline> klines, vector<Kline>& storage);
+
+private:
+    /* --- Tree nodes hold one packed key: head timestamp << 20 | stream index.
+    A single integer compare orders by time and breaks ties by stream index (so batches
+    are deterministic), and the tree walk never has to chase back into the streams. */
+    static constexpr uint32_t kStreamBits = 20;
+    static constexpr uint64_t kStreamMask = (1ULL << kStreamBits) - 1;
+    static constexpr uint64_t kMaxTimestamp = (1ULL << (64 - kStreamBits)) - 2;
+    static constexpr uint64_t kExhausted = numeric_limits<uint64_t>::max();
+
+    uint64_t head_key(uint32_t stream) const;
+    void build_tree();
+    void advance(uint32_t stream);
+
+    vector<span<const Kline>> streams_;
+    vector<size_t> positions_;
+    vector<uint64_t> losers_;    // losers_[0] is the overall winner
+    vector<Kline> batch_;
+    uint64_t current_time_ms_ = 0;
+};
+
+template <typename Callback>
+    requires invocable<Callback&, uint64_t, span<const Kline>>
+void MultiReplayEngine::replay(Callback&& on_batch)
+{
+    build_tree();
+    if (streams_.empty()) {
+        return;
+    }
+
+    while (losers_[0] != kExhausted) {
+        uint64_t timestamp = losers_[0] >> kStreamBits;
+        batch_.clear();
+        while (losers_[0] != kExhausted && (losers_[0] >> kStreamBits) == timestamp) {
+            uint32_t winner = static_cast<uint32_t>(losers_[0] & kStreamMask);
+            batch_.push_back(streams_[winner][positions_[winner]]);
+            advance(winner);
+        }
+        current_time_ms_ = timestamp;
+        on_batch(timestamp, span<const Kline>(batch_));
+    }
+}
@@ -0,0 +1,305 @@
+#include "order_book.h"
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+OrderBook::OrderBook(double tick_size, size_t ladder_levels)
+    : tick_size_(tick_size), levels_(ladder_levels), bids_(ladder_levels, 0.0), asks_(ladder_levels, 0.0),
+      best_ask_(static_cast<int64_t>(ladder_levels))
+{
+    if (!(tick_size > 0.0)) {
+        throw runtime_error("OrderBook tick size must be positive");
+    }
+    if (ladder_levels < 2) {
+        throw runtime_error("OrderBook needs at least 2 ladder levels");
+    }
+}
+
+void OrderBook::clear()
+{
+    fill(bids_.begin(), bids_.end(), 0.0);
+    fill(asks_.begin(), asks_.end(), 0.0);
+    best_bid_ = -1;
+    best_ask_ = static_cast<int64_t>(levels_);
+    bid_levels_ = ask_levels_ = 0;
+    based_ = false;
+}
+
+int64_t OrderBook::slot(int64_t ticks)
+{
+    int64_t size = static_cast<int64_t>(levels_);
+    if (!based_) {
+        base_ticks_ = ticks - size / 2;
+        based_ = true;
+    }
+    int64_t index = ticks - base_ticks_;
+    if (index >= 0 && index < size) {
+        return index;
+    }
+
+    if (bid_levels_ + ask_levels_ == 0) {
+        recentre(ticks);
+    } else {
+        // centre on the touch; a level that wouldn't fit even then is too deep to matter
+        int64_t touch = has_bid() && has_ask() ? base_ticks_ + (best_bid_ + best_ask_) / 2
+                        : has_bid()            ? base_ticks_ + best_bid_
+                                               : base_ticks_ + best_ask_;
+        if (ticks - touch >= size / 2 || touch - ticks > size / 2) {
+            return -1;
+        }
+        recentre(touch);
+    }
+    return ticks - base_ticks_;
+}
+
+void OrderBook::recentre(int64_t centre_ticks)
+{
+    int64_t size = static_cast<int64_t>(levels_);
+    int64_t shift = centre_ticks - size / 2 - base_ticks_;   // new index = old index - shift
+    auto move = [&](vector<double>& side) {
+        if (shift >= size || -shift >= size) {
+            fill(side.begin(), side.end(), 0.0);
+        } else if (shift > 0) {
+            copy(side.begin() + shift, side.end(), side.begin());
+            fill(side.end() - shift, side.end(), 0.0);
+        } else if (shift < 0) {
+            copy_backward(side.begin(), side.end() + shift, side.end());
+            fill(side.begin(), side.begin() - shift, 0.0);
+        }
+    };
+    move(bids_);
+    move(asks_);
+    base_ticks_ += shift;
+
+    // rare: recount from scratch rather than track what fell off the edges
+    bid_levels_ = static_cast<size_t>(count_if(bids_.begin(), bids_.end(), [](double q) { return q > 0.0; }));
+    ask_levels_ = static_cast<size_t>(count_if(asks_.begin(), asks_.end(), [](double q) { return q > 0.0; }));
+    best_bid_ = size;
+    best_ask_ = -1;
+    rescan_bid();
+    rescan_ask();
+}
+
+void OrderBook::rescan_bid()
+{
+    if (bid_levels_ == 0) {
+        best_bid_ = -1;
+        return;
+    }
+    int64_t i = min<int64_t>(best_bid_, static_cast<int64_t>(levels_)) - 1;
+    while (i >= 0 && bids_[i] <= 0.0) --i;
+    best_bid_ = i;
+}
+
+void OrderBook::rescan_ask()
+{
+    int64_t size = static_cast<int64_t>(levels_);
+    if (ask_levels_ == 0) {
+        best_ask_ = size;
+        return;
+    }
+    int64_t i = max<int64_t>(best_ask_, -1) + 1;
+    while (i < size && asks_[i] <= 0.0) ++i;
+    best_ask_ = i;
+}
+
+void OrderBook::apply(const BookUpdate& update)
+{
+    int64_t index = slot(to_ticks(update.price));
+    if (index < 0) {
+        ++dropped_updates_;
+        return;
+    }
+    double quantity = update.quantity > 0.0 ? update.quantity : 0.0;
+
+    if (update.side == Side::Bid) {
+        double old = bids_[index];
+        bids_[index] = quantity;
+        if (quantity > 0.0) {
+            bid_levels_ += old <= 0.0;
+            best_bid_ = max(best_bid_, index);
+        } else if (old > 0.0) {
+            --bid_levels_;
+            if (index == best_bid_) {
+                best_bid_ = index + 1;
+                rescan_bid();
+            }
+        }
+    } else {
+        double old = asks_[index];
+        asks_[index] = quantity;
+        if (quantity > 0.0) {
+            ask_levels_ += old <= 0.0;
+            best_ask_ = min(best_ask_, index);
+        } else if (old > 0.0) {
+            --ask_levels_;
+            if (index == best_ask_) {
+                best_ask_ = index - 1;
+                rescan_ask();
+            }
+        }
+    }
+}
+
+void OrderBook::apply_snapshot(span<const BookUpdate> levels)
+{
+    clear();
+    for (const auto& level : levels) {
+        apply(level);
+    }
+}
+
+double OrderBook::quantity_at(Side side, double price) const
+{
+    int64_t index = to_ticks(price) - base_ticks_;
+    if (!based_ || index < 0 || index >= static_cast<int64_t>(levels_)) {
+        return 0.0;
+    }
+    return side == Side::Bid ? bids_[index] : asks_[index];
+}
+
+BookSweep OrderBook::sweep(bool is_buy, double quantity, double limit_price) const
+{
+    BookSweep result{0.0, NAN, 0};
+    bool limited = !isnan(limit_price);
+    int64_t limit = limited ? to_ticks(limit_price) - base_ticks_ : 0;
+    double notional = 0.0;
+    double remaining = quantity;
+
+    const vector<double>& side = is_buy ? asks_ : bids_;
+    size_t populated = is_buy ? ask_levels_ : bid_levels_;
+    int64_t step = is_buy ? 1 : -1;
+    int64_t size = static_cast<int64_t>(levels_);
+    for (int64_t i = is_buy ? best_ask_ : best_bid_; i >= 0 && i < size; i += step) {
+        if (remaining <= 0.0 || result.levels >= populated) break;
+        if (limited && (is_buy ? i > limit : i < limit)) break;
+        double available = side[i];
+        if (available <= 0.0) continue;
+        double take = min(remaining, available);
+        notional += take * price_of(i);
+        remaining -= take;
+        result.filled += take;
+        ++result.levels;
+    }
+    if (result.filled > 0.0) {
+        result.average_price = notional / result.filled;
+    }
+    return result;
+}
+
+// ---- BookFillSimulator
+
+uint64_t BookFillSimulator::place_limit(Side side, double price, double quantity, uint64_t timestamp_ms)
+{
+    uint64_t id = next_id_++;
+    SimOrder order{id, book_.to_ticks(price), price, quantity, 0.0, 0.0, 0.0, side};
+
+    // marketable: take what the book offers up to the limit, the rest rests
+    bool is_buy = side == Side::Bid;
+    bool crosses = is_buy ? book_.has_ask() && book_.to_ticks(book_.best_ask()) <= order.ticks
+                          : book_.has_bid() && book_.to_ticks(book_.best_bid()) >= order.ticks;
+    if (crosses) {
+        BookSweep taken = book_.sweep(is_buy, quantity, price);
+        if (taken.filled > 0.0) {
+            order.remaining -= taken.filled;
+            fills_.push_back(BookFill{id, timestamp_ms, taken.average_price, taken.filled, order.remaining <= 0.0});
+        }
+    }
+    if (order.remaining > 0.0) {
+        order.level_size = book_.quantity_at(side, price);
+        order.queue_ahead = order.level_size;
+        orders_.push_back(order);
+    }
+    return id;
+}
+
+bool BookFillSimulator::cancel(uint64_t order_id)
+{
+    auto it = find_if(orders_.begin(), orders_.end(), [&](const SimOrder& o) { return o.id == order_id; });
+    if (it == orders_.end()) return false;
+    orders_.erase(it);
+    return true;
+}
+
+double BookFillSimulator::queue_ahead(uint64_t order_id) const
+{
+    for (const auto& o : orders_) {
+        if (o.id == order_id) return o.queue_ahead;
+    }
+    return NAN;
+}
+
+void BookFillSimulator::fill(size_t index, uint64_t timestamp_ms, double price, double quantity)
+{
+    SimOrder& o = orders_[index];
+    quantity = min(quantity, o.remaining);
+    if (quantity <= 0.0) return;
+    o.remaining -= quantity;
+    fills_.push_back(BookFill{o.id, timestamp_ms, price, quantity, o.remaining <= 0.0});
+}
+
+void BookFillSimulator::remove_done()
+{
+    orders_.erase(remove_if(orders_.begin(), orders_.end(), [](const SimOrder& o) { return o.remaining <= 0.0; }),
+                  orders_.end());
+}
+
+void BookFillSimulator::on_update(const BookUpdate& update)
+{
+    book_.apply(update);
+    if (orders_.empty()) return;
+
+    int64_t ticks = book_.to_ticks(update.price);
+    int64_t best_bid = book_.has_bid() ? book_.to_ticks(book_.best_bid()) : INT64_MIN;
+    int64_t best_ask = book_.has_ask() ? book_.to_ticks(book_.best_ask()) : INT64_MAX;
+    bool any_done = false;
+    for (size_t i = 0; i < orders_.size(); ++i) {
+        SimOrder& o = orders_[i];
+        if (o.side == update.side && o.ticks == ticks) {
+            double size = update.quantity > 0.0 ? update.quantity : 0.0;
+            // size gone without prints = cancellations, spread evenly over the level
+            double cancelled = o.level_size - size - o.traded;
+            if (cancelled > 0.0 && o.level_size > 0.0) {
+                o.queue_ahead -= cancelled * (o.queue_ahead / o.level_size);
+            }
+            o.queue_ahead = clamp(o.queue_ahead, 0.0, size);
+            o.level_size = size;
+            o.traded = 0.0;
+        }
+        // the other side came through our price: we'd have been taken out
+        bool crossed = o.side == Side::Bid ? best_ask <= o.ticks : best_bid >= o.ticks;
+        if (crossed) {
+            fill(i, update.timestamp_ms, o.price, o.remaining);
+            any_done = true;
+        }
+    }
+    if (any_done) remove_done();
+}
+
+void BookFillSimulator::on_trade(uint64_t timestamp_ms, double price, double quantity, bool buyer_is_maker)
+{
+    if (orders_.empty()) return;
+
+    int64_t ticks = book_.to_ticks(price);
+    bool any_done = false;
+    for (size_t i = 0; i < orders_.size(); ++i) {
+        SimOrder& o = orders_[i];
+        // bids are hit by sellers (buyer is maker), asks are lifted by buyers
+        if ((o.side == Side::Bid) != buyer_is_maker) continue;
+
+        bool through = o.side == Side::Bid ? ticks < o.ticks : ticks > o.ticks;
+        if (through) {
+            fill(i, timestamp_ms, o.price, o.remaining);
+        } else if (ticks == o.ticks) {
+            o.traded += quantity;
+            double past_us = quantity - o.queue_ahead;
+            o.queue_ahead = max(o.queue_ahead - quantity, 0.0);
+            if (past_us > 0.0) {
+                fill(i, timestamp_ms, o.price, past_us);
+            }
+        }
+        any_done |= o.remaining <= 0.0;
+    }
+    if (any_done) remove_done();
+}
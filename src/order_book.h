@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+using namespace std;
+
+enum class Side : uint8_t { Bid, Ask };
+
+// One L2 level as Binance depth streams send it: the level's new total size, 0 removes it
+struct BookUpdate
+{
+    uint64_t timestamp_ms;
+    double price;
+    double quantity;
+    Side side;
+};
+
+struct BookSweep
+{
+    double filled;          // what the book could give within the limit
+    double average_price;   // NaN when nothing filled
+    size_t levels;          // price levels touched
+};
+
+/* --- L2 order book on a flat price ladder.
+Both sides are plain arrays of level sizes indexed by tick offset from a shared base, so an
+update is an index computation and a store; the best bid/ask are tracked as indices and only
+rescanned when the best level empties. The ladder spans `ladder_levels` ticks and recentres
+on the touch when prices walk off an edge; levels further than half a ladder from the touch
+are dropped (counted in dropped_updates()), they never matter for fills. No maps, no nodes. */
+class OrderBook
+{
+public:
+    explicit OrderBook(double tick_size, size_t ladder_levels = 1 << 16);
+
+    void clear();
+    void apply(const BookUpdate& update);
+    // replaces the whole book with these levels
+    void apply_snapshot(span<const BookUpdate> levels);
+
+    bool has_bid() const { return best_bid_ >= 0; }
+    bool has_ask() const { return best_ask_ < static_cast<int64_t>(levels_); }
+    double best_bid() const { return has_bid() ? price_of(best_bid_) : NAN; }
+    double best_ask() const { return has_ask() ? price_of(best_ask_) : NAN; }
+    double quantity_at(Side side, double price) const;
+
+    // Walks the opposite side for a marketable order of `quantity` (buy -> asks), not going
+    // past `limit_price` (NaN = no limit). The book itself is left untouched.
+    BookSweep sweep(bool is_buy, double quantity, double limit_price = NAN) const;
+
+    double tick_size() const { return tick_size_; }
+    int64_t to_ticks(double price) const { return llround(price / tick_size_); }
+    uint64_t dropped_updates() const { return dropped_updates_; }
+
+private:
+    double price_of(int64_t index) const { return static_cast<double>(base_ticks_ + index) * tick_size_; }
+    // slot for `ticks`, recentring if needed; -1 when the level is too deep to keep
+    int64_t slot(int64_t ticks);
+    void recentre(int64_t centre_ticks);
+    void rescan_bid();
+    void rescan_ask();
+
+    double tick_size_;
+    size_t levels_;
+    int64_t base_ticks_ = 0;
+    bool based_ = false;
+    vector<double> bids_;
+    vector<double> asks_;
+    int64_t best_bid_ = -1;     // index, -1 = no bids
+    int64_t best_ask_;          // index, levels_ = no asks
+    size_t bid_levels_ = 0;     // non-empty levels per side, so empty sides never scan
+    size_t ask_levels_ = 0;
+    uint64_t dropped_updates_ = 0;
+};
+
+struct BookFill
+{
+    uint64_t order_id;
+    uint64_t timestamp_ms;
+    double price;
+    double quantity;
+    bool complete;          // order fully filled by this fill
+};
+
+/* --- Queue-position fills for our own limit orders against a replayed book.
+An order joins the back of its level: everything resting there is ahead of it. Trades at
+the level eat the queue from the front and fill us once they get past it; size that leaves
+the level without a matching trade is treated as cancellations spread evenly through the
+queue, so it only moves us up in proportion to what is ahead. A trade through our price, or
+the opposite side crossing it, fills what is left. Marketable orders take liquidity at once. */
+class BookFillSimulator
+{
+public:
+    explicit BookFillSimulator(OrderBook& book) : book_(book) {}
+
+    uint64_t place_limit(Side side, double price, double quantity, uint64_t timestamp_ms = 0);
+    bool cancel(uint64_t order_id);
+
+    // applies the update to the book and moves the queues it touches
+    void on_update(const BookUpdate& update);
+    // a print from the trade stream; buyer_is_maker = the seller hit the bid
+    void on_trade(uint64_t timestamp_ms, double price, double quantity, bool buyer_is_maker);
+
+    span<const BookFill> fills() const { return fills_; }
+    void clear_fills() { fills_.clear(); }
+    size_t open_orders() const { return orders_.size(); }
+    // size ahead of an open order, NaN if it is not open
+    double queue_ahead(uint64_t order_id) const;
+
+private:
+    struct SimOrder
+    {
+        uint64_t id;
+        int64_t ticks;
+        double price;
+        double remaining;
+        double queue_ahead;
+        double level_size;     // level size at the last update we saw
+        double traded;         // traded at our level since that update
+        Side side;
+    };
+
+    void fill(size_t index, uint64_t timestamp_ms, double price, double quantity);
+    void remove_done();
+
+    OrderBook& book_;
+    vector<SimOrder> orders_;   // a handful at a time: a flat vector beats any index
+    vector<BookFill> fills_;
+    uint64_t next_id_ = 1;
+};
@@ -1,10 +1,249 @@
 #include "parser.h"
+#include "csv_scanner.h"
+#include "latency_probe.h"
+#include <algorithm>
+#include <charconv>
+#include <exception>
 #include <sstream>
 #include <stdexcept>
+#include <thread>
+#include <utility>
 using namespace std;
 
 // Initialized a static member
-unordered_map<string, uint32_t> Parser::symbol_cache;
+SymbolTable Parser::symbol_cache;
+
+namespace {
+
+// returns the field starting at pos and moves pos past the next comma
+string_view next_field(string_view line, size_t& pos)
+{
+    // ran out of fields, the empty view makes the number parse fail loudly
+    if (pos > line.size()) {
+        return string_view();
+    }
+    size_t end = line.find(',', pos);
+    if (end == string_view::npos) {
+        end = line.size();
+    }
+    string_view field = line.substr(pos, end - pos);
+    pos = end + 1;
+    return field;
+}
+
+template <typename T>
+T parse_number(string_view field)
+{
+    T value{};
+    auto [ptr, ec] = from_chars(field.data(), field.data() + field.size(), value);
+    if (ec != errc() || ptr != field.data() + field.size()) {
+        throw runtime_error("Invalid number in kline field: '" + string(field) + "'");
+    }
+    return value;
+}
+
+// separators are scanned this many bytes at a time so the offsets stay in L1/L2
+constexpr size_t kScanBlockSize = 64 * 1024;
+
+constexpr size_t kKlineFields = 7;
+
+// Walks the buffer block by block, slicing rows out of the separator offsets that
+// CsvScanner finds. on_row(fields, field_count) is called for every line;
+// reserve(estimate) once, with a row-count guess taken from the first block.
+template <typename OnRow, typename Reserve>
+void scan_rows(span<const char> data, OnRow&& on_row, Reserve&& reserve)
+{
+    const char* base = data.data();
+    const size_t total = data.size();
+
+    vector<uint32_t> separators;
+    separators.reserve(kScanBlockSize / 4);
+
+    size_t block_start = 0;
+    while (block_start < total) {
+        const char* block = base + block_start;
+        size_t block_len = min(kScanBlockSize, total - block_start);
+        bool last_block = block_start + block_len == total;
+
+        separators.clear();
+        CsvScanner::find_separators(block, block_len, separators);
+
+        string_view fields[kKlineFields];
+        size_t field_count = 0;
+        size_t field_start = 0;
+        size_t line_start = 0;
+        size_t lines = 0;
+
+        for (uint32_t sep : separators) {
+            if (field_count < kKlineFields) {
+                fields[field_count] = string_view(block + field_start, sep - field_start);
+            }
+            ++field_count;
+            field_start = sep + 1;
+
+            if (block[sep] == '\n') {
+                on_row(fields, field_count);
+                field_count = 0;
+                line_start = field_start;
+                ++lines;
+            }
+        }
+
+        if (last_block) {
+            // final row without a trailing newline
+            if (line_start < block_len) {
+                if (field_count < kKlineFields) {
+                    fields[field_count] = string_view(block + field_start, block_len - field_start);
+                }
+                on_row(fields, field_count + 1);
+            }
+            break;
+        }
+
+        if (line_start == 0) {
+            throw runtime_error("Kline row longer than scan block");
+        }
+
+        // size the output from the first block instead of letting it regrow
+        if (block_start == 0) {
+            size_t estimate = lines * (total / line_start + 1);
+            reserve(estimate + estimate / 16);
+        }
+
+        // the partial row at the end of the block is rescanned with the next one
+        block_start += line_start;
+    }
+}
+
+// Turns sliced fields into a Kline, interning symbols into the given table
+class RowDecoder
+{
+public:
+    // header_allowed: the buffer starts at the top of the file, so its first row may be a header
+    explicit RowDecoder(SymbolTable& symbols, bool header_allowed = true)
+        : symbols_(symbols), header_allowed_(header_allowed) {}
+
+    // DataLoader::load_klines's rule: blank lines are skipped, and so is the first row if
+    // it doesn't start with a digit (the header). Every other row is data, and decode()
+    // throws on a malformed one rather than letting it drop out of the count.
+    bool is_data_row(const string_view* fields, size_t field_count)
+    {
+        if (field_count == 1 && (fields[0].empty() || fields[0] == "\r")) {
+            return false;
+        }
+        bool header = exchange(header_allowed_, false) &&
+                      (fields[0].empty() || static_cast<unsigned>(fields[0].front() - '0') >= 10);
+        return !header;
+    }
+
+    Kline decode(const string_view* fields, size_t field_count)
+    {
+        HX_PROBE(Probe::Parse);
+
+        if (field_count != kKlineFields) {
+            throw runtime_error("Malformed kline row starting with: '" + string(fields[0]) + "'");
+        }
+
+        // consecutive rows almost always share a symbol, skip the hash lookup when they do
+        string_view symbol = fields[1];
+        if (symbol != last_symbol_ || last_symbol_.empty()) {
+            last_symbol_ = symbol;
+            last_symbol_id_ = symbols_.intern(symbol);
+        }
+
+        string_view volume = fields[6];
+        if (!volume.empty() && volume.back() == '\r') {
+            volume.remove_suffix(1);
+        }
+
+        return Kline{
+            parse_number<uint64_t>(fields[0]),
+            0,
+            last_symbol_id_,
+            CsvScanner::parse_decimal(fields[2]),
+            CsvScanner::parse_decimal(fields[3]),
+            CsvScanner::parse_decimal(fields[4]),
+            CsvScanner::parse_decimal(fields[5]),
+            CsvScanner::parse_decimal(volume)
+        };
+    }
+
+    FixedKline decode_fixed(const string_view* fields, size_t field_count)
+    {
+        HX_PROBE(Probe::Parse);
+
+        if (field_count != kKlineFields) {
+            throw runtime_error("Malformed kline row starting with: '" + string(fields[0]) + "'");
+        }
+
+        string_view symbol = fields[1];
+        if (symbol != last_symbol_ || last_symbol_.empty()) {
+            last_symbol_ = symbol;
+            last_symbol_id_ = symbols_.intern(symbol);
+        }
+        const FixedScale& scale = symbols_.scale(last_symbol_id_);
+
+        string_view volume = fields[6];
+        if (!volume.empty() && volume.back() == '\r') {
+            volume.remove_suffix(1);
+        }
+
+        return FixedKline{
+            parse_number<uint64_t>(fields[0]),
+            CsvScanner::parse_fixed(fields[2], scale.price_decimals),
+            CsvScanner::parse_fixed(fields[3], scale.price_decimals),
+            CsvScanner::parse_fixed(fields[4], scale.price_decimals),
+            CsvScanner::parse_fixed(fields[5], scale.price_decimals),
+            CsvScanner::parse_fixed(volume, scale.quantity_decimals),
+            last_symbol_id_
+        };
+    }
+
+private:
+    SymbolTable& symbols_;
+    bool header_allowed_;
+    string_view last_symbol_;
+    uint32_t last_symbol_id_ = 0;
+};
+
+// per-thread result of parse_klines_parallel
+struct ParsedChunk
+{
+    vector<Kline> klines;
+    SymbolTable symbols;
+    bool sorted = true;
+};
+
+// only the first chunk holds the top of the file, and with it the header
+void parse_chunk(span<const char> data, ParsedChunk& chunk, bool header_allowed)
+{
+    RowDecoder decoder(chunk.symbols, header_allowed);
+    scan_rows(data,
+        [&](const string_view* fields, size_t field_count) {
+            if (!decoder.is_data_row(fields, field_count)) {
+                return;
+            }
+            Kline kline = decoder.decode(fields, field_count);
+            if (!chunk.klines.empty() && kline.timestamp_ms < chunk.klines.back().timestamp_ms) {
+                chunk.sorted = false;
+            }
+            chunk.klines.push_back(kline);
+        },
+        [&](size_t estimate) { chunk.klines.reserve(estimate); });
+}
+
+}
+
+void KlineColumns::reserve(size_t n)
+{
+    timestamp_ms.reserve(n);
+    symbol_id.reserve(n);
+    open.reserve(n);
+    high.reserve(n);
+    low.reserve(n);
+    close.reserve(n);
+    volume.reserve(n);
+}
 
 Kline Parser::parse_kline(const string& line) {
     stringstream ss(line);
@@ -20,7 +259,7 @@ Kline Parser::parse_kline(const string& line) {
 
     //parse open
     getline(ss, field, ',');
-    double open = stof(field);
+    double open = stod(field);
 
     // Parse high
     getline(ss, field, ',');
@@ -43,17 +282,185 @@ Kline Parser::parse_kline(const string& line) {
 
 }
 
-uint32_t Parser::symbol_to_id(const string& symbol)
+FixedKline Parser::parse_kline_fixed(string_view line) {
+    HX_PROBE(Probe::Parse);
+
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+
+    size_t pos = 0;
+    uint64_t timestamp_ms = parse_number<uint64_t>(next_field(line, pos));
+    uint32_t symbol_id = symbol_to_id(next_field(line, pos));
+    const FixedScale& scale = symbol_cache.scale(symbol_id);
+    int64_t open = CsvScanner::parse_fixed(next_field(line, pos), scale.price_decimals);
+    int64_t high = CsvScanner::parse_fixed(next_field(line, pos), scale.price_decimals);
+    int64_t low = CsvScanner::parse_fixed(next_field(line, pos), scale.price_decimals);
+    int64_t close = CsvScanner::parse_fixed(next_field(line, pos), scale.price_decimals);
+    int64_t volume = CsvScanner::parse_fixed(next_field(line, pos), scale.quantity_decimals);
+
+    return FixedKline{timestamp_ms, open, high, low, close, volume, symbol_id};
+}
+
+vector<FixedKline> Parser::parse_klines_fixed(span<const char> data) {
+    vector<FixedKline> klines;
+    RowDecoder decoder(symbol_cache);
+    scan_rows(data,
+        [&](const string_view* fields, size_t field_count) {
+            if (decoder.is_data_row(fields, field_count)) {
+                klines.push_back(decoder.decode_fixed(fields, field_count));
+            }
+        },
+        [&](size_t estimate) { klines.reserve(estimate); });
+    return klines;
+}
+
+void Parser::set_fixed_scale(string_view symbol, const FixedScale& scale) {
+    symbol_cache.set_scale(symbol_cache.intern(symbol), scale);
+}
+
+Kline Parser::parse_kline(string_view line) {
+    HX_PROBE(Probe::Parse);
+
+    // tolerate CRLF files
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+
+    size_t pos = 0;
+    uint64_t timestamp_ms = parse_number<uint64_t>(next_field(line, pos));
+    uint32_t symbol_id = symbol_to_id(next_field(line, pos));
+    double open = parse_number<double>(next_field(line, pos));
+    double high = parse_number<double>(next_field(line, pos));
+    double low = parse_number<double>(next_field(line, pos));
+    double close = parse_number<double>(next_field(line, pos));
+    double volume = parse_number<double>(next_field(line, pos));
+
+    return Kline{timestamp_ms, 0, symbol_id, open, high, low, close, volume};
+}
+
+uint32_t Parser::symbol_to_id(string_view symbol)
+{
+    return symbol_cache.intern(symbol);
+}
+
+KlineColumns Parser::parse_klines(span<const char> data)
 {
-    //check cache first
-    auto it = symbol_cache.find(symbol);
-    if (it != symbol_cache.end()) {
-        return it->second;
+    KlineColumns columns;
+    RowDecoder decoder(symbol_cache);
+
+    scan_rows(data,
+        [&](const string_view* fields, size_t field_count) {
+            if (!decoder.is_data_row(fields, field_count)) {
+                return;
+            }
+            Kline kline = decoder.decode(fields, field_count);
+            columns.timestamp_ms.push_back(kline.timestamp_ms);
+            columns.symbol_id.push_back(kline.symbol_id);
+            columns.open.push_back(kline.open);
+            columns.high.push_back(kline.high);
+            columns.low.push_back(kline.low);
+            columns.close.push_back(kline.close);
+            columns.volume.push_back(kline.volume);
+        },
+        [&](size_t estimate) { columns.reserve(estimate); });
+
+    return columns;
+}
+
+vector<Kline> Parser::parse_klines_parallel(span<const char> data, unsigned threads)
+{
+    if (threads == 0) {
+        threads = max(1u, thread::hardware_concurrency());
+    }
+    // don't hand out chunks smaller than a couple of scan blocks
+    threads = static_cast<unsigned>(min<size_t>(threads, data.size() / (2 * kScanBlockSize) + 1));
+
+    // chunk boundaries, each moved forward to just past a newline
+    vector<size_t> bounds(threads + 1, data.size());
+    bounds[0] = 0;
+    for (unsigned i = 1; i < threads; ++i) {
+        size_t pos = max(bounds[i - 1], data.size() / threads * i);
+        while (pos < data.size() && data[pos - 1] != '\n') {
+            ++pos;
+        }
+        bounds[i] = pos;
     }
 
-    //new symbol -> assign next ID
-    uint32_t new_id = symbol_cache.size();
-    symbol_cache[symbol] = new_id;
-    return new_id;  
+    vector<ParsedChunk> chunks(threads);
+    vector<exception_ptr> errors(threads);
+    {
+        vector<thread> workers;
+        workers.reserve(threads);
+        for (unsigned i = 0; i < threads; ++i) {
+            workers.emplace_back([&, i] {
+                try {
+                    parse_chunk(data.subspan(bounds[i], bounds[i + 1] - bounds[i]), chunks[i], i == 0);
+                } catch (...) {
+                    errors[i] = current_exception();
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+    for (auto& error : errors) {
+        if (error) {
+            rethrow_exception(error);
+        }
+    }
+
+    // Intern chunk-local symbols into the global table in file order. Local IDs are
+    // first-seen order within a chunk, so the global IDs come out exactly as a serial parse would.
+    vector<vector<uint32_t>> remap(threads);
+    for (unsigned i = 0; i < threads; ++i) {
+        for (const auto& name : chunks[i].symbols.names()) {
+            remap[i].push_back(symbol_cache.intern(name));
+        }
+    }
+
+    // output offsets; the chunks line up in time if each is sorted and they don't overlap
+    vector<size_t> offsets(threads + 1, 0);
+    bool in_order = true;
+    uint64_t last_ts = 0;
+    for (unsigned i = 0; i < threads; ++i) {
+        const auto& klines = chunks[i].klines;
+        offsets[i + 1] = offsets[i] + klines.size();
+        if (klines.empty()) {
+            continue;
+        }
+        in_order = in_order && chunks[i].sorted && klines.front().timestamp_ms >= last_ts;
+        last_ts = klines.back().timestamp_ms;
+    }
 
-}
\ No newline at end of file
+    // remap IDs and copy every chunk into its slot in parallel
+    vector<Kline> result(offsets[threads]);
+    {
+        vector<thread> workers;
+        workers.reserve(threads);
+        for (unsigned i = 0; i < threads; ++i) {
+            workers.emplace_back([&, i] {
+                auto& klines = chunks[i].klines;
+                const auto& ids = remap[i];
+                Kline* out = result.data() + offsets[i];
+                for (size_t j = 0; j < klines.size(); ++j) {
+                    out[j] = klines[j];
+                    out[j].symbol_id = ids[klines[j].symbol_id];
+                }
+                vector<Kline>().swap(klines);
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    // out-of-order input: stable sort keeps file order among equal timestamps
+    if (!in_order) {
+        stable_sort(result.begin(), result.end(),
+            [](const Kline& a, const Kline& b) { return a.timestamp_ms < b.timestamp_ms; });
+    }
+
+    return result;
+}
@@ -1,17 +1,70 @@
 #pragma once
 
+#include <span>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <vector>
+#include "symbol_table.h"
 #include "types.h"
 
 using namespace std;
 
+// Column-per-field kline batch produced by Parser::parse_klines
+struct KlineColumns
+{
+    vector<uint64_t> timestamp_ms;
+    vector<uint32_t> symbol_id;
+    vector<double> open;
+    vector<double> high;
+    vector<double> low;
+    vector<double> close;
+    vector<double> volume;
+
+    size_t size() const { return timestamp_ms.size(); }
+    void reserve(size_t n);
+    Kline at(size_t i) const
+    {
+        return Kline{timestamp_ms[i], 0, symbol_id[i], open[i], high[i], low[i], close[i], volume[i]};
+    }
+};
+
 class Parser
 {
 public:
     static Kline parse_kline(const string &line);
-    static uint32_t symbol_to_id(const string &symbol);
+
+    // zero-copy variant: fields are sliced out of the view and parsed in place with from_chars
+    static Kline parse_kline(string_view line);
+
+    // Batch parse of a whole CSV buffer straight into columns.
+    // Separators are located with CsvScanner one cache-sized block at a time and the
+    // numeric columns go through its fixed-format decimal parser. Rows are taken as
+    // DataLoader::load_klines takes them: blank lines and a header in the first row are
+    // skipped, any other malformed row throws.
+    static KlineColumns parse_klines(span<const char> data);
+
+    // Splits the buffer at newline boundaries into `threads` chunks and parses each on its own
+    // thread with a private symbol table. Symbols are then interned into the global table in
+    // file order (so IDs match a serial parse) and the chunks are merged in timestamp order.
+    // Same row rules as parse_klines; only the first chunk may start with a header.
+    // threads == 0 uses every hardware thread.
+    static vector<Kline> parse_klines_parallel(span<const char> data, unsigned threads = 0);
+
+    // Fixed-point parsing: prices and volume scaled by the row's symbol's FixedScale,
+    // exactly (see CsvScanner::parse_fixed). Set scales before parsing. The batch parse
+    // takes rows like parse_klines.
+    static FixedKline parse_kline_fixed(string_view line);
+    static vector<FixedKline> parse_klines_fixed(span<const char> data);
+
+    // interns the symbol if needed
+    static void set_fixed_scale(string_view symbol, const FixedScale& scale);
+    // for symbols first seen after this call
+    static void set_default_fixed_scale(const FixedScale& scale) { symbol_cache.set_default_scale(scale); }
+    static const FixedScale& fixed_scale(uint32_t symbol_id) { return symbol_cache.scale(symbol_id); }
+
+    static uint32_t symbol_to_id(string_view symbol);
+    static const SymbolTable& symbols() { return symbol_cache; }
 
 private:
-    static unordered_map<string, uint32_t> symbol_cache;
-};
\ No newline at end of file
+    static SymbolTable symbol_cache;
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+using namespace std;
+
+/* --- Philox4x32-10 counter-based generator (Salmon et al., "Parallel random numbers: as
+easy as 1, 2, 3"). Output is a pure function of (counter, key): no state to seed, share or
+split, so stream N draws the same numbers on whichever thread runs it, in whatever order. */
+class Philox4x32
+{
+public:
+    using Counter = array<uint32_t, 4>;
+    using Key = array<uint32_t, 2>;
+
+    static Counter generate(Counter counter, Key key)
+    {
+        for (int round = 0; round < 10; ++round) {
+            if (round > 0) {
+                key[0] += kWeyl0;
+                key[1] += kWeyl1;
+            }
+            uint64_t p0 = static_cast<uint64_t>(kMul0) * counter[0];
+            uint64_t p1 = static_cast<uint64_t>(kMul1) * counter[2];
+            counter = Counter{
+                static_cast<uint32_t>(p1 >> 32) ^ counter[1] ^ key[0],
+                static_cast<uint32_t>(p1),
+                static_cast<uint32_t>(p0 >> 32) ^ counter[3] ^ key[1],
+                static_cast<uint32_t>(p0),
+            };
+        }
+        return counter;
+    }
+
+private:
+    static constexpr uint32_t kMul0 = 0xD2511F53;
+    static constexpr uint32_t kMul1 = 0xCD9E8D57;
+    static constexpr uint32_t kWeyl0 = 0x9E3779B9;
+    static constexpr uint32_t kWeyl1 = 0xBB67AE85;
+};
+
+// Stream `stream` of generator `seed`: the key is the seed, the counter is (block, stream),
+// and each block yields four draws.
+class PhiloxStream
+{
+public:
+    PhiloxStream(uint64_t seed, uint64_t stream)
+        : key_{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)},
+          stream_lo_(static_cast<uint32_t>(stream)), stream_hi_(static_cast<uint32_t>(stream >> 32)) {}
+
+    uint32_t next()
+    {
+        if (used_ == 4) {
+            block_ = Philox4x32::generate(Philox4x32::Counter{static_cast<uint32_t>(counter_),
+                                                              static_cast<uint32_t>(counter_ >> 32),
+                                                              stream_lo_, stream_hi_}, key_);
+            ++counter_;
+            used_ = 0;
+        }
+        return block_[used_++];
+    }
+
+    // uniform in [0, n), n > 0: Lemire's multiply-shift with rejection, so no modulo bias
+    uint32_t below(uint32_t n)
+    {
+        uint64_t m = static_cast<uint64_t>(next()) * n;
+        if (static_cast<uint32_t>(m) < n) {
+            uint32_t threshold = static_cast<uint32_t>(-n) % n;
+            while (static_cast<uint32_t>(m) < threshold) {
+                m = static_cast<uint64_t>(next()) * n;
+            }
+        }
+        return static_cast<uint32_t>(m >> 32);
+    }
+
+private:
+    Philox4x32::Key key_;
+    uint32_t stream_lo_;
+    uint32_t stream_hi_;
+    uint64_t counter_ = 0;
+    Philox4x32::Counter block_{};
+    uint32_t used_ = 4;
+};
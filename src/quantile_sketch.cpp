@@ -0,0 +1,142 @@
+#include "quantile_sketch.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+using namespace std;
+
+QuantileSketch::QuantileSketch(double relative_accuracy, size_t max_buckets, pmr::memory_resource* resource)
+    : relative_accuracy_(relative_accuracy),
+      gamma_((1.0 + relative_accuracy) / (1.0 - relative_accuracy)),
+      inv_log_gamma_(1.0 / log(gamma_)),
+      buckets_(max_buckets, 0, resource)
+{
+    if (relative_accuracy <= 0.0 || relative_accuracy >= 1.0 || max_buckets < 2) {
+        throw invalid_argument("QuantileSketch needs 0 < accuracy < 1 and at least 2 buckets");
+    }
+}
+
+int32_t QuantileSketch::index_of(double value) const
+{
+    // bucket i holds (gamma^(i-1), gamma^i]
+    return static_cast<int32_t>(ceil(log(value) * inv_log_gamma_));
+}
+
+double QuantileSketch::value_of(int32_t index) const
+{
+    // midpoint in relative terms, within relative_accuracy of anything in the bucket
+    return 2.0 * pow(gamma_, index) / (gamma_ + 1.0);
+}
+
+void QuantileSketch::add(double value)
+{
+    ++count_;
+    if (!(value > kMinValue)) {
+        ++zero_count_;
+        return;
+    }
+    add_to_index(index_of(value), 1);
+}
+
+void QuantileSketch::add_to_index(int32_t index, uint64_t n)
+{
+    const int32_t size = static_cast<int32_t>(buckets_.size());
+
+    if (empty_) {
+        // first value: centre the window on it
+        offset_ = index - size / 2;
+        max_index_ = index;
+        empty_ = false;
+    }
+
+    if (index >= offset_ + size) {
+        // slide up, collapsing whatever falls off the bottom
+        shift_window(index - size + 1);
+    } else if (index < offset_) {
+        if (max_index_ - index < size) {
+            shift_window(index);
+        } else {
+            // window can't stretch that far: fold into the lowest bucket
+            index = offset_;
+        }
+    }
+
+    buckets_[index - offset_] += n;
+    max_index_ = max(max_index_, index);
+}
+
+void QuantileSketch::shift_window(int32_t new_offset)
+{
+    const int32_t size = static_cast<int32_t>(buckets_.size());
+    int32_t delta = new_offset - offset_;
+
+    if (delta > 0) {
+        uint64_t collapsed = 0;
+        for (int32_t i = 0; i < min(delta, size); ++i) {
+            collapsed += buckets_[i];
+        }
+        if (delta < size) {
+            move(buckets_.begin() + delta, buckets_.end(), buckets_.begin());
+            fill(buckets_.end() - delta, buckets_.end(), 0);
+        } else {
+            fill(buckets_.begin(), buckets_.end(), 0);
+        }
+        buckets_[0] += collapsed;
+    } else if (delta < 0) {
+        // caller guarantees nothing non-empty drops off the top
+        int32_t d = -delta;
+        if (d < size) {
+            move_backward(buckets_.begin(), buckets_.end() - d, buckets_.end());
+            fill(buckets_.begin(), buckets_.begin() + d, 0);
+        } else {
+            fill(buckets_.begin(), buckets_.end(), 0);
+        }
+    }
+    offset_ = new_offset;
+}
+
+void QuantileSketch::merge(const QuantileSketch& other)
+{
+    if (other.gamma_ != gamma_) {
+        throw invalid_argument("Cannot merge QuantileSketches with different accuracy");
+    }
+    zero_count_ += other.zero_count_;
+    count_ += other.count_;
+    if (other.empty_) {
+        return;
+    }
+    for (size_t i = 0; i < other.buckets_.size(); ++i) {
+        if (other.buckets_[i]) {
+            add_to_index(other.offset_ + static_cast<int32_t>(i), other.buckets_[i]);
+        }
+    }
+}
+
+void QuantileSketch::clear()
+{
+    fill(buckets_.begin(), buckets_.end(), 0);
+    offset_ = 0;
+    max_index_ = 0;
+    empty_ = true;
+    zero_count_ = 0;
+    count_ = 0;
+}
+
+double QuantileSketch::quantile(double q) const
+{
+    if (count_ == 0) {
+        return 0.0;
+    }
+    uint64_t rank = min(static_cast<uint64_t>(q * static_cast<double>(count_)), count_ - 1);
+    if (rank < zero_count_) {
+        return 0.0;
+    }
+
+    uint64_t seen = zero_count_;
+    for (size_t i = 0; i < buckets_.size(); ++i) {
+        seen += buckets_[i];
+        if (seen > rank) {
+            return value_of(offset_ + static_cast<int32_t>(i));
+        }
+    }
+    return value_of(max_index_);
+}
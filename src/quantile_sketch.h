@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+using namespace std;
+
+/* --- Fixed-memory quantile sketch (DDSketch).
+Values land in logarithmic buckets of ratio gamma = (1 + a) / (1 - a), so every quantile
+comes back within relative error `a` of the exact answer. The buckets are a fixed-size
+sliding window: if the range ever outgrows it, the lowest buckets are collapsed, which
+keeps the high quantiles (P99 and up) accurate. Memory never grows after construction. */
+class QuantileSketch
+{
+public:
+    // the bucket array is the only allocation, made once from `resource`
+    explicit QuantileSketch(double relative_accuracy = 0.01, size_t max_buckets = 2048,
+                            pmr::memory_resource* resource = pmr::get_default_resource());
+
+    void add(double value);
+    void merge(const QuantileSketch& other);
+    void clear();
+
+    // Same rank convention as the exact Metrics::calculate: element floor(q * n) of the sorted values
+    double quantile(double q) const;
+
+    uint64_t count() const { return count_; }
+    double relative_accuracy() const { return relative_accuracy_; }
+
+private:
+    // smaller values (including zero) are counted separately and reported as 0
+    static constexpr double kMinValue = 1e-9;
+
+    int32_t index_of(double value) const;
+    double value_of(int32_t index) const;
+    void add_to_index(int32_t index, uint64_t n);
+    void shift_window(int32_t new_offset);
+
+    double relative_accuracy_;
+    double gamma_;
+    double inv_log_gamma_;
+    pmr::vector<uint64_t> buckets_;
+    int32_t offset_ = 0;          // bucket index held by buckets_[0]
+    int32_t max_index_ = 0;       // highest non-empty bucket index
+    bool empty_ = true;
+    uint64_t zero_count_ = 0;
+    uint64_t count_ = 0;
+};
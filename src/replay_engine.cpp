@@ -2,15 +2,17 @@
 using namespace std;
 
 
-ReplayEngine::ReplayEngine(const vector<Kline>& klines)
+ReplayEngine::ReplayEngine(span<const Kline> klines)
     : klines_(klines), current_time_ms_(0) {}
 
-void ReplayEngine::replay(KlineCallback on_kline)
-{
-    for(const auto& kline : klines_)
-    {
-        current_time_ms_ = kline.timestamp_ms;
-        on_kline(kline);
-    }
-}
+ReplayEngine::ReplayEngine(const KlineSeries& series)
+    : series_(&series), current_time_ms_(0) {}
 
+ReplayEngine::ReplayEngine(const CompressedSeries& compressed)
+    : compressed_(&compressed), current_time_ms_(0) {}
+
+ReplayEngine::ReplayEngine(span<const Tick> ticks)
+    : ticks_(ticks), current_time_ms_(0) {}
+
+ReplayEngine::ReplayEngine(const HtxReader& htx)
+    : htx_(&htx), htx_symbols_(htx.global_symbol_ids()), current_time_ms_(0) {}
@@ -1,20 +1,192 @@
 #pragma once
 
+#include <algorithm>
+#include <concepts>
+#include <span>
 #include <vector>
-#include <functional>
+#include "bar_aggregator.h"
+#include "compressed_series.h"
+#include "htx_store.h"
+#include "kline_series.h"
 #include "types.h"
 
 using namespace std;
 
+// Replays borrowed klines bar by bar. The engine keeps only a view of the input, so the
+// vector / series passed in must outlive it (temporaries are rejected at compile time).
+// replay() and replay_ticks() read the input in place; replay_bars() does too for a
+// KlineSeries, but builds a column copy of any other input first.
+// Callbacks are template parameters rather than std::function, letting the
+// strategy -> executor chain inline into the loop.
 class ReplayEngine {
 public:
-    using KlineCallback = function<void(const Kline&)>;
-    
-    explicit ReplayEngine(const vector<Kline>& klines);
-    void replay(KlineCallback on_kline);
+    explicit ReplayEngine(span<const Kline> klines);
+    explicit ReplayEngine(const KlineSeries& series);
+    // decoded one block at a time into a block_bars() buffer while it replays
+    explicit ReplayEngine(const CompressedSeries& compressed);
+    // tick stream, e.g. TickReader::ticks() straight out of the mapping
+    explicit ReplayEngine(span<const Tick> ticks);
+    // an .htx file's mapped columns, each bar gathered as it replays (symbol IDs remapped
+    // into Parser's table), so a store of any size replays without a vector<Kline> copy
+    explicit ReplayEngine(const HtxReader& htx);
+
+    // a temporary would be gone before replay(), leaving the engine with a dangling view
+    ReplayEngine(vector<Kline>&&) = delete;
+    ReplayEngine(KlineSeries&&) = delete;
+    ReplayEngine(CompressedSeries&&) = delete;
+    ReplayEngine(vector<Tick>&&) = delete;
+    ReplayEngine(HtxReader&&) = delete;
+
+    template <typename Callback>
+        requires invocable<Callback&, const Kline&>
+    void replay(Callback&& on_kline);
+
+    // column-wise replay: callbacks get a view, nothing is gathered into a Kline.
+    // Zero-copy only for a KlineSeries; other inputs are converted to one for the call.
+    template <typename Callback>
+        requires invocable<Callback&, const KlineView&>
+    void replay_bars(Callback&& on_bar);
+
+    // trade by trade
+    template <typename Callback>
+        requires invocable<Callback&, const Tick&>
+    void replay_ticks(Callback&& on_tick);
+
+    // ticks aggregated into time / volume / dollar bars as they stream past; on_kline sees
+    // each bar once it closes, so kline strategies run unchanged on tick data. Every
+    // symbol_id gets its own bars; the partial last bars come at the end, oldest first.
+    template <typename Callback>
+        requires invocable<Callback&, const Kline&>
+    void replay_ticks(const BarSpec& spec, Callback&& on_kline);
+
     uint64_t current_time_ms() const { return current_time_ms_; }
     
 private:
-    vector<Kline> klines_;
+    span<const Kline> klines_;
+    span<const Tick> ticks_;
+    const KlineSeries* series_ = nullptr;
+    const CompressedSeries* compressed_ = nullptr;
+    const HtxReader* htx_ = nullptr;
+    vector<uint32_t> htx_symbols_;
     uint64_t current_time_ms_ = 0;
-};
\ No newline at end of file
+};
+
+template <typename Callback>
+    requires invocable<Callback&, const Kline&>
+void ReplayEngine::replay(Callback&& on_kline)
+{
+    if(series_)
+    {
+        for(size_t i = 0; i < series_->size(); ++i)
+        {
+            Kline kline = series_->at(i);
+            current_time_ms_ = kline.timestamp_ms;
+            on_kline(kline);
+        }
+        return;
+    }
+
+    if(compressed_)
+    {
+        vector<Kline> block(compressed_->block_bars());
+        for(size_t b = 0; b < compressed_->block_count(); ++b)
+        {
+            size_t bars = compressed_->decode_block(b, block.data());
+            for(size_t i = 0; i < bars; ++i)
+            {
+                current_time_ms_ = block[i].timestamp_ms;
+                on_kline(block[i]);
+            }
+        }
+        return;
+    }
+
+    if(htx_)
+    {
+        auto ts = htx_->timestamp_ms();
+        auto sym = htx_->symbol_id();
+        auto o = htx_->open(), h = htx_->high(), l = htx_->low(), c = htx_->close(), v = htx_->volume();
+        for(size_t i = 0; i < ts.size(); ++i)
+        {
+            uint32_t id = sym[i] < htx_symbols_.size() ? htx_symbols_[sym[i]] : sym[i];
+            Kline kline{ts[i], 0, id, o[i], h[i], l[i], c[i], v[i]};
+            current_time_ms_ = kline.timestamp_ms;
+            on_kline(kline);
+        }
+        return;
+    }
+
+    for(const auto& kline : klines_)
+    {
+        current_time_ms_ = kline.timestamp_ms;
+        on_kline(kline);
+    }
+}
+
+template <typename Callback>
+    requires invocable<Callback&, const KlineView&>
+void ReplayEngine::replay_bars(Callback&& on_bar)
+{
+    // AoS / compressed / .htx input: replay a column copy (O(n) memory for the call) so callers
+    // get one code path
+    const KlineSeries* series = series_;
+    KlineSeries converted;
+    if(!series)
+    {
+        converted = htx_ ? htx_->to_series()
+                  : compressed_ ? KlineSeries(compressed_->to_klines()) : KlineSeries(klines_);
+        series = &converted;
+    }
+
+    auto timestamps = series->timestamp_ms();
+    for(size_t i = 0; i < timestamps.size(); ++i)
+    {
+        current_time_ms_ = timestamps[i];
+        on_bar((*series)[i]);
+    }
+}
+
+template <typename Callback>
+    requires invocable<Callback&, const Tick&>
+void ReplayEngine::replay_ticks(Callback&& on_tick)
+{
+    for(const auto& tick : ticks_)
+    {
+        current_time_ms_ = tick.timestamp_us / 1000;
+        on_tick(tick);
+    }
+}
+
+template <typename Callback>
+    requires invocable<Callback&, const Kline&>
+void ReplayEngine::replay_ticks(const BarSpec& spec, Callback&& on_kline)
+{
+    // one aggregator per symbol, indexed by symbol_id, so interleaved symbols never share a bar
+    vector<BarAggregator> aggregators;
+    auto emit = [&](const Kline& bar)
+    {
+        current_time_ms_ = bar.timestamp_ms;
+        on_kline(bar);
+    };
+    for(const auto& tick : ticks_)
+    {
+        if(tick.symbol_id >= aggregators.size())
+        {
+            aggregators.resize(tick.symbol_id + 1, BarAggregator(spec));
+        }
+        aggregators[tick.symbol_id].on_tick(tick, emit);
+    }
+
+    // partial last bars, oldest first
+    vector<Kline> partial;
+    for(auto& aggregator : aggregators)
+    {
+        aggregator.flush([&](const Kline& bar) { partial.push_back(bar); });
+    }
+    stable_sort(partial.begin(), partial.end(),
+                [](const Kline& a, const Kline& b) { return a.timestamp_ms < b.timestamp_ms; });
+    for(const auto& bar : partial)
+    {
+        emit(bar);
+    }
+}
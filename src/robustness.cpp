@@ -0,0 +1,168 @@
+#include "robustness.h"
+#include "metrics.h"
+#include "philox.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+using namespace std;
+
+namespace {
+
+// resamples per pool task: enough to amortise the submit, small enough to balance
+constexpr size_t kResampleChunk = 256;
+
+}
+
+Distribution Distribution::of(span<const double> values)
+{
+    if (values.empty()) {
+        return Distribution{0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    }
+
+    vector<double> sorted(values.begin(), values.end());
+    sort(sorted.begin(), sorted.end());
+    // members named min/max hide the std:: ones in here
+    auto rank = [&](double q) {
+        size_t index = static_cast<size_t>(q * static_cast<double>(sorted.size()));
+        return sorted[std::min(index, sorted.size() - 1)];
+    };
+
+    // two-pass variance, the inputs are already in memory
+    double n = static_cast<double>(sorted.size());
+    double mean = 0.0;
+    for (double v : sorted) mean += v;
+    mean /= n;
+    double squares = 0.0;
+    for (double v : sorted) squares += (v - mean) * (v - mean);
+
+    return Distribution{mean, sqrt(squares / n), sorted.front(), rank(0.01), rank(0.05), rank(0.50),
+                        rank(0.95), rank(0.99), sorted.back()};
+}
+
+MonteCarlo::MonteCarlo(span<const Trade> trades, uint64_t initial_capital)
+    : initial_capital_(static_cast<double>(initial_capital))
+{
+    if (trades.size() > numeric_limits<uint32_t>::max()) {
+        throw runtime_error("MonteCarlo supports at most 2^32 - 1 trades");
+    }
+    pnl_.reserve(trades.size());
+    for (const auto& trade : trades) {
+        pnl_.push_back(trade.pnl);
+    }
+}
+
+ResampleResult MonteCarlo::run(const ResampleConfig& config) const
+{
+    if (config.method == ResampleMethod::Bootstrap && config.block_length == 0) {
+        throw runtime_error("Bootstrap block length must be positive");
+    }
+
+    ResampleResult result;
+    result.total_pnl.resize(config.resamples);
+    result.max_drawdown.resize(config.resamples);
+
+    size_t n = pnl_.size();
+    size_t block = min(config.block_length, max<size_t>(n, 1));
+    uint32_t block_starts = static_cast<uint32_t>(n - block + 1);
+    size_t tasks = (config.resamples + kResampleChunk - 1) / kResampleChunk;
+
+    run_parallel(config.threads, tasks, [&](size_t task) {
+        size_t begin = task * kResampleChunk;
+        size_t end = min(begin + kResampleChunk, config.resamples);
+        vector<double> path;   // shuffle only: the permuted sequence
+        if (config.method == ResampleMethod::Shuffle) {
+            path.resize(n);
+        }
+
+        for (size_t r = begin; r < end; ++r) {
+            PhiloxStream rng(config.seed, r);
+            PnlStats stats;
+            stats.reset(initial_capital_);
+
+            if (n == 0) {
+                // nothing to draw, every resample is the empty run
+            } else if (config.method == ResampleMethod::Shuffle) {
+                copy(pnl_.begin(), pnl_.end(), path.begin());
+                for (size_t i = n - 1; i > 0; --i) {
+                    swap(path[i], path[rng.below(static_cast<uint32_t>(i + 1))]);
+                }
+                for (double pnl : path) stats.add(pnl);
+            } else if (block == 1) {
+                for (size_t i = 0; i < n; ++i) stats.add(pnl_[rng.below(static_cast<uint32_t>(n))]);
+            } else {
+                // moving blocks: runs of `block` consecutive trades until n are drawn
+                for (size_t drawn = 0; drawn < n;) {
+                    size_t start = rng.below(block_starts);
+                    size_t take = min(block, n - drawn);
+                    for (size_t i = 0; i < take; ++i) stats.add(pnl_[start + i]);
+                    drawn += take;
+                }
+            }
+
+            result.total_pnl[r] = stats.total_pnl;
+            result.max_drawdown[r] = stats.max_drawdown;
+        }
+    });
+
+    result.pnl = Distribution::of(result.total_pnl);
+    result.drawdown = Distribution::of(result.max_drawdown);
+    size_t losses = static_cast<size_t>(count_if(result.total_pnl.begin(), result.total_pnl.end(),
+                                                 [](double pnl) { return pnl < 0.0; }));
+    result.probability_of_loss =
+        config.resamples ? static_cast<double>(losses) / static_cast<double>(config.resamples) : 0.0;
+    return result;
+}
+
+WalkForward::WalkForward(span<const Kline> klines, uint64_t initial_capital)
+    : klines_(klines), initial_capital_(initial_capital) {}
+
+vector<WalkForwardWindow> WalkForward::windows(span<const Kline> klines, const WalkForwardConfig& config)
+{
+    if (config.train_bars == 0 || config.test_bars == 0) {
+        throw runtime_error("Walk-forward train and test windows must be non-empty");
+    }
+    size_t step = config.step_bars ? config.step_bars : config.test_bars;
+
+    vector<WalkForwardWindow> windows;
+    for (size_t start = 0; start + config.train_bars + config.test_bars <= klines.size(); start += step) {
+        size_t train_begin = config.anchored ? 0 : start;
+        size_t test_begin = start + config.train_bars;
+        windows.push_back(WalkForwardWindow{klines.subspan(train_begin, test_begin - train_begin),
+                                            klines.subspan(test_begin, config.test_bars), train_begin, test_begin});
+    }
+    return windows;
+}
+
+vector<WalkForwardResult> WalkForward::run(const WalkForwardConfig& config, const vector<SweepPoint>& grid) const
+{
+    if (grid.empty()) {
+        throw runtime_error("Walk-forward needs at least one grid point");
+    }
+    vector<WalkForwardWindow> wins = windows(klines_, config);
+    size_t points = grid.size();
+
+    // in-sample: every window x grid point in one batch
+    vector<SweepResult> train(wins.size() * points);
+    run_parallel(config.threads, train.size(), [&](size_t t) {
+        train[t] = SweepRunner::run_point(wins[t / points].train, initial_capital_, grid[t % points]);
+    });
+
+    vector<WalkForwardResult> results(wins.size());
+    for (size_t w = 0; w < wins.size(); ++w) {
+        const SweepResult* best = &train[w * points];
+        for (size_t p = 1; p < points; ++p) {
+            const SweepResult& candidate = train[w * points + p];
+            if (candidate.stats.total_pnl > best->stats.total_pnl) best = &candidate;
+        }
+        results[w] = WalkForwardResult{wins[w].train_begin, wins[w].test_begin,
+                                       wins[w].test_begin + wins[w].test.size(), best->params, best->stats, {}};
+    }
+
+    // out-of-sample: the chosen point only
+    run_parallel(config.threads, wins.size(), [&](size_t w) {
+        results[w].out_of_sample = SweepRunner::run_point(wins[w].test, initial_capital_, results[w].chosen).stats;
+    });
+    return results;
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "sweep_runner.h"
+#include "types.h"
+
+using namespace std;
+
+enum class ResampleMethod : uint8_t
+{
+    Bootstrap,   // draw trades with replacement (in blocks of block_length)
+    Shuffle      // permute the trades: same total pnl, different path -> drawdown risk
+};
+
+struct ResampleConfig
+{
+    size_t resamples = 10000;
+    ResampleMethod method = ResampleMethod::Bootstrap;
+    size_t block_length = 1;    // bootstrap: > 1 draws runs of consecutive trades (moving blocks)
+    uint64_t seed = 0x5EED;
+    unsigned threads = 0;       // 0 = every hardware thread
+};
+
+// Summary of one resampled quantity. Quantiles use Metrics' rank convention: element
+// floor(q * n) of the sorted values.
+struct Distribution
+{
+    double mean;
+    double stdev;
+    double min;
+    double p01;
+    double p05;
+    double p50;
+    double p95;
+    double p99;
+    double max;
+
+    static Distribution of(span<const double> values);
+};
+
+struct ResampleResult
+{
+    // per resample, indexed by resample number: identical for any thread count
+    vector<double> total_pnl;
+    vector<double> max_drawdown;
+    Distribution pnl;
+    Distribution drawdown;
+    double probability_of_loss;   // share of resamples ending below the initial capital
+};
+
+/* --- Monte Carlo resampling of a finished run's trades.
+Every resample replays a pnl sequence through PnlStats, the incremental core Metrics uses,
+so resample stats are exactly what a backtest producing that sequence would report.
+Resample i draws from Philox stream i of the seed, which makes the results reproducible and
+independent of how resamples land on the pool's threads. Only the pnl column is kept. */
+class MonteCarlo
+{
+public:
+    MonteCarlo(span<const Trade> trades, uint64_t initial_capital);
+
+    ResampleResult run(const ResampleConfig& config) const;
+
+private:
+    vector<double> pnl_;
+    double initial_capital_;
+};
+
+struct WalkForwardConfig
+{
+    size_t train_bars;
+    size_t test_bars;
+    size_t step_bars = 0;    // 0 = test_bars, back-to-back test windows
+    bool anchored = false;   // train always from bar 0 (expanding) instead of rolling
+    unsigned threads = 0;
+};
+
+struct WalkForwardWindow
+{
+    span<const Kline> train;   // views into the caller's klines, nothing is copied
+    span<const Kline> test;
+    size_t train_begin;
+    size_t test_begin;
+};
+
+struct WalkForwardResult
+{
+    size_t train_begin;
+    size_t test_begin;
+    size_t test_end;
+    SweepPoint chosen;          // best in-sample total pnl, first grid point on ties
+    Statistics in_sample;
+    Statistics out_of_sample;
+};
+
+// Rolling (or anchored) walk-forward: optimise over the grid on each train window, then
+// run only the chosen point on the following test window. All train runs of all windows
+// go to one pool at once, then all test runs.
+class WalkForward
+{
+public:
+    WalkForward(span<const Kline> klines, uint64_t initial_capital);
+
+    static vector<WalkForwardWindow> windows(span<const Kline> klines, const WalkForwardConfig& config);
+
+    vector<WalkForwardResult> run(const WalkForwardConfig& config, const vector<SweepPoint>& grid) const;
+
+private:
+    span<const Kline> klines_;
+    uint64_t initial_capital_;
+};
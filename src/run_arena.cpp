@@ -0,0 +1,101 @@
+#include "run_arena.h"
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+using namespace std;
+
+namespace {
+
+constexpr size_t kBufferAlignment = 64;
+
+char* align_up(char* p, size_t alignment)
+{
+    uintptr_t v = reinterpret_cast<uintptr_t>(p);
+    return reinterpret_cast<char*>((v + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1));
+}
+
+char* new_buffer(size_t bytes)
+{
+    return static_cast<char*>(::operator new(bytes, align_val_t{kBufferAlignment}));
+}
+
+void delete_buffer(char* buffer)
+{
+    ::operator delete(buffer, align_val_t{kBufferAlignment});
+}
+
+}
+
+RunArena::RunArena(size_t initial_bytes)
+    : buffer_(new_buffer(max<size_t>(initial_bytes, kBufferAlignment))),
+      capacity_(max<size_t>(initial_bytes, kBufferAlignment))
+{
+    cur_ = buffer_;
+    end_ = buffer_ + capacity_;
+    next_chunk_size_ = capacity_;
+}
+
+RunArena::~RunArena()
+{
+    free_chunks();
+    delete_buffer(buffer_);
+}
+
+void* RunArena::do_allocate(size_t bytes, size_t alignment)
+{
+    char* p = align_up(cur_, alignment);
+    if (p > end_ || static_cast<size_t>(end_ - p) < bytes) {
+        return allocate_chunk(bytes, alignment);
+    }
+    used_ += static_cast<size_t>(p + bytes - cur_);
+    cur_ = p + bytes;
+    return p;
+}
+
+void* RunArena::allocate_chunk(size_t bytes, size_t alignment)
+{
+    // the old chunk's tail is abandoned, like monotonic_buffer_resource does
+    size_t size = max(next_chunk_size_, sizeof(Chunk) + bytes + alignment);
+    next_chunk_size_ = size * 2;
+
+    Chunk* chunk = static_cast<Chunk*>(static_cast<void*>(new_buffer(size)));
+    chunk->next = chunks_;
+    chunk->size = size;
+    chunks_ = chunk;
+    ++chunk_count_;
+
+    cur_ = reinterpret_cast<char*>(chunk + 1);
+    end_ = reinterpret_cast<char*>(chunk) + size;
+    char* p = align_up(cur_, alignment);
+    used_ += static_cast<size_t>(p + bytes - cur_);
+    cur_ = p + bytes;
+    return p;
+}
+
+void RunArena::free_chunks()
+{
+    while (chunks_) {
+        Chunk* next = chunks_->next;
+        delete_buffer(reinterpret_cast<char*>(chunks_));
+        chunks_ = next;
+    }
+    chunk_count_ = 0;
+}
+
+void RunArena::reset()
+{
+    high_water_ = max(high_water_, used_);
+    if (chunks_) {
+        // the run didn't fit: make the buffer big enough for it (plus slack for padding)
+        free_chunks();
+        size_t grown = max(capacity_ * 2, high_water_ + high_water_ / 8);
+        delete_buffer(buffer_);
+        buffer_ = new_buffer(grown);
+        capacity_ = grown;
+        next_chunk_size_ = capacity_;
+    }
+    cur_ = buffer_;
+    end_ = buffer_ + capacity_;
+    used_ = 0;
+}
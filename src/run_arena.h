@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+using namespace std;
+
+/* --- Per-run monotonic arena.
+A bump allocator behind the pmr::memory_resource interface: pmr containers built on it
+(klines, lines, trades, metrics scratch) allocate by moving a pointer and never free
+individually. reset() throws the whole run away by resetting that pointer. If a run
+outgrows the buffer, the extra comes from the heap in doubling chunks; reset() then frees
+them and grows the buffer to the run's high-water mark, so the next run of the same
+shape makes no heap calls at all. Not thread-safe: one arena per thread/run. */
+class RunArena : public pmr::memory_resource
+{
+public:
+    explicit RunArena(size_t initial_bytes = 1 << 20);
+    ~RunArena() override;
+
+    RunArena(const RunArena&) = delete;
+    RunArena& operator=(const RunArena&) = delete;
+
+    // invalidates everything allocated since the last reset
+    void reset();
+
+    size_t used() const { return used_; }                  // bytes handed out this run
+    size_t capacity() const { return capacity_; }          // main buffer size
+    size_t heap_chunks() const { return chunk_count_; }    // overflow chunks this run
+
+private:
+    // overflow chunks are a singly linked list threaded through their own headers
+    struct alignas(alignof(max_align_t)) Chunk
+    {
+        Chunk* next;
+        size_t size;
+    };
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void*, size_t, size_t) override {}
+    bool do_is_equal(const pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    void* allocate_chunk(size_t bytes, size_t alignment);
+    void free_chunks();
+
+    char* buffer_ = nullptr;
+    size_t capacity_ = 0;
+    char* cur_ = nullptr;
+    char* end_ = nullptr;
+    size_t used_ = 0;
+    size_t high_water_ = 0;
+    Chunk* chunks_ = nullptr;
+    size_t chunk_count_ = 0;
+    size_t next_chunk_size_ = 0;
+};
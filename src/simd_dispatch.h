@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+
+using namespace std;
+
+/* --- Runtime SIMD dispatch for the vectorised kernels (indicators, batch sweep, timeframes).
+Kernels are compiled with __attribute__((target(...))) and chosen per call: the CPU has to
+support the instruction set and the process-wide switch has to be on. Every kernel has a
+scalar fallback doing the same operations in the same order, so the switch changes speed,
+never results. One switch for all of them; benchmarks turn it off to time the fallbacks. */
+
+namespace simd_detail {
+
+inline atomic<bool> g_enabled{true};
+
+inline bool cpu_has_avx2()
+{
+    static const bool supported = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+    }();
+    return supported;
+}
+
+inline bool cpu_has_fma()
+{
+    static const bool supported = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("fma");
+    }();
+    return supported;
+}
+
+}
+
+// false forces every kernel onto its scalar fallback
+inline void set_simd_enabled(bool enabled)
+{
+    simd_detail::g_enabled.store(enabled, memory_order_relaxed);
+}
+
+inline bool simd_enabled()
+{
+    return simd_detail::g_enabled.load(memory_order_relaxed);
+}
+
+// the switch is on and the CPU runs target("avx2") / target("avx2,fma") code
+inline bool use_avx2()
+{
+    return simd_detail::cpu_has_avx2() && simd_enabled();
+}
+
+inline bool use_avx2_fma()
+{
+    return use_avx2() && simd_detail::cpu_has_fma();
+}
+
+// a > b ? a : b and a < b ? a : b, the exact semantics of _mm256_max_pd / _mm256_min_pd
+// (ties and NaNs give b), for the scalar fallbacks
+inline double max_of(double a, double b) { return a > b ? a : b; }
+inline double min_of(double a, double b) { return a < b ? a : b; }
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include <x86intrin.h>
+
+using namespace std;
+
+// How a ring endpoint waits when it can't make progress.
+//   BusyPoll - spin with pause (lowest latency, burns the core; meant for pinned threads)
+//   Blocking - sleep on a futex (atomic wait) until the other side signals
+enum class WaitMode { BusyPoll, Blocking };
+
+/* --- Lock-free single-producer / single-consumer ring.
+head_ and tail_ are free-running counters on separate cache lines; each side keeps a
+cached copy of the other side's counter and only re-reads the shared one when the
+ring looks full/empty, so in steady state a push or pop touches one shared line.
+Blocking mode adds an event counter per direction that the waiting side sleeps on; the
+other side only bumps it (futex wake) when a waiter has announced itself. */
+template <typename T>
+class SpscRing
+{
+public:
+    // capacity is rounded up to a power of two
+    explicit SpscRing(size_t capacity, WaitMode mode = WaitMode::BusyPoll)
+        : mode_(mode)
+    {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        slots_.resize(size);
+        mask_ = size - 1;
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    size_t capacity() const { return slots_.size(); }
+    WaitMode wait_mode() const { return mode_; }
+
+    // producer side
+    bool try_push(const T& item)
+    {
+        uint64_t tail = tail_.load(memory_order_relaxed);
+        if (tail - producer_cached_head_ == slots_.size()) {
+            producer_cached_head_ = head_.load(memory_order_acquire);
+            if (tail - producer_cached_head_ == slots_.size()) return false;
+        }
+        slots_[tail & mask_] = item;
+        tail_.store(tail + 1, memory_order_release);
+        if (mode_ == WaitMode::Blocking) wake(data_waiting_, data_event_);
+        return true;
+    }
+
+    // waits for a free slot
+    void push(const T& item)
+    {
+        uint32_t spins = 0;
+        while (!try_push(item)) {
+            wait(space_waiting_, space_event_, spins, [&] {
+                return tail_.load(memory_order_relaxed) - head_.load(memory_order_acquire) < slots_.size();
+            });
+        }
+    }
+
+    // no more items; pop() drains what is left and then returns false
+    void close()
+    {
+        closed_.store(true, memory_order_release);
+        if (mode_ == WaitMode::Blocking) wake(data_waiting_, data_event_);
+    }
+
+    // consumer side
+    bool try_pop(T& out)
+    {
+        uint64_t head = head_.load(memory_order_relaxed);
+        if (head == consumer_cached_tail_) {
+            consumer_cached_tail_ = tail_.load(memory_order_acquire);
+            if (head == consumer_cached_tail_) return false;
+        }
+        out = slots_[head & mask_];
+        head_.store(head + 1, memory_order_release);
+        if (mode_ == WaitMode::Blocking) wake(space_waiting_, space_event_);
+        return true;
+    }
+
+    // waits for an item; false once the ring is closed and empty
+    bool pop(T& out)
+    {
+        uint32_t spins = 0;
+        while (true) {
+            if (try_pop(out)) return true;
+            if (closed_.load(memory_order_acquire)) {
+                // items pushed just before close() are still visible after it
+                return try_pop(out);
+            }
+            wait(data_waiting_, data_event_, spins, [&] {
+                return tail_.load(memory_order_acquire) != head_.load(memory_order_relaxed) ||
+                       closed_.load(memory_order_acquire);
+            });
+        }
+    }
+
+private:
+    // Announce-then-recheck on one side, publish-then-check on the other, both behind a full
+    // fence: either the waiter sees the new state or the waker sees the waiter and bumps the event.
+    void wake(atomic<bool>& waiting, atomic<uint32_t>& event)
+    {
+        atomic_thread_fence(memory_order_seq_cst);
+        if (waiting.load(memory_order_relaxed)) {
+            event.fetch_add(1, memory_order_release);
+            event.notify_one();
+        }
+    }
+
+    template <typename Ready>
+    void wait(atomic<bool>& waiting, atomic<uint32_t>& event, uint32_t& spins, Ready ready)
+    {
+        if (mode_ == WaitMode::Blocking) {
+            uint32_t seen = event.load(memory_order_acquire);
+            waiting.store(true, memory_order_relaxed);
+            atomic_thread_fence(memory_order_seq_cst);
+            if (!ready()) event.wait(seen, memory_order_acquire);
+            waiting.store(false, memory_order_relaxed);
+            return;
+        }
+        _mm_pause();
+        // a starved busy-poller (more threads than cores) still lets the other side run
+        if ((++spins & 1023) == 0) this_thread::yield();
+    }
+
+    const WaitMode mode_;
+    size_t mask_;
+    vector<T> slots_;
+
+    alignas(64) atomic<uint64_t> head_{0};      // next slot to read, written by the consumer
+    uint64_t consumer_cached_tail_ = 0;
+    alignas(64) atomic<uint64_t> tail_{0};      // next slot to write, written by the producer
+    uint64_t producer_cached_head_ = 0;
+    alignas(64) atomic<uint32_t> data_event_{0};   // consumer sleeps on this
+    atomic<bool> data_waiting_{false};
+    alignas(64) atomic<uint32_t> space_event_{0};  // producer sleeps on this (ring full)
+    atomic<bool> space_waiting_{false};
+    atomic<bool> closed_{false};
+};
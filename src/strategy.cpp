@@ -1,4 +1,5 @@
 #include "strategy.h"
+#include "latency_probe.h"
 using namespace std;
 
 Strategy::Strategy(uint64_t hold_duration_ms)
@@ -9,7 +10,25 @@ Strategy::Strategy(uint64_t hold_duration_ms)
 
 Strategy::Decision Strategy::on_kline(const Kline& kline)
 {
-    Decision decision;
+    return on_bar(kline.timestamp_ms, kline.close);
+}
+
+Strategy::Decision Strategy::on_kline(const KlineView& bar)
+{
+    return on_bar(bar.timestamp_ms(), bar.close());
+}
+
+Strategy::Decision Strategy::on_kline(const FixedKline& kline)
+{
+    // the close is only remembered, never compared, so ticks do as well as dollars here
+    return on_bar(kline.timestamp_ms, static_cast<double>(kline.close));
+}
+
+Strategy::Decision Strategy::on_bar(uint64_t timestamp_ms, double close)
+{
+    HX_PROBE(Probe::Strategy);
+
+    Decision decision{};  // value-init: "no trade" unless a branch below says otherwise
 
     if(!has_position_)
     {
@@ -18,12 +37,12 @@ Strategy::Decision Strategy::on_kline(const Kline& kline)
         decision.is_buy = true;
         decision.quantity = 1;
 
-        entry_time_ms_ = kline.timestamp_ms;
-        entry_price_  = kline.close;
+        entry_time_ms_ = timestamp_ms;
+        entry_price_  = close;
         has_position_ = true;
     }
     else{
-        uint64_t hold_time = kline.timestamp_ms - entry_time_ms_;
+        uint64_t hold_time = timestamp_ms - entry_time_ms_;
 
         if(hold_time >= hold_duration_ms_)
         {
@@ -1,21 +1,23 @@
 #pragma once
 
 #include<types.h>
+#include "kline_series.h"
 using namespace std;
 
 class Strategy{
     public:
-    struct Decision
-    {
-        bool should_trade;
-        bool is_buy;
-        uint64_t quantity;
-    };
+    // kept as a nested name for existing callers, the type lives in types.h
+    using Decision = ::Decision;
 
     explicit Strategy(uint64_t hold_duration_ms);
     Decision on_kline(const Kline& kline);
+    Decision on_kline(const KlineView& bar);
+    Decision on_kline(const FixedKline& kline);
 
     private:
+    // shared by both entry points, only needs the bar time and close
+    Decision on_bar(uint64_t timestamp_ms, double close);
+
     uint64_t hold_duration_ms_;
     uint64_t entry_time_ms_;
     double entry_price_;
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <cstdint>
+#include <tuple>
+#include "indicators.h"
+#include "strategy_concept.h"
+#include "types.h"
+
+using namespace std;
+
+/* --- Composable strategy blocks.
+Header-only on purpose: a ComposedStrategy<Entry, Exit, Sizing> is a plain struct of its
+blocks, every call is on a concrete type, and the whole thing inlines into the replay loop.
+
+    // Strategy's buy-then-sell-after-hold, spelled as blocks
+    ComposedStrategy<AlwaysEnter, ExitAfterHold, FixedSize> s{{}, ExitAfterHold{5000}, FixedSize{1}};
+
+    // momentum entry, leave on time, +2% or -1%, whichever comes first
+    ComposedStrategy<EnterOnUpClose, AnyExit<ExitAfterHold, TakeProfit, StopLoss>, FixedSize> s{
+        {}, {{ExitAfterHold{3600000}, TakeProfit{0.02}, StopLoss{0.01}}}, FixedSize{1}};
+*/
+
+// ---- entry rules
+
+// buy on the first bar the book is flat
+struct AlwaysEnter
+{
+    bool should_enter(const Kline&) { return true; }
+};
+
+// buy when the bar closes above the previous bar's close
+struct EnterOnUpClose
+{
+    double previous_close = 0.0;
+
+    bool should_enter(const Kline& kline)
+    {
+        // `&`, not `&&`: a coin-flip branch here would run on every bar, long or flat
+        bool up = (previous_close > 0.0) & (kline.close > previous_close);
+        previous_close = kline.close;
+        return up;
+    }
+};
+
+// buy when the close is at least `drop` (fraction) below the highest close since the last dip entry
+struct EnterOnDip
+{
+    double drop;
+    double peak = 0.0;
+
+    bool should_enter(const Kline& kline)
+    {
+        peak = kline.close > peak ? kline.close : peak;
+        if (kline.close <= peak * (1.0 - drop)) {
+            peak = kline.close;
+            return true;
+        }
+        return false;
+    }
+};
+
+// buy when the fast SMA crosses above the slow one (incremental indicators, O(1) per bar)
+struct EnterOnSmaCross
+{
+    Sma fast;
+    Sma slow;
+    bool was_above = false;
+
+    bool should_enter(const Kline& kline)
+    {
+        bool above = fast.update(kline.close) > slow.update(kline.close);  // false while either warms up
+        bool cross = above && !was_above;
+        was_above = above;
+        return cross;
+    }
+};
+
+// ---- exit rules
+
+// sell once the position has been held for hold_duration_ms (Strategy's rule)
+struct ExitAfterHold
+{
+    uint64_t hold_duration_ms;
+
+    bool should_exit(const Kline& kline, const Position& position) const
+    {
+        return kline.timestamp_ms - position.entry_time_ms >= hold_duration_ms;
+    }
+};
+
+// sell when the close is `gain` (fraction) above the entry
+struct TakeProfit
+{
+    double gain;
+
+    bool should_exit(const Kline& kline, const Position& position) const
+    {
+        return kline.close >= position.entry_price * (1.0 + gain);
+    }
+};
+
+// sell when the close is `loss` (fraction) below the entry
+struct StopLoss
+{
+    double loss;
+
+    bool should_exit(const Kline& kline, const Position& position) const
+    {
+        return kline.close <= position.entry_price * (1.0 - loss);
+    }
+};
+
+// sell when any of the rules says so; rules are tried in order and the first yes wins,
+// so later rules may not run on a bar (keep should_exit free of side effects)
+template <ExitRule... Rules>
+struct AnyExit
+{
+    tuple<Rules...> rules;
+
+    bool should_exit(const Kline& kline, const Position& position)
+    {
+        return apply([&](auto&... rule) { return (static_cast<bool>(rule.should_exit(kline, position)) || ...); },
+                     rules);
+    }
+};
+
+// ---- position sizing
+
+struct FixedSize
+{
+    uint64_t units;
+
+    uint64_t quantity(const Kline&) const { return units; }
+};
+
+// as many whole units as `notional` buys at the bar close (at least one)
+struct FixedNotional
+{
+    double notional;
+
+    uint64_t quantity(const Kline& kline) const
+    {
+        uint64_t units = kline.close > 0.0 ? static_cast<uint64_t>(notional / kline.close) : 0;
+        return units ? units : 1;
+    }
+};
+
+// ---- composition
+
+// Long-only, one position at a time, same decision protocol as Strategy:
+// flat -> buy when the entry rule fires; long -> sell when the exit rule fires.
+template <EntryRule Entry, ExitRule Exit, SizingRule Sizing>
+struct ComposedStrategy
+{
+    Entry entry;
+    Exit exit;
+    Sizing sizing;
+    Position position{};
+    bool has_position = false;
+
+    Decision on_kline(const Kline& kline)
+    {
+        Decision decision{};
+        bool enter = entry.should_enter(kline);
+        if (!has_position) {
+            if (enter) {
+                uint64_t quantity = sizing.quantity(kline);
+                position = Position{kline.timestamp_ms, kline.close, quantity};
+                has_position = true;
+                decision = Decision{true, true, quantity};
+            }
+        } else if (exit.should_exit(kline, position)) {
+            has_position = false;
+            decision = Decision{true, false, position.quantity};
+        }
+        return decision;
+    }
+};
+
+// Strategy's behaviour as a composition
+using HoldStrategy = ComposedStrategy<AlwaysEnter, ExitAfterHold, FixedSize>;
+
+inline HoldStrategy make_hold_strategy(uint64_t hold_duration_ms)
+{
+    return HoldStrategy{AlwaysEnter{}, ExitAfterHold{hold_duration_ms}, FixedSize{1}};
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include "types.h"
+
+using namespace std;
+
+// Anything the backtest loop can drive bar by bar. Strategy and every
+// ComposedStrategy<...> satisfy it; the loop is templated on the concrete type,
+// so on_kline inlines into it with no virtual call per bar.
+template <typename S>
+concept StrategyConcept = requires(S strategy, const Kline& kline) {
+    { strategy.on_kline(kline) } -> same_as<Decision>;
+};
+
+// Open position handed to exit rules
+struct Position
+{
+    uint64_t entry_time_ms;
+    double entry_price;
+    uint64_t quantity;
+};
+
+// Building blocks for ComposedStrategy (strategy_blocks.h).
+// Entry rules see every bar (so they can keep rolling state) and answer whether a flat
+// book should buy on it; exit rules are asked only while a position is open.
+template <typename E>
+concept EntryRule = requires(E entry, const Kline& kline) {
+    { entry.should_enter(kline) } -> convertible_to<bool>;
+};
+
+template <typename X>
+concept ExitRule = requires(X exit, const Kline& kline, const Position& position) {
+    { exit.should_exit(kline, position) } -> convertible_to<bool>;
+};
+
+template <typename Z>
+concept SizingRule = requires(Z sizing, const Kline& kline) {
+    { sizing.quantity(kline) } -> convertible_to<uint64_t>;
+};
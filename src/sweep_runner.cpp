@@ -0,0 +1,107 @@
+#include "sweep_runner.h"
+#include "backtest.h"
+#include "executor.h"
+#include "metrics.h"
+#include "replay_engine.h"
+#include "run_arena.h"
+#include "strategy.h"
+#include "thread_pool.h"
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+using namespace std;
+
+SweepRunner::SweepRunner(span<const Kline> klines, uint64_t initial_capital, unsigned threads)
+    : klines_(klines), initial_capital_(initial_capital), threads_(threads) {}
+
+vector<SweepResult> SweepRunner::run(const vector<SweepPoint>& grid) const
+{
+    vector<SweepResult> results(grid.size());
+    run_parallel(threads_, grid.size(), [&](size_t i) {
+        results[i] = run_point(klines_, initial_capital_, grid[i]);
+    });
+    return results;
+}
+
+SweepResult SweepRunner::run_point(span<const Kline> klines, uint64_t initial_capital, const SweepPoint& point)
+{
+    auto start = chrono::steady_clock::now();
+
+    // one arena per worker, reset per run. It backs the Metrics latency sketch, the only
+    // per-run allocation here: trades stream into Metrics and no trade log is kept, so a
+    // point makes no heap calls once its thread has run one (bench_run_arena checks this).
+    // Anything per-run added to this function has to come from the arena too.
+    static thread_local RunArena arena(64 * 1024);
+    arena.reset();
+
+    Strategy strategy(point.hold_duration_ms);
+    Executor executor(initial_capital);
+    Metrics metrics(initial_capital, &arena);
+
+    ReplayEngine engine(klines);
+    run_backtest(engine, strategy, executor, [&](const Trade& trade) { metrics.on_trade(trade); });
+
+    return SweepResult{point, metrics.snapshot(), chrono::duration<double>(chrono::steady_clock::now() - start).count()};
+}
+
+vector<SweepPoint> SweepRunner::parse_hold_grid(const string& spec)
+{
+    vector<SweepPoint> grid;
+
+    size_t colon = spec.find(':');
+    if (colon != string::npos) {
+        size_t colon2 = spec.find(':', colon + 1);
+        if (colon2 == string::npos) {
+            throw runtime_error("Grid range must be start:end:step, got: " + spec);
+        }
+        uint64_t start = stoull(spec.substr(0, colon));
+        uint64_t end = stoull(spec.substr(colon + 1, colon2 - colon - 1));
+        uint64_t step = stoull(spec.substr(colon2 + 1));
+        if (step == 0) {
+            throw runtime_error("Grid step must be positive: " + spec);
+        }
+        if (start > end) {
+            throw runtime_error("Grid start is past its end: " + spec);
+        }
+        // stop before v + step can wrap past UINT64_MAX
+        for (uint64_t v = start;; v += step) {
+            grid.push_back(SweepPoint{v});
+            if (end - v < step) {
+                break;
+            }
+        }
+        return grid;
+    }
+
+    stringstream ss(spec);
+    string item;
+    while (getline(ss, item, ',')) {
+        if (!item.empty()) {
+            grid.push_back(SweepPoint{stoull(item)});
+        }
+    }
+    return grid;
+}
+
+void SweepRunner::write_csv(const string& filename, const vector<SweepResult>& results)
+{
+    ofstream out(filename);
+    if (!out.is_open()) {
+        throw runtime_error("Cannot create file: " + filename);
+    }
+
+    out << "hold_duration_ms,total_trades,winning_trades,win_rate,total_pnl,max_drawdown,"
+           "largest_win,largest_loss,run_seconds\n";
+    for (const auto& r : results) {
+        out << r.params.hold_duration_ms << ','
+            << r.stats.total_trades << ','
+            << r.stats.winning_trades << ','
+            << r.stats.win_rate << ','
+            << r.stats.total_pnl << ','
+            << r.stats.max_drawdown << ','
+            << r.stats.largest_win << ','
+            << r.stats.largest_loss << ','
+            << r.run_seconds << '\n';
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <span>
+#include <string>
+#include <vector>
+#include "types.h"
+
+using namespace std;
+
+// One grid point of Strategy parameters
+struct SweepPoint
+{
+    uint64_t hold_duration_ms;
+};
+
+struct SweepResult
+{
+    SweepPoint params;
+    Statistics stats;
+    double run_seconds;
+};
+
+// Runs one independent Strategy/Executor/Metrics backtest per grid point on a
+// work-stealing pool. Every run borrows the same read-only klines; nothing is copied.
+class SweepRunner
+{
+public:
+    SweepRunner(span<const Kline> klines, uint64_t initial_capital, unsigned threads = 0);
+
+    // results come back in grid order
+    vector<SweepResult> run(const vector<SweepPoint>& grid) const;
+
+    // one backtest on the calling thread, what every pool task runs
+    static SweepResult run_point(span<const Kline> klines, uint64_t initial_capital, const SweepPoint& point);
+
+    // "1000,5000,10000" or "start:end:step" (end inclusive)
+    static vector<SweepPoint> parse_hold_grid(const string& spec);
+
+    static void write_csv(const string& filename, const vector<SweepResult>& results);
+
+private:
+    span<const Kline> klines_;
+    uint64_t initial_capital_;
+    unsigned threads_;
+};
@@ -0,0 +1,23 @@
+#include "symbol_table.h"
+using namespace std;
+
+uint32_t SymbolTable::intern(string_view symbol)
+{
+    auto it = ids_.find(symbol);
+    if (it != ids_.end()) {
+        return it->second;
+    }
+
+    // new symbol -> next dense ID
+    uint32_t new_id = static_cast<uint32_t>(names_.size());
+    names_.emplace_back(symbol);
+    scales_.push_back(default_scale_);
+    ids_.emplace(names_.back(), new_id);
+    return new_id;
+}
+
+uint32_t SymbolTable::find(string_view symbol) const
+{
+    auto it = ids_.find(symbol);
+    return it != ids_.end() ? it->second : static_cast<uint32_t>(names_.size());
+}
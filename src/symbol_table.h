@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// Decimal places of a symbol's fixed-point prices and quantities: a price of 42500.01 at
+// price_decimals = 2 is 4250001 ticks. Must cover every decimal the data actually has.
+struct FixedScale
+{
+    uint8_t price_decimals = 2;
+    uint8_t quantity_decimals = 8;
+};
+
+// Interns symbol names to dense IDs in first-seen order.
+// Not thread-safe: parallel parsing gives every worker its own table and remaps at the end.
+class SymbolTable
+{
+public:
+    uint32_t intern(string_view symbol);
+
+    // returns size() when the symbol is unknown
+    uint32_t find(string_view symbol) const;
+
+    // fixed-point scale per symbol; symbols start with the default scale
+    void set_scale(uint32_t id, const FixedScale& scale) { scales_[id] = scale; }
+    void set_default_scale(const FixedScale& scale) { default_scale_ = scale; }
+    const FixedScale& scale(uint32_t id) const { return scales_[id]; }
+
+    const string& name(uint32_t id) const { return names_[id]; }
+    const vector<string>& names() const { return names_; }
+    size_t size() const { return names_.size(); }
+
+private:
+    // transparent hash so string_view lookups don't build a temporary string
+    struct Hash
+    {
+        using is_transparent = void;
+        size_t operator()(string_view s) const { return hash<string_view>{}(s); }
+    };
+
+    unordered_map<string, uint32_t, Hash, equal_to<>> ids_;
+    vector<string> names_;
+    vector<FixedScale> scales_;
+    FixedScale default_scale_;
+};
@@ -0,0 +1,102 @@
+#include "thread_pool.h"
+#include <algorithm>
+using namespace std;
+
+ThreadPool::ThreadPool(unsigned threads)
+    : queues_(threads == 0 ? max(1u, thread::hardware_concurrency()) : threads)
+{
+    workers_.reserve(queues_.size());
+    for (unsigned i = 0; i < queues_.size(); ++i) {
+        workers_.emplace_back([this, i] { worker_loop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        lock_guard<mutex> guard(state_lock_);
+        stopping_ = true;
+    }
+    work_available_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(Task task)
+{
+    {
+        lock_guard<mutex> guard(state_lock_);
+        ++pending_;
+    }
+
+    unsigned index = next_queue_.fetch_add(1, memory_order_relaxed) % queues_.size();
+    {
+        // counted under the queue lock: a worker can only take the task after the lock is
+        // released, so its fetch_sub never runs ahead of this fetch_add and wraps the counter
+        lock_guard<mutex> guard(queues_[index].lock);
+        queues_[index].tasks.push_back(move(task));
+        queued_.fetch_add(1, memory_order_release);
+    }
+
+    // take the state lock so a worker can't miss the wakeup between its check and its wait
+    { lock_guard<mutex> guard(state_lock_); }
+    work_available_.notify_one();
+}
+
+void ThreadPool::wait()
+{
+    unique_lock<mutex> guard(state_lock_);
+    all_done_.wait(guard, [this] { return pending_ == 0; });
+}
+
+bool ThreadPool::try_pop(unsigned index, Task& task)
+{
+    lock_guard<mutex> guard(queues_[index].lock);
+    if (queues_[index].tasks.empty()) {
+        return false;
+    }
+    task = move(queues_[index].tasks.back());
+    queues_[index].tasks.pop_back();
+    return true;
+}
+
+bool ThreadPool::try_steal(unsigned thief, Task& task)
+{
+    const unsigned n = static_cast<unsigned>(queues_.size());
+    for (unsigned offset = 1; offset < n; ++offset) {
+        WorkQueue& victim = queues_[(thief + offset) % n];
+        lock_guard<mutex> guard(victim.lock);
+        if (!victim.tasks.empty()) {
+            task = move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::worker_loop(unsigned index)
+{
+    for (;;) {
+        Task task;
+        if (try_pop(index, task) || try_steal(index, task)) {
+            queued_.fetch_sub(1, memory_order_relaxed);
+            task();
+
+            lock_guard<mutex> guard(state_lock_);
+            if (--pending_ == 0) {
+                all_done_.notify_all();
+            }
+            continue;
+        }
+
+        unique_lock<mutex> guard(state_lock_);
+        work_available_.wait(guard, [this] {
+            return stopping_ || queued_.load(memory_order_acquire) > 0;
+        });
+        if (stopping_ && queued_.load(memory_order_acquire) == 0) {
+            return;
+        }
+    }
+}
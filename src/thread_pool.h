@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Work-stealing thread pool.
+// Each worker owns a deque: it pops its own work from the back (LIFO, cache-warm) and,
+// when empty, steals from the front of the other workers' deques. Tasks submitted from
+// outside the pool are dealt round-robin across the deques.
+class ThreadPool
+{
+public:
+    using Task = function<void()>;
+
+    // threads == 0 uses every hardware thread
+    explicit ThreadPool(unsigned threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(Task task);
+
+    // blocks until every submitted task has finished
+    void wait();
+
+    unsigned size() const { return static_cast<unsigned>(workers_.size()); }
+
+private:
+    struct alignas(64) WorkQueue
+    {
+        mutex lock;
+        deque<Task> tasks;
+    };
+
+    void worker_loop(unsigned index);
+    bool try_pop(unsigned index, Task& task);
+    bool try_steal(unsigned thief, Task& task);
+
+    vector<WorkQueue> queues_;
+    vector<thread> workers_;
+
+    mutex state_lock_;
+    condition_variable work_available_;
+    condition_variable all_done_;
+    atomic<size_t> queued_{0};  // tasks sitting in the deques, updated under their locks
+    size_t pending_ = 0;    // submitted but not finished, guarded by state_lock_
+    atomic<unsigned> next_queue_{0};
+    bool stopping_ = false;
+};
+
+// Runs body(0) .. body(tasks - 1) on a pool of `threads` (0 = all) and waits for all of
+// them. An exception thrown by a task doesn't stop the others; once every task is done,
+// the one from the lowest task index is rethrown.
+template <typename Body>
+void run_parallel(unsigned threads, size_t tasks, Body&& body)
+{
+    vector<exception_ptr> errors(tasks);
+    {
+        ThreadPool pool(threads);
+        for (size_t t = 0; t < tasks; ++t) {
+            pool.submit([&body, &errors, t] {
+                try {
+                    body(t);
+                } catch (...) {
+                    errors[t] = current_exception();
+                }
+            });
+        }
+        pool.wait();
+    }
+    for (auto& error : errors) {
+        if (error) {
+            rethrow_exception(error);
+        }
+    }
+}
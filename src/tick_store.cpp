@@ -0,0 +1,192 @@
+#include "tick_store.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include "parser.h"
+using namespace std;
+
+namespace {
+
+constexpr uint64_t kTickAlignment = 64;
+
+uint64_t align_up(uint64_t offset)
+{
+    return (offset + kTickAlignment - 1) & ~(kTickAlignment - 1);
+}
+
+void pad_to(ofstream& out, uint64_t offset)
+{
+    static const char zeros[kTickAlignment] = {};
+    uint64_t pos = static_cast<uint64_t>(out.tellp());
+    out.write(zeros, static_cast<streamsize>(offset - pos));
+}
+
+}
+
+void TickWriter::write(const string& filename, span<const Tick> ticks, const vector<string>& symbol_names)
+{
+    size_t rows = ticks.size();
+    TickHeader header{};
+    memcpy(header.magic, kTickMagic, sizeof(header.magic));
+    header.version = kTickVersion;
+    header.symbol_count = static_cast<uint32_t>(symbol_names.size());
+    header.row_count = rows;
+    header.block_rows = kTickBlockRows;
+    header.record_size = sizeof(Tick);
+    header.block_count = (rows + kTickBlockRows - 1) / kTickBlockRows;
+
+    vector<TickBlockIndex> index(header.block_count);
+    bool sorted = true;
+    for (size_t b = 0; b < index.size(); ++b) {
+        size_t begin = b * kTickBlockRows;
+        size_t end = min<size_t>(begin + kTickBlockRows, rows);
+        TickBlockIndex entry{ticks[begin].timestamp_us, ticks[begin].timestamp_us};
+        for (size_t i = begin; i < end; ++i) {
+            uint64_t ts = ticks[i].timestamp_us;
+            entry.min_timestamp_us = min(entry.min_timestamp_us, ts);
+            entry.max_timestamp_us = max(entry.max_timestamp_us, ts);
+            if (i > 0 && ts < ticks[i - 1].timestamp_us) {
+                sorted = false;
+            }
+        }
+        index[b] = entry;
+    }
+    header.flags = sorted ? kTickSortedByTime : 0;
+
+    uint64_t offset = sizeof(TickHeader);
+    header.symbols_offset = offset;
+    for (const auto& name : symbol_names) {
+        offset += sizeof(uint32_t) + name.size();
+    }
+    header.index_offset = align_up(offset);
+    header.records_offset = align_up(header.index_offset + index.size() * sizeof(TickBlockIndex));
+    header.file_size = align_up(header.records_offset + rows * sizeof(Tick));
+
+    ofstream out(filename, ios::binary | ios::trunc);
+    if (!out.is_open()) {
+        throw runtime_error("Cannot create file: " + filename);
+    }
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (const auto& name : symbol_names) {
+        uint32_t len = static_cast<uint32_t>(name.size());
+        out.write(reinterpret_cast<const char*>(&len), sizeof(len));
+        out.write(name.data(), static_cast<streamsize>(name.size()));
+    }
+
+    pad_to(out, header.index_offset);
+    out.write(reinterpret_cast<const char*>(index.data()), static_cast<streamsize>(index.size() * sizeof(TickBlockIndex)));
+
+    // field by field into a zeroed batch, so struct padding never leaks into the file
+    pad_to(out, header.records_offset);
+    constexpr size_t kBatch = 8192;
+    vector<Tick> buffer(kBatch);
+    for (size_t start = 0; start < rows; start += kBatch) {
+        size_t n = min(kBatch, rows - start);
+        memset(static_cast<void*>(buffer.data()), 0, n * sizeof(Tick));
+        for (size_t i = 0; i < n; ++i) {
+            const Tick& t = ticks[start + i];
+            buffer[i].timestamp_us = t.timestamp_us;
+            buffer[i].price = t.price;
+            buffer[i].quantity = t.quantity;
+            buffer[i].symbol_id = t.symbol_id;
+            buffer[i].buyer_is_maker = t.buyer_is_maker;
+        }
+        out.write(reinterpret_cast<const char*>(buffer.data()), static_cast<streamsize>(n * sizeof(Tick)));
+    }
+    pad_to(out, header.file_size);
+
+    if (!out.good()) {
+        throw runtime_error("Failed writing file: " + filename);
+    }
+}
+
+TickReader::TickReader(const string& filename)
+    : file_(filename),
+      header_(reinterpret_cast<const TickHeader*>(file_.data()))
+{
+    if (file_.size() < sizeof(TickHeader) || memcmp(header_->magic, kTickMagic, sizeof(kTickMagic)) != 0) {
+        throw runtime_error("Not an .htt file: " + filename);
+    }
+    if (header_->version != kTickVersion || header_->record_size != sizeof(Tick)) {
+        throw runtime_error("Unsupported .htt version " + to_string(header_->version) + " in " + filename);
+    }
+    if (header_->file_size != file_.size()) {
+        throw runtime_error("Truncated .htt file: " + filename);
+    }
+
+    // every span handed out below must stay inside the mapping
+    const TickHeader& h = *header_;
+    bool valid = h.symbols_offset <= h.index_offset &&
+                 (h.row_count == 0 || h.block_rows > 0) &&
+                 h.block_count == (h.row_count == 0 ? 0 : (h.row_count - 1) / h.block_rows + 1) &&
+                 file_.contains(h.index_offset, h.block_count, sizeof(TickBlockIndex)) &&
+                 h.index_offset + h.block_count * sizeof(TickBlockIndex) <= h.records_offset &&
+                 h.records_offset % kTickAlignment == 0 &&
+                 file_.contains(h.records_offset, h.row_count, sizeof(Tick));
+    if (!valid) {
+        throw runtime_error("Corrupt .htt header in " + filename);
+    }
+
+    const char* p = file_.data() + header_->symbols_offset;
+    const char* end = file_.data() + header_->index_offset;
+    symbol_names_.reserve(header_->symbol_count);
+    for (uint32_t i = 0; i < header_->symbol_count; ++i) {
+        uint32_t len = 0;
+        if (p + sizeof(len) > end) {
+            throw runtime_error("Corrupt symbol dictionary in " + filename);
+        }
+        memcpy(&len, p, sizeof(len));
+        p += sizeof(len);
+        if (p + len > end) {
+            throw runtime_error("Corrupt symbol dictionary in " + filename);
+        }
+        symbol_names_.emplace_back(p, len);
+        p += len;
+    }
+}
+
+span<const Tick> TickReader::ticks() const
+{
+    return span<const Tick>(reinterpret_cast<const Tick*>(file_.data() + header_->records_offset), header_->row_count);
+}
+
+span<const TickBlockIndex> TickReader::block_index() const
+{
+    return span<const TickBlockIndex>(
+        reinterpret_cast<const TickBlockIndex*>(file_.data() + header_->index_offset), header_->block_count);
+}
+
+size_t TickReader::lower_bound(uint64_t target_us) const
+{
+    auto blocks = block_index();
+    auto block = std::lower_bound(blocks.begin(), blocks.end(), target_us,
+        [](const TickBlockIndex& b, uint64_t ts) { return b.max_timestamp_us < ts; });
+    if (block == blocks.end()) {
+        return size();
+    }
+
+    auto all = ticks();
+    size_t begin = static_cast<size_t>(block - blocks.begin()) * header_->block_rows;
+    size_t end = min<size_t>(begin + header_->block_rows, size());
+    auto it = std::lower_bound(all.begin() + begin, all.begin() + end, target_us,
+        [](const Tick& t, uint64_t ts) { return t.timestamp_us < ts; });
+    return static_cast<size_t>(it - all.begin());
+}
+
+vector<Tick> TickReader::to_ticks() const
+{
+    vector<uint32_t> remap;
+    remap.reserve(symbol_names_.size());
+    for (const auto& name : symbol_names_) {
+        remap.push_back(Parser::symbol_to_id(name));
+    }
+
+    auto all = ticks();
+    vector<Tick> out(all.begin(), all.end());
+    for (auto& t : out) {
+        if (t.symbol_id < remap.size()) t.symbol_id = remap[t.symbol_id];
+    }
+    return out;
+}
@@ -0,0 +1,165 @@
+#include "timeframes.h"
+#include <immintrin.h>
+#include <limits>
+#include <stdexcept>
+#include "simd_dispatch.h"
+using namespace std;
+
+namespace {
+
+constexpr double kInf = numeric_limits<double>::infinity();
+
+struct Reduced
+{
+    double high;
+    double low;
+    double volume;
+};
+
+// Four lanes, value k into lane k % 4, lanes folded pairwise at the end. The AVX2 kernel
+// runs the same lanes, so both give the same volume sum to the bit.
+struct Lanes
+{
+    double high[4] = {-kInf, -kInf, -kInf, -kInf};
+    double low[4] = {kInf, kInf, kInf, kInf};
+    double volume[4] = {0.0, 0.0, 0.0, 0.0};
+
+    void add(size_t lane, double h, double l, double v)
+    {
+        high[lane] = max_of(h, high[lane]);
+        low[lane] = min_of(l, low[lane]);
+        volume[lane] += v;
+    }
+
+    Reduced fold() const
+    {
+        return Reduced{max_of(max_of(high[0], high[1]), max_of(high[2], high[3])),
+                       min_of(min_of(low[0], low[1]), min_of(low[2], low[3])),
+                       (volume[0] + volume[1]) + (volume[2] + volume[3])};
+    }
+};
+
+Reduced reduce_scalar(const double* high, const double* low, const double* volume, size_t n)
+{
+    Lanes lanes;
+    for (size_t k = 0; k < n; ++k) {
+        lanes.add(k & 3, high[k], low[k], volume[k]);
+    }
+    return lanes.fold();
+}
+
+__attribute__((target("avx2")))
+Reduced reduce_avx2(const double* high, const double* low, const double* volume, size_t n)
+{
+    __m256d h = _mm256_set1_pd(-kInf);
+    __m256d l = _mm256_set1_pd(kInf);
+    __m256d v = _mm256_setzero_pd();
+    size_t k = 0;
+    for (; k + 4 <= n; k += 4) {
+        h = _mm256_max_pd(_mm256_loadu_pd(high + k), h);
+        l = _mm256_min_pd(_mm256_loadu_pd(low + k), l);
+        v = _mm256_add_pd(v, _mm256_loadu_pd(volume + k));
+    }
+
+    Lanes lanes;
+    _mm256_storeu_pd(lanes.high, h);
+    _mm256_storeu_pd(lanes.low, l);
+    _mm256_storeu_pd(lanes.volume, v);
+    for (; k < n; ++k) {
+        lanes.add(k & 3, high[k], low[k], volume[k]);
+    }
+    return lanes.fold();
+}
+
+}
+
+span<const Kline> time_range(span<const Kline> klines, uint64_t from_ms, uint64_t to_ms)
+{
+    auto before = [](const Kline& k, uint64_t ts) { return k.timestamp_ms < ts; };
+    auto first = lower_bound(klines.begin(), klines.end(), from_ms, before);
+    auto last = to_ms > from_ms ? lower_bound(first, klines.end(), to_ms, before) : first;
+    return span<const Kline>(first, last);
+}
+
+MultiTimeframe::MultiTimeframe(span<const Kline> base)
+    : base_(base)
+{
+    for (size_t i = 1; i < base_.size(); ++i) {
+        if (base_[i].timestamp_ms < base_[i - 1].timestamp_ms) {
+            throw runtime_error("MultiTimeframe needs bars sorted by time");
+        }
+        if (base_[i].symbol_id != base_[0].symbol_id) {
+            throw runtime_error("MultiTimeframe takes one symbol, group the input by symbol first");
+        }
+    }
+}
+
+span<const Kline> MultiTimeframe::bars(uint64_t interval_ms) const
+{
+    return timeframe(interval_ms).bars;
+}
+
+const MultiTimeframe::Timeframe& MultiTimeframe::timeframe(uint64_t interval_ms) const
+{
+    auto it = cache_.find(interval_ms);
+    if (it == cache_.end()) {
+        it = cache_.emplace(interval_ms, resample(interval_ms)).first;
+    }
+    return it->second;
+}
+
+size_t MultiTimeframe::bucket_end(size_t begin, uint64_t end_ms) const
+{
+    // gallop, then binary search: a few Kline reads per bucket instead of one per bar
+    size_t lo = begin + 1;
+    size_t step = 1;
+    size_t hi = lo;
+    while (hi < base_.size() && base_[hi].timestamp_ms < end_ms) {
+        lo = hi + 1;
+        step *= 2;
+        hi = begin + step;
+    }
+    hi = min(hi, base_.size());
+    auto before = [](const Kline& k, uint64_t ts) { return k.timestamp_ms < ts; };
+    return static_cast<size_t>(lower_bound(base_.begin() + static_cast<ptrdiff_t>(lo),
+                                           base_.begin() + static_cast<ptrdiff_t>(hi), end_ms, before) -
+                               base_.begin());
+}
+
+MultiTimeframe::Timeframe MultiTimeframe::resample(uint64_t interval_ms) const
+{
+    if (interval_ms == 0) {
+        throw runtime_error("Timeframe interval must be positive");
+    }
+    if (high_.size() != base_.size()) {
+        high_.resize(base_.size());
+        low_.resize(base_.size());
+        volume_.resize(base_.size());
+        for (size_t i = 0; i < base_.size(); ++i) {
+            high_[i] = base_[i].high;
+            low_[i] = base_[i].low;
+            volume_[i] = base_[i].volume;
+        }
+    }
+
+    bool simd = use_avx2();
+    Timeframe tf;
+    size_t buckets = base_.empty() ? 0 : (base_.back().timestamp_ms - base_.front().timestamp_ms) / interval_ms + 1;
+    tf.bars.reserve(min(buckets, base_.size()));
+    tf.last_base.reserve(min(buckets, base_.size()));
+    for (size_t begin = 0; begin < base_.size();) {
+        uint64_t bucket = base_[begin].timestamp_ms / interval_ms * interval_ms;
+        size_t end = bucket_end(begin, bucket + interval_ms);
+
+        size_t n = end - begin;
+        Reduced r = simd ? reduce_avx2(&high_[begin], &low_[begin], &volume_[begin], n)
+                         : reduce_scalar(&high_[begin], &low_[begin], &volume_[begin], n);
+        const Kline& open = base_[begin];
+        const Kline& close = base_[end - 1];
+        tf.bars.push_back(Kline{bucket, close.fetch_time_ms, open.symbol_id, open.open, r.high, r.low, close.close,
+                                r.volume});
+        tf.last_base.push_back(end - 1);
+        begin = end;
+    }
+    return tf;
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <map>
+#include <span>
+#include <vector>
+#include "aligned_allocator.h"
+#include "types.h"
+
+using namespace std;
+
+// Bars with from_ms <= timestamp_ms < to_ms, as a view into `klines` (sorted by time).
+// Two binary searches, nothing copied; the result goes straight into ReplayEngine.
+span<const Kline> time_range(span<const Kline> klines, uint64_t from_ms, uint64_t to_ms);
+
+/* --- One symbol's bars at several timeframes.
+Borrows the base series (e.g. 1m klines, sorted by time, one symbol) and resamples it
+into higher timeframes on first use: clock-aligned buckets of interval_ms stamped with
+their start, open of the first bar, close of the last, max high, min low, summed volume.
+Empty buckets produce no bar and the last bucket may be partial, as in BarAggregator.
+High / low / volume reduce over contiguous columns (AVX2 under simd_dispatch.h, with the
+same lane order in the scalar fallback, so results don't depend on the dispatch).
+
+Resampled series are cached per interval. The cache is filled lazily by const calls and
+isn't locked: build every timeframe a run needs before sharing the object across threads. */
+class MultiTimeframe
+{
+public:
+    // on_bar's interval for the base bars themselves
+    static constexpr uint64_t kBase = 0;
+
+    explicit MultiTimeframe(span<const Kline> base);
+
+    span<const Kline> base() const { return base_; }
+    span<const Kline> range(uint64_t from_ms, uint64_t to_ms) const { return time_range(base_, from_ms, to_ms); }
+
+    // the resampled series, built and cached on first call
+    span<const Kline> bars(uint64_t interval_ms) const;
+    span<const Kline> range(uint64_t interval_ms, uint64_t from_ms, uint64_t to_ms) const
+    {
+        return time_range(bars(interval_ms), from_ms, to_ms);
+    }
+
+    // Replays base bars in [from_ms, to_ms) as on_bar(kBase, bar). A higher timeframe bar
+    // is delivered as on_bar(interval_ms, bar) right after the last base bar of its bucket,
+    // never earlier, so a strategy sees no bar before it has closed. Buckets that started
+    // before from_ms still count the earlier base bars.
+    template <typename Callback>
+        requires invocable<Callback&, uint64_t, const Kline&>
+    void replay(span<const uint64_t> intervals, uint64_t from_ms, uint64_t to_ms, Callback&& on_bar) const;
+
+    template <typename Callback>
+        requires invocable<Callback&, uint64_t, const Kline&>
+    void replay(span<const uint64_t> intervals, Callback&& on_bar) const
+    {
+        replay(intervals, 0, UINT64_MAX, on_bar);
+    }
+
+private:
+    struct Timeframe
+    {
+        vector<Kline> bars;
+        vector<size_t> last_base;   // index of the base bar that closes bars[i]
+    };
+
+    const Timeframe& timeframe(uint64_t interval_ms) const;
+    Timeframe resample(uint64_t interval_ms) const;
+    // first index past `begin` with timestamp_ms >= end_ms
+    size_t bucket_end(size_t begin, uint64_t end_ms) const;
+
+    span<const Kline> base_;
+    // base high / low / volume as columns, built with the first timeframe
+    mutable AlignedVector<double> high_, low_, volume_;
+    mutable map<uint64_t, Timeframe> cache_;
+};
+
+template <typename Callback>
+    requires invocable<Callback&, uint64_t, const Kline&>
+void MultiTimeframe::replay(span<const uint64_t> intervals, uint64_t from_ms, uint64_t to_ms, Callback&& on_bar) const
+{
+    span<const Kline> window = time_range(base_, from_ms, to_ms);
+    size_t first = static_cast<size_t>(window.data() - base_.data());
+    size_t last = first + window.size();
+
+    // per subscribed timeframe: its bars and the next one to deliver
+    vector<const Timeframe*> frames;
+    vector<size_t> next;
+    for (uint64_t interval : intervals) {
+        const Timeframe& tf = timeframe(interval);
+        frames.push_back(&tf);
+        next.push_back(static_cast<size_t>(lower_bound(tf.last_base.begin(), tf.last_base.end(), first) -
+                                           tf.last_base.begin()));
+    }
+
+    for (size_t i = first; i < last; ++i) {
+        on_bar(kBase, base_[i]);
+        for (size_t f = 0; f < frames.size(); ++f) {
+            const Timeframe& tf = *frames[f];
+            if (next[f] < tf.bars.size() && tf.last_base[next[f]] == i) {
+                on_bar(intervals[f], tf.bars[next[f]]);
+                ++next[f];
+            }
+        }
+    }
+}
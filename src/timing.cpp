@@ -0,0 +1,26 @@
+#include "timing.h"
+#include <thread>
+using namespace std;
+
+namespace {
+
+double calibrate()
+{
+    // ~20ms against the OS clock gives the rate to well under 0.1%
+    auto wall_start = chrono::steady_clock::now();
+    uint64_t tsc_start = TscClock::now_serialized();
+    this_thread::sleep_for(chrono::milliseconds(20));
+    uint64_t tsc_end = TscClock::now_serialized();
+    auto wall_end = chrono::steady_clock::now();
+
+    double ns = static_cast<double>(chrono::duration_cast<chrono::nanoseconds>(wall_end - wall_start).count());
+    return static_cast<double>(tsc_end - tsc_start) / ns;
+}
+
+}
+
+double TscClock::ticks_per_ns()
+{
+    static const double rate = calibrate();
+    return rate;
+}
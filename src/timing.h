@@ -0,0 +1,36 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <x86intrin.h>
+
+using namespace std;
+
+// Wall clock used to stamp Kline::fetch_time_ms (microseconds since the Unix epoch,
+// despite the field name). Anything comparing against fetch_time_ms must use this clock.
+inline uint64_t wall_clock_us()
+{
+    return static_cast<uint64_t>(
+        chrono::duration_cast<chrono::microseconds>(chrono::system_clock::now().time_since_epoch()).count());
+}
+
+// Raw time-stamp counter. Costs a few ns instead of a clock_gettime call; convert with
+// TscClock::to_ns. Assumes an invariant TSC (every x86 CPU of the last decade).
+class TscClock
+{
+public:
+    // plain rdtsc: cheapest, may be reordered with neighbouring instructions
+    static uint64_t now() { return __rdtsc(); }
+
+    // rdtscp waits for earlier instructions to retire, use it to close a measured region
+    static uint64_t now_serialized()
+    {
+        unsigned aux;
+        return __rdtscp(&aux);
+    }
+
+    // TSC ticks per nanosecond, calibrated once against steady_clock on first use
+    static double ticks_per_ns();
+
+    static double to_ns(uint64_t ticks) { return static_cast<double>(ticks) / ticks_per_ns(); }
+};
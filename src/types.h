@@ -8,7 +8,7 @@ All 32-bit fields together */
 struct Kline
 {
     uint64_t timestamp_ms;
-    uint64_t fetch_time_ms;
+    uint64_t fetch_time_ms;   // microseconds on wall_clock_us() (timing.h), 0 when not fetched live
     uint32_t symbol_id;
     double open;
     double high;
@@ -17,6 +17,48 @@ struct Kline
     double volume;
 };
 
+// Fixed-point kline: prices in ticks of 10^-price_decimals and volume in units of
+// 10^-quantity_decimals, as set per symbol (FixedScale in symbol_table.h). Comparisons and
+// sums are exact integer ops, and the record is 56 bytes against Kline's 64.
+struct FixedKline
+{
+    uint64_t timestamp_ms;
+    int64_t open;
+    int64_t high;
+    int64_t low;
+    int64_t close;
+    int64_t volume;
+    uint32_t symbol_id;
+};
+
+// One trade print (a Binance aggTrade). Microseconds: tick streams are denser than klines'
+// millisecond clock can order, and newer dumps come in microseconds anyway.
+struct Tick
+{
+    uint64_t timestamp_us;
+    double price;
+    double quantity;
+    uint32_t symbol_id;
+    bool buyer_is_maker;      // true = the seller hit the bid
+};
+
+enum class OrderType : uint8_t
+{
+    Market,   // fills on the decision bar
+    Limit,    // buy at or below / sell at or above `price`
+    Stop      // becomes a market order once `price` trades (buy above / sell below)
+};
+
+// What a strategy wants done on this bar, consumed by Executor
+struct Decision
+{
+    bool should_trade;
+    bool is_buy;
+    uint64_t quantity;
+    OrderType order_type = OrderType::Market;
+    double price = 0.0;   // limit price / stop trigger, unused for market orders
+};
+
 struct Trade
 {
     uint64_t trade_id;
@@ -30,6 +72,20 @@ struct Trade
     double pnl;
 };
 
+// Trade on the fixed-point path: prices in ticks, pnl in ticks x units, exact
+struct FixedTrade
+{
+    uint64_t trade_id;
+    uint64_t entry_time_ms;
+    uint64_t exit_time_ms;
+    uint64_t entry_latency_us;
+    uint64_t exit_latency_us;
+    int64_t entry_price;
+    int64_t exit_price;
+    int64_t quantity;
+    int64_t pnl;
+};
+
 struct Statistics
 {
     uint64_t total_trades;